@@ -0,0 +1,169 @@
+#include "fingerprint_bench.h"
+#include "fingerprint.h"
+#include "rssi_filter.h"
+
+#include "esp_err.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SITE_W_M 120           /* Simulated floor, with APs and locations spread over it */
+#define SITE_H_M 80
+#define SITE_APS 240
+#define SITE_LOCATIONS 40
+#define SWEEP_MAX_APS 48       /* Strongest heard APs per sweep */
+#define HEARD_DBM (-92)        /* Weaker APs are missing from a sweep */
+#define SHADOW_DB 6            /* Fixed per AP and location: walls */
+#define JITTER_DB 4            /* Per sweep */
+#define QUERIES 300            /* Matches timed per database size */
+
+static const int s_db_sizes[] = {100, 250, 500, 1000, 2000, 4000};
+
+#define DB_SIZE_COUNT ((int)(sizeof(s_db_sizes) / sizeof(s_db_sizes[0])))
+
+typedef struct {
+    float x, y;
+} point_t;
+
+static point_t s_aps[SITE_APS];
+static point_t s_locations[SITE_LOCATIONS];
+static int8_t s_shadow[SITE_LOCATIONS][SITE_APS];
+
+static uint32_t s_rand = 777;
+
+static uint32_t bench_rand(void)
+{
+    s_rand = s_rand * 1103515245u + 12345u;
+    return s_rand >> 16;
+}
+
+static int rand_between(int lo, int hi)
+{
+    return lo + (int)(bench_rand() % (uint32_t)(hi - lo + 1));
+}
+
+static void build_site(void)
+{
+    for (int a = 0; a < SITE_APS; a++) {
+        s_aps[a].x = (float)rand_between(0, SITE_W_M);
+        s_aps[a].y = (float)rand_between(0, SITE_H_M);
+    }
+    for (int l = 0; l < SITE_LOCATIONS; l++) {
+        s_locations[l].x = (float)rand_between(0, SITE_W_M);
+        s_locations[l].y = (float)rand_between(0, SITE_H_M);
+        for (int a = 0; a < SITE_APS; a++) {
+            s_shadow[l][a] = (int8_t)rand_between(-SHADOW_DB, SHADOW_DB);
+        }
+    }
+}
+
+static int compare_rssi_desc(const void *a, const void *b)
+{
+    return ((const wifi_ap_info_t *)b)->rssi_q4 - ((const wifi_ap_info_t *)a)->rssi_q4;
+}
+
+/* One sweep at a location, ranked strongest first like the scanner's list */
+static uint16_t make_sweep(int location, wifi_ap_info_t *aps)
+{
+    static wifi_ap_info_t heard[SITE_APS];
+    int count = 0;
+    for (int a = 0; a < SITE_APS; a++) {
+        float dx = s_aps[a].x - s_locations[location].x;
+        float dy = s_aps[a].y - s_locations[location].y;
+        float d = sqrtf(dx * dx + dy * dy) + 1.0f;
+        /* Log-distance path loss, exponent 3 indoors */
+        int dbm = (int)(-35.0f - 30.0f * log10f(d)) + s_shadow[location][a] + rand_between(-JITTER_DB, JITTER_DB);
+        if (dbm < HEARD_DBM) {
+            continue;
+        }
+        wifi_ap_info_t *ap = &heard[count++];
+        memset(ap, 0, sizeof(*ap));
+        ap->bssid[0] = 0x02;
+        ap->bssid[4] = (uint8_t)(a >> 8);
+        ap->bssid[5] = (uint8_t)a;
+        ap->rssi = (int8_t)dbm;
+        ap->rssi_q4 = (int16_t)(dbm * (1 << RSSI_FILTER_Q));
+        ap->prev_rank = 0xFF;
+    }
+    qsort(heard, (size_t)count, sizeof(heard[0]), compare_rssi_desc);
+    if (count > SWEEP_MAX_APS) {
+        count = SWEEP_MAX_APS;
+    }
+    memcpy(aps, heard, (size_t)count * sizeof(aps[0]));
+    return (uint16_t)count;
+}
+
+static int compare_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+int fingerprint_bench_run(bool verbose)
+{
+    static wifi_ap_info_t aps[SWEEP_MAX_APS];
+    static uint32_t latency_us[QUERIES];
+    int failed = 0;
+
+    esp_err_t ret = fingerprint_init();
+    if (ret == ESP_OK) {
+        ret = fingerprint_clear();
+    }
+    if (ret != ESP_OK) {
+        printf("FAIL fingerprint init: %s\n", esp_err_to_name(ret));
+        return 1;
+    }
+    build_site();
+
+    printf("%d locations, %d APs, k=%d\n", SITE_LOCATIONS, SITE_APS, FINGERPRINT_K);
+    int recorded = 0;
+    for (int s = 0; s < DB_SIZE_COUNT; s++) {
+        /* Round-robin, so every location has about the same number of samples */
+        for (; recorded < s_db_sizes[s]; recorded++) {
+            int location = recorded % SITE_LOCATIONS;
+            char label[FINGERPRINT_LABEL_LEN];
+            snprintf(label, sizeof(label), "L%02d", location);
+            uint16_t count = make_sweep(location, aps);
+            if (fingerprint_record(label, aps, count) != ESP_OK) {
+                failed++;
+            }
+        }
+
+        int correct = 0;
+        int matched = 0;
+        uint64_t total_us = 0;
+        for (int q = 0; q < QUERIES; q++) {
+            int location = rand_between(0, SITE_LOCATIONS - 1);
+            uint16_t count = make_sweep(location, aps);
+            fingerprint_match_t match;
+            if (fingerprint_match(aps, count, &match) != ESP_OK) {
+                failed++;
+                continue;
+            }
+            char expect[FINGERPRINT_LABEL_LEN];
+            snprintf(expect, sizeof(expect), "L%02d", location);
+            bool ok = strcmp(match.label, expect) == 0;
+            correct += ok;
+            latency_us[matched++] = match.elapsed_us;
+            total_us += match.elapsed_us;
+            if (verbose) {
+                printf("  %s -> %s %u/%d d=%lu %lu us\n", expect, match.label, match.votes, FINGERPRINT_K,
+                       (unsigned long)match.distance, (unsigned long)match.elapsed_us);
+            }
+        }
+        if (matched == 0) {
+            printf("db %5lu: no matches\n", (unsigned long)fingerprint_count());
+            continue;
+        }
+
+        qsort(latency_us, (size_t)matched, sizeof(latency_us[0]), compare_u32);
+        printf("db %5lu (%3d per location): match avg=%lu p99=%lu max=%lu us, %d/%d located\n",
+               (unsigned long)fingerprint_count(), recorded / SITE_LOCATIONS,
+               (unsigned long)(total_us / (uint64_t)matched), (unsigned long)latency_us[matched * 99 / 100],
+               (unsigned long)latency_us[matched - 1], correct, matched);
+    }
+    return failed;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stdbool.h>
+
+/**
+ * @brief Time fingerprint matching as the database grows
+ *
+ * Records synthetic sweeps of a simulated site (several samples per
+ * location) through fingerprint.c on a RAM-backed partition and, at each
+ * database size, matches fresh sweeps against it. Prints match latency
+ * (avg/p99/max) and how many matches named the right location.
+ *
+ * @param verbose Also print every query
+ * @return Number of failed record or match calls
+ */
+int fingerprint_bench_run(bool verbose);
@@ -0,0 +1,154 @@
+#include "gesture_bench.h"
+#include "cyd_config.h"
+#include "gesture.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SPIKE_EVERY 17    /* One sample in this many jumps by SPIKE_PX */
+#define SPIKE_PX 30
+#define DROPOUT_EVERY 12  /* With dropouts, one moving sample in this many has no contact */
+#define JITTER_PX 2
+
+typedef struct {
+    const char *name;
+    gesture_type_t expect;  /* Deciding event; GESTURE_RELEASE for none of tap/swipe/fling/long press */
+    gesture_dir_t dir;
+    int16_t x0, y0;         /* Press point */
+    int16_t x1, y1;         /* Lift point */
+    uint32_t move_ms;       /* Linear travel from press to lift point */
+    uint32_t hold_ms;       /* Held still at the lift point before lifting */
+    bool dropouts;
+} gesture_script_t;
+
+static const gesture_script_t s_scripts[] = {
+    {"tap", GESTURE_TAP, GESTURE_DIR_NONE, 100, 100, 100, 100, 0, 80, false},
+    {"long_press", GESTURE_LONG_PRESS, GESTURE_DIR_NONE, 200, 120, 200, 120, 0, 700, false},
+    {"swipe_left", GESTURE_SWIPE, GESTURE_DIR_LEFT, 250, 120, 80, 120, 150, 0, false},
+    {"swipe_down", GESTURE_SWIPE, GESTURE_DIR_DOWN, 160, 40, 160, 190, 180, 0, false},
+    {"fling_up", GESTURE_FLING, GESTURE_DIR_UP, 160, 200, 160, 60, 120, 0, false},
+    {"fling_dropouts", GESTURE_FLING, GESTURE_DIR_UP, 160, 200, 160, 40, 200, 0, true},
+    {"slow_drag", GESTURE_RELEASE, GESTURE_DIR_NONE, 160, 60, 160, 180, 1200, 0, false},
+    {"drag_and_stop", GESTURE_RELEASE, GESTURE_DIR_NONE, 160, 200, 160, 80, 200, 150, false},
+};
+
+#define SCRIPT_COUNT ((int)(sizeof(s_scripts) / sizeof(s_scripts[0])))
+
+static uint32_t s_rand = 4242;
+
+static uint32_t bench_rand(void)
+{
+    s_rand = s_rand * 1103515245u + 12345u;
+    return s_rand >> 16;
+}
+
+static bool is_decision(gesture_type_t type)
+{
+    return type == GESTURE_TAP || type == GESTURE_LONG_PRESS ||
+           type == GESTURE_SWIPE || type == GESTURE_FLING;
+}
+
+/* Feed one sample and keep the events of interest */
+static void feed(gesture_t *g, const gesture_sample_t *sample, const gesture_script_t *script,
+                 bool verbose, gesture_event_t *decided, int *decisions, int *presses, int *releases)
+{
+    gesture_event_t events[GESTURE_MAX_EVENTS];
+    int count = gesture_feed(g, sample, events, GESTURE_MAX_EVENTS);
+    for (int i = 0; i < count; i++) {
+        const gesture_event_t *e = &events[i];
+        if (verbose) {
+            printf("    %8.1f ms %-10s %-5s at %d,%d d=%d,%d v=%.0f,%.0f px/s\n",
+                   (double)e->time_us / 1000.0, gesture_type_name(e->type), gesture_dir_name(e->dir),
+                   e->x, e->y, e->dx, e->dy, (double)e->vx, (double)e->vy);
+        }
+        if (e->type == GESTURE_PRESS) {
+            (*presses)++;
+        } else if (e->type == GESTURE_RELEASE) {
+            (*releases)++;
+            if (script->expect == GESTURE_RELEASE && *releases == 1) {
+                *decided = *e;
+            }
+        } else if (is_decision(e->type)) {
+            (*decisions)++;
+            if (e->type == script->expect && decided->type != script->expect) {
+                *decided = *e;
+            }
+        }
+    }
+}
+
+static bool run_script(const gesture_script_t *script, bool verbose)
+{
+    gesture_config_t config = GESTURE_CONFIG_DEFAULT();
+    gesture_t g;
+    gesture_init(&g, &config);
+
+    const int64_t period_us = TOUCH_SAMPLE_PERIOD_MS * 1000LL;
+    const int64_t move_us = script->move_ms * 1000LL;
+    const int64_t lift_us = move_us + script->hold_ms * 1000LL;
+    gesture_event_t decided = {.type = GESTURE_TYPE_COUNT};
+    int decisions = 0, presses = 0, releases = 0;
+    int n = 0;
+
+    if (verbose) {
+        printf("  %s\n", script->name);
+    }
+
+    /* In contact from 0 up to the lift, then the sampler's tail */
+    for (int64_t t = 0; t < lift_us + TOUCH_SAMPLE_TAIL_MS * 1000LL; t += period_us, n++) {
+        gesture_sample_t sample = {.time_us = t, .pressed = t < lift_us};
+        if (sample.pressed) {
+            float f = (move_us > 0 && t < move_us) ? (float)t / (float)move_us : 1.0f;
+            sample.x = (int16_t)(script->x0 + (script->x1 - script->x0) * f);
+            sample.y = (int16_t)(script->y0 + (script->y1 - script->y0) * f);
+            sample.x += (int16_t)(bench_rand() % (2 * JITTER_PX + 1)) - JITTER_PX;
+            sample.y += (int16_t)(bench_rand() % (2 * JITTER_PX + 1)) - JITTER_PX;
+            if (n % SPIKE_EVERY == SPIKE_EVERY - 1) {
+                sample.x += SPIKE_PX;
+            }
+            if (script->dropouts && t < move_us && n % DROPOUT_EVERY == DROPOUT_EVERY - 1) {
+                sample.pressed = false;
+            }
+        }
+        feed(&g, &sample, script, verbose, &decided, &decisions, &presses, &releases);
+    }
+
+    bool ok = presses == 1 && releases == 1;
+    if (script->expect == GESTURE_RELEASE) {
+        ok = ok && decisions == 0;
+    } else {
+        ok = ok && decided.type == script->expect &&
+             (script->dir == GESTURE_DIR_NONE || decided.dir == script->dir);
+    }
+
+    /* Latency from the moment the gesture was physically complete */
+    int64_t reference_us = lift_us;
+    if (script->expect == GESTURE_LONG_PRESS) {
+        reference_us = GESTURE_LONG_PRESS_MS * 1000LL;
+    }
+    double latency_ms = (decided.type != GESTURE_TYPE_COUNT) ?
+                        (double)(decided.time_us - reference_us) / 1000.0 : -1.0;
+    double true_vx = move_us > 0 ? (script->x1 - script->x0) * 1e6 / (double)move_us : 0.0;
+    double true_vy = move_us > 0 ? (script->y1 - script->y0) * 1e6 / (double)move_us : 0.0;
+
+    printf("%-15s %-4s expect=%-10s got=%-10s %-5s latency=%.1f ms presses=%d releases=%d",
+           script->name, ok ? "ok" : "FAIL", gesture_type_name(script->expect),
+           decided.type != GESTURE_TYPE_COUNT ? gesture_type_name(decided.type) : "-",
+           gesture_dir_name(decided.dir), latency_ms, presses, releases);
+    if (decided.type == GESTURE_FLING || decided.type == GESTURE_SWIPE) {
+        printf(" v=%.0f,%.0f px/s (drawn %.0f,%.0f)", (double)decided.vx, (double)decided.vy, true_vx, true_vy);
+    }
+    printf("\n");
+    return ok;
+}
+
+int gesture_bench_run(bool verbose)
+{
+    int failed = 0;
+    for (int i = 0; i < SCRIPT_COUNT; i++) {
+        if (!run_script(&s_scripts[i], verbose)) {
+            failed++;
+        }
+    }
+    return failed;
+}
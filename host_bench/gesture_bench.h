@@ -0,0 +1,15 @@
+#pragma once
+
+#include <stdbool.h>
+
+/**
+ * @brief Replay scripted strokes through the gesture recognizer
+ *
+ * Each stroke is sampled at TOUCH_SAMPLE_PERIOD_MS with resistive-panel
+ * jitter and spikes (and contact dropouts where the script asks for them).
+ * Prints the deciding event, its latency and the fitted velocity per stroke.
+ *
+ * @param verbose Also print every event
+ * @return Number of strokes classified differently than scripted
+ */
+int gesture_bench_run(bool verbose);
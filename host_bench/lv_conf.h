@@ -0,0 +1,40 @@
+/* LVGL configuration for the host UI bench. Mirrors the settings the
+ * firmware gets from menuconfig that affect rendering: RGB565, the built-in
+ * allocator with the same pool size, and the fonts the UI uses. */
+
+#ifndef LV_CONF_H
+#define LV_CONF_H
+
+#define LV_COLOR_DEPTH 16
+
+#define LV_USE_STDLIB_MALLOC LV_STDLIB_BUILTIN
+#define LV_USE_STDLIB_STRING LV_STDLIB_BUILTIN
+#define LV_USE_STDLIB_SPRINTF LV_STDLIB_BUILTIN
+#ifdef BENCH_LV_MEM_SIZE
+#define LV_MEM_SIZE (BENCH_LV_MEM_SIZE)  /* Grown for a longer list, see CMakeLists.txt */
+#else
+#define LV_MEM_SIZE (64 * 1024U)
+#endif
+
+#define LV_USE_OS LV_OS_NONE
+#define LV_DEF_REFR_PERIOD 33
+#define LV_DPI_DEF 130
+
+#define LV_USE_DRAW_SW 1
+#define LV_DRAW_SW_DRAW_UNIT_CNT 1
+
+#define LV_USE_LOG 0
+#define LV_USE_ASSERT_NULL 1
+#define LV_USE_ASSERT_MALLOC 1
+/* A failed assert, e.g. the pool running out, ends the run instead of hanging */
+#define LV_ASSERT_HANDLER_INCLUDE <stdlib.h>
+#define LV_ASSERT_HANDLER abort();
+
+#define LV_FONT_MONTSERRAT_14 1
+#define LV_FONT_MONTSERRAT_16 1
+#define LV_FONT_DEFAULT &lv_font_montserrat_14
+
+#define LV_BUILD_EXAMPLES 0
+#define LV_BUILD_DEMOS 0
+
+#endif /* LV_CONF_H */
@@ -0,0 +1,135 @@
+#include "png_writer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEFLATE_BLOCK_MAX 65535
+
+static uint32_t s_crc_table[256];
+
+static uint32_t crc32_update(uint32_t crc, const uint8_t *buf, size_t len)
+{
+    if (s_crc_table[1] == 0) {
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            s_crc_table[n] = c;
+        }
+    }
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++) {
+        crc = s_crc_table[(crc ^ buf[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+static void put_u32_be(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+static int write_chunk(FILE *f, const char *type, const uint8_t *data, uint32_t len)
+{
+    uint8_t hdr[8];
+    put_u32_be(hdr, len);
+    memcpy(hdr + 4, type, 4);
+
+    uint32_t crc = crc32_update(0, hdr + 4, 4);
+    crc = crc32_update(crc, data, len);
+    uint8_t trailer[4];
+    put_u32_be(trailer, crc);
+
+    if (fwrite(hdr, 1, 8, f) != 8 || (len && fwrite(data, 1, len, f) != len) ||
+        fwrite(trailer, 1, 4, f) != 4) {
+        return -1;
+    }
+    return 0;
+}
+
+int png_write_rgb565(const char *path, const uint16_t *px, int width, int height)
+{
+    /* Raw scanlines: filter byte 0, then RGB */
+    size_t row_len = 1 + (size_t)width * 3;
+    size_t raw_len = row_len * (size_t)height;
+    uint8_t *raw = malloc(raw_len);
+    if (!raw) {
+        return -1;
+    }
+    for (int y = 0; y < height; y++) {
+        uint8_t *row = raw + (size_t)y * row_len;
+        row[0] = 0;
+        for (int x = 0; x < width; x++) {
+            uint16_t c = px[(size_t)y * width + x];
+            uint8_t r = (uint8_t)((c >> 11) & 0x1F);
+            uint8_t g = (uint8_t)((c >> 5) & 0x3F);
+            uint8_t b = (uint8_t)(c & 0x1F);
+            row[1 + x * 3] = (uint8_t)((r << 3) | (r >> 2));
+            row[2 + x * 3] = (uint8_t)((g << 2) | (g >> 4));
+            row[3 + x * 3] = (uint8_t)((b << 3) | (b >> 2));
+        }
+    }
+
+    /* zlib stream of stored blocks */
+    size_t blocks = (raw_len + DEFLATE_BLOCK_MAX - 1) / DEFLATE_BLOCK_MAX;
+    size_t z_len = 2 + blocks * 5 + raw_len + 4;
+    uint8_t *z = malloc(z_len);
+    if (!z) {
+        free(raw);
+        return -1;
+    }
+    uint8_t *p = z;
+    *p++ = 0x78;
+    *p++ = 0x01;
+    uint32_t a = 1, b = 0;
+    for (size_t off = 0; off < raw_len; off += DEFLATE_BLOCK_MAX) {
+        size_t n = raw_len - off;
+        if (n > DEFLATE_BLOCK_MAX) {
+            n = DEFLATE_BLOCK_MAX;
+        }
+        *p++ = (off + n == raw_len) ? 1 : 0;
+        *p++ = (uint8_t)n;
+        *p++ = (uint8_t)(n >> 8);
+        *p++ = (uint8_t)~n;
+        *p++ = (uint8_t)(~n >> 8);
+        memcpy(p, raw + off, n);
+        p += n;
+    }
+    for (size_t i = 0; i < raw_len; i++) {
+        a = (a + raw[i]) % 65521;
+        b = (b + a) % 65521;
+    }
+    put_u32_be(p, (b << 16) | a);
+    free(raw);
+
+    uint8_t ihdr[13];
+    put_u32_be(ihdr, (uint32_t)width);
+    put_u32_be(ihdr + 4, (uint32_t)height);
+    ihdr[8] = 8;   /* Bit depth */
+    ihdr[9] = 2;   /* Truecolor */
+    ihdr[10] = 0;
+    ihdr[11] = 0;
+    ihdr[12] = 0;
+
+    static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    FILE *f = fopen(path, "wb");
+    int ret = -1;
+    if (f) {
+        if (fwrite(signature, 1, 8, f) == 8 &&
+            write_chunk(f, "IHDR", ihdr, sizeof(ihdr)) == 0 &&
+            write_chunk(f, "IDAT", z, (uint32_t)z_len) == 0 &&
+            write_chunk(f, "IEND", NULL, 0) == 0) {
+            ret = 0;
+        }
+        if (fclose(f) != 0) {
+            ret = -1;
+        }
+    }
+    free(z);
+    return ret;
+}
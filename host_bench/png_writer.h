@@ -0,0 +1,17 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief Write an RGB565 image as an 8-bit RGB PNG
+ *
+ * Uses stored (uncompressed) deflate blocks, so no zlib is needed; the
+ * files are only meant for diffing.
+ *
+ * @param path Output file
+ * @param px Pixels, row-major, native-endian RGB565
+ * @param width Image width
+ * @param height Image height
+ * @return 0 on success, -1 on error
+ */
+int png_write_rgb565(const char *path, const uint16_t *px, int width, int height);
@@ -0,0 +1,229 @@
+#include "rogue_bench.h"
+#include "rogue_detect.h"
+#include "rssi_filter.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CSV_FIELDS 9
+#define CSV_LINE_MAX 512
+
+typedef struct {
+    uint32_t expected[ROGUE_ALERT_COUNT];
+    uint32_t raised[ROGUE_ALERT_COUNT];
+    uint32_t missed[ROGUE_ALERT_COUNT];
+    uint32_t unexpected[ROGUE_ALERT_COUNT];
+} rogue_tally_t;
+
+static uint8_t s_raised;  /* Alerts raised by the record being replayed */
+
+static void alert_cb(const rogue_alert_t *alert, void *arg)
+{
+    (void)arg;
+    s_raised |= ROGUE_ALERT_BIT(alert->type);
+}
+
+/* Split a CSV line in place; quoted fields may hold commas and "" */
+static int split_csv(char *line, char **fields, int max)
+{
+    int count = 0;
+    char *in = line;
+    while (count < max) {
+        char *out = in;
+        fields[count++] = out;
+        if (*in == '"') {
+            in++;
+            while (*in && !(*in == '"' && in[1] != '"')) {
+                if (*in == '"') {
+                    in++;
+                }
+                *out++ = *in++;
+            }
+            if (*in == '"') {
+                in++;
+            }
+        } else {
+            while (*in && *in != ',' && *in != '\n' && *in != '\r') {
+                *out++ = *in++;
+            }
+        }
+        bool more = *in == ',';
+        *out = '\0';
+        if (!more) {
+            break;
+        }
+        in++;
+    }
+    return count;
+}
+
+/* Whether any row has a non-empty expectation column */
+static bool has_expectations(FILE *f)
+{
+    char line[CSV_LINE_MAX];
+    char *fields[CSV_FIELDS];
+    bool found = false;
+    while (!found && fgets(line, sizeof(line), f)) {
+        found = line[0] != '#' && split_csv(line, fields, CSV_FIELDS) == CSV_FIELDS && fields[8][0] != '\0';
+    }
+    rewind(f);
+    return found;
+}
+
+static bool parse_alerts(const char *text, uint8_t *out)
+{
+    *out = 0;
+    while (*text) {
+        size_t len = strcspn(text, "|");
+        int type = 0;
+        while (type < ROGUE_ALERT_COUNT &&
+               !(strlen(rogue_alert_name((rogue_alert_type_t)type)) == len &&
+                 strncmp(rogue_alert_name((rogue_alert_type_t)type), text, len) == 0)) {
+            type++;
+        }
+        if (type == ROGUE_ALERT_COUNT) {
+            return false;
+        }
+        *out |= ROGUE_ALERT_BIT(type);
+        text += len;
+        if (*text == '|') {
+            text++;
+        }
+    }
+    return true;
+}
+
+static void format_alerts(uint8_t bits, char *buf, size_t size)
+{
+    buf[0] = '\0';
+    for (int type = 0; type < ROGUE_ALERT_COUNT; type++) {
+        if (bits & ROGUE_ALERT_BIT(type)) {
+            size_t used = strlen(buf);
+            snprintf(buf + used, size - used, "%s%s", used ? "|" : "", rogue_alert_name((rogue_alert_type_t)type));
+        }
+    }
+    if (buf[0] == '\0') {
+        snprintf(buf, size, "-");
+    }
+}
+
+int rogue_bench_run(const char *path, bool verbose)
+{
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return 1;
+    }
+
+    rogue_detect_reset();
+    rogue_detect_end_sweep();
+    rogue_detect_set_callback(alert_cb, NULL);
+
+    rogue_tally_t tally = {0};
+    bool checked = has_expectations(f);
+    char line[CSV_LINE_MAX];
+    char sweep_key[CSV_LINE_MAX] = "";
+    int line_no = 0;
+    int failed = 0;
+
+    while (fgets(line, sizeof(line), f)) {
+        line_no++;
+        if (line[0] == '#' || line[0] == '\n' || strncmp(line, "file,", 5) == 0) {
+            continue;
+        }
+
+        char *fields[CSV_FIELDS];
+        int count = split_csv(line, fields, CSV_FIELDS);
+        wifi_ap_info_t ap = {0};
+        unsigned int b[6];
+        if (count < 8 || sscanf(fields[3], "%x:%x:%x:%x:%x:%x", &b[0], &b[1], &b[2], &b[3], &b[4], &b[5]) != 6) {
+            fprintf(stderr, "%s:%d: not a scan_log_reader.py row\n", path, line_no);
+            failed++;
+            continue;
+        }
+        uint8_t expect = 0;
+        if (count == CSV_FIELDS && fields[8][0] != '\0') {
+            if (!parse_alerts(fields[8], &expect)) {
+                fprintf(stderr, "%s:%d: unknown alert in '%s'\n", path, line_no, fields[8]);
+                failed++;
+                continue;
+            }
+        }
+
+        /* A sweep is every row with the same file and seq */
+        char key[CSV_LINE_MAX];
+        snprintf(key, sizeof(key), "%s,%s", fields[0], fields[1]);
+        if (strcmp(key, sweep_key) != 0) {
+            if (sweep_key[0] != '\0') {
+                rogue_detect_end_sweep();
+            }
+            snprintf(sweep_key, sizeof(sweep_key), "%s", key);
+        }
+
+        for (int i = 0; i < 6; i++) {
+            ap.bssid[i] = (uint8_t)b[i];
+        }
+        ap.rssi = (int8_t)atoi(fields[4]);
+        ap.rssi_q4 = (int16_t)(ap.rssi * (1 << RSSI_FILTER_Q));
+        ap.channel = (uint8_t)atoi(fields[5]);
+        ap.authmode = (wifi_auth_mode_t)atoi(fields[6]);
+        ap.prev_rank = 0xFF;
+        snprintf(ap.ssid, sizeof(ap.ssid), "%s", fields[7]);
+
+        s_raised = 0;
+        rogue_detect_record(&ap);
+
+        uint8_t missed = expect & ~s_raised;
+        uint8_t unexpected = checked ? (s_raised & ~expect) : 0;
+        for (int type = 0; type < ROGUE_ALERT_COUNT; type++) {
+            uint8_t bit = ROGUE_ALERT_BIT(type);
+            tally.expected[type] += (expect & bit) != 0;
+            tally.raised[type] += (s_raised & bit) != 0;
+            tally.missed[type] += (missed & bit) != 0;
+            tally.unexpected[type] += (unexpected & bit) != 0;
+        }
+
+        if (s_raised || expect || verbose) {
+            char raised_text[64];
+            char expect_text[64];
+            format_alerts(s_raised, raised_text, sizeof(raised_text));
+            format_alerts(expect, expect_text, sizeof(expect_text));
+            bool ok = !missed && !unexpected;
+            printf("%-4s seq %-4s %s ch%-2u %4d dBm %-16s raised=%s", ok ? "ok" : "FAIL", fields[1], fields[3],
+                   ap.channel, ap.rssi, ap.ssid, raised_text);
+            if (checked) {
+                printf(" expected=%s", expect_text);
+            }
+            printf("\n");
+        }
+    }
+    fclose(f);
+    if (sweep_key[0] != '\0') {
+        rogue_detect_end_sweep();
+    }
+    rogue_detect_set_callback(NULL, NULL);
+
+    rogue_stats_t stats;
+    rogue_detect_get_stats(&stats);
+    printf("%lu sweeps, %lu records, %lu ssids (%lu trusted), %lu unindexed\n",
+           (unsigned long)stats.sweeps, (unsigned long)stats.records, (unsigned long)stats.ssids,
+           (unsigned long)stats.trusted, (unsigned long)stats.unindexed);
+    for (int type = 0; type < ROGUE_ALERT_COUNT; type++) {
+        const char *verdict = "";
+        if (checked) {
+            if (tally.expected[type] == 0) {
+                verdict = " FAIL (not covered)";
+                failed++;
+            } else if (tally.missed[type] || tally.unexpected[type]) {
+                verdict = " FAIL";
+            }
+        }
+        failed += (int)(tally.missed[type] + tally.unexpected[type]);
+        printf("%-14s expected=%lu raised=%lu missed=%lu unexpected=%lu%s\n",
+               rogue_alert_name((rogue_alert_type_t)type), (unsigned long)tally.expected[type],
+               (unsigned long)tally.raised[type], (unsigned long)tally.missed[type],
+               (unsigned long)tally.unexpected[type], verdict);
+    }
+    return failed;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <stdbool.h>
+
+/**
+ * @brief Replay logged sweeps through the rogue AP detector
+ *
+ * Reads tools/scan_log_reader.py CSV output (file,seq,...,ssid; one row per
+ * sighting, a new file or seq starts a sweep) and feeds every row to
+ * rogue_detect_record(), calling rogue_detect_end_sweep() between sweeps.
+ * An optional ninth column lists the alerts that row must raise, joined
+ * with '|' (names from rogue_alert_name()); rows without it must raise
+ * none once any row has one. Prints every alert and, per alert type, how
+ * many were expected, raised, missed and raised unexpectedly.
+ *
+ * @param path CSV file
+ * @param verbose Also print rows that raised nothing
+ * @return Number of missed or unexpected alerts, plus types the file
+ *         expects nowhere; 1 if the file cannot be read
+ */
+int rogue_bench_run(const char *path, bool verbose);
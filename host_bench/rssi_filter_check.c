@@ -0,0 +1,123 @@
+/*
+ * Host check of the RSSI filter (main/rssi_filter.c).
+ *
+ * Feeds one BSSID a steady signal, steps it up or down by 1 to 20 dB and
+ * holds the new level, one reading per sweep. After each step the trend
+ * must show the direction of a step of 3 dB or more, and once the signal
+ * has been flat for a while the trend must be back to FLAT and the
+ * displayed RSSI within 1/16 dB of the new level. Constant signals must
+ * never show a trend.
+ *
+ *   rssi_filter_check [-v]
+ *
+ * Exits 1 on any failure.
+ */
+
+#include "rssi_filter.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CHECK_SETTLE_SWEEPS 40   /* Readings before the step */
+#define CHECK_HOLD_SWEEPS 200    /* Readings after it */
+#define CHECK_MAX_STEP_DB 20
+#define CHECK_BASE_DBM -70
+#define CHECK_MIN_TREND_DB 3     /* Smaller steps stay under RSSI_TREND_ENTER_Q4 */
+
+static const uint8_t s_bssid[6] = {0x02, 0x11, 0x22, 0x33, 0x44, 0x55};
+static bool s_verbose;
+
+static const char *trend_name(rssi_trend_t trend)
+{
+    switch (trend) {
+        case RSSI_TREND_RISING: return "rising";
+        case RSSI_TREND_FALLING: return "falling";
+        default: return "flat";
+    }
+}
+
+/* Hold from_dbm, step to to_dbm and hold that; returns true if it passes */
+static bool check_step(int from_dbm, int to_dbm)
+{
+    rssi_filter_state_t state;
+    rssi_filter_reset();
+    for (int i = 0; i < CHECK_SETTLE_SWEEPS; i++) {
+        rssi_filter_update(s_bssid, (int8_t)from_dbm, &state);
+        rssi_filter_end_sweep();
+    }
+    bool ok = state.trend == RSSI_TREND_FLAT;
+
+    rssi_trend_t expect = to_dbm > from_dbm ? RSSI_TREND_RISING : RSSI_TREND_FALLING;
+    bool shown = false;
+    int flat_at = -1;  /* Sweep after which the trend stayed FLAT */
+    for (int i = 0; i < CHECK_HOLD_SWEEPS; i++) {
+        rssi_filter_update(s_bssid, (int8_t)to_dbm, &state);
+        rssi_filter_end_sweep();
+        if (state.trend == expect) {
+            shown = true;
+        } else if (state.trend != RSSI_TREND_FLAT) {
+            ok = false;  /* Wrong direction */
+        }
+        if (state.trend != RSSI_TREND_FLAT) {
+            flat_at = -1;
+        } else if (flat_at < 0) {
+            flat_at = i;
+        }
+    }
+
+    int error_q4 = state.rssi_q4 - to_dbm * (1 << RSSI_FILTER_Q);
+    int step_db = abs(to_dbm - from_dbm);
+    ok = ok && (shown || step_db < CHECK_MIN_TREND_DB) && state.trend == RSSI_TREND_FLAT &&
+         abs(error_q4) <= 1 && rssi_filter_to_dbm(state.rssi_q4) == to_dbm;
+
+    if (!ok || s_verbose) {
+        printf("%-4s %4d -> %4d dBm: %s shown %s, flat after %d sweeps, final %s at %d/16 dBm (%+d)\n",
+               ok ? "ok" : "FAIL", from_dbm, to_dbm, trend_name(expect), shown ? "yes" : "no", flat_at,
+               trend_name(state.trend), state.rssi_q4, error_q4);
+    }
+    return ok;
+}
+
+/* A constant signal never shows a trend and reads back exactly */
+static bool check_constant(int dbm)
+{
+    rssi_filter_state_t state;
+    bool ok = true;
+    rssi_filter_reset();
+    for (int i = 0; i < CHECK_HOLD_SWEEPS && ok; i++) {
+        rssi_filter_update(s_bssid, (int8_t)dbm, &state);
+        rssi_filter_end_sweep();
+        ok = state.trend == RSSI_TREND_FLAT && state.rssi_q4 == dbm * (1 << RSSI_FILTER_Q);
+    }
+    if (!ok || s_verbose) {
+        printf("%-4s constant %d dBm: %s at %d/16 dBm\n", ok ? "ok" : "FAIL", dbm, trend_name(state.trend),
+               state.rssi_q4);
+    }
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-v") == 0) {
+            s_verbose = true;
+        }
+    }
+
+    int failed = 0;
+    int checks = 0;
+
+    for (int step = 1; step <= CHECK_MAX_STEP_DB; step++) {
+        failed += !check_step(CHECK_BASE_DBM, CHECK_BASE_DBM + step);
+        failed += !check_step(CHECK_BASE_DBM, CHECK_BASE_DBM - step);
+        checks += 2;
+    }
+    for (int dbm = -100; dbm <= -20; dbm++) {
+        failed += !check_constant(dbm);
+        checks++;
+    }
+
+    printf("%d/%d checks passed\n", checks - failed, checks);
+    return failed > 0;
+}
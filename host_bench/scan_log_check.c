@@ -0,0 +1,489 @@
+/*
+ * Host check of the scan log (main/scan_log_format.c, main/scan_log_file.c).
+ *
+ * Format: writes a log file through the same file code as the writer task
+ * (full blocks, with partial blocks flushed out as on a timed flush), reads
+ * it back and compares every sweep, then truncates the file at every record
+ * boundary and inside records and headers, and flips a byte, checking that
+ * a reader recovers exactly the records before the damage.
+ *
+ * Files: with small limits in a second directory, appends a sweep per
+ * simulated second and checks that a partial block is written once it is
+ * SCAN_LOG_FLUSH_MS old even though sweeps keep coming, that files rotate
+ * at the size limit with the oldest deleted, that the kept files are
+ * renumbered down to SCAN0001.BIN once the numbers run out, and that a
+ * reopened log continues after the highest number. Every kept sweep must
+ * read back, in order, across the kept files.
+ *
+ *   scan_log_check [-v] [dir]
+ *
+ * dir (default a new scan_log_check.XXXXXX under /tmp) gets format/ and
+ * files/ subdirectories; format/SCAN0001.BIN is left in place for
+ * tools/scan_log_reader.py. Exits 1 on any mismatch.
+ */
+
+#include "scan_log_file.h"
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define CHECK_SWEEPS 120
+#define CHECK_FLUSH_EVERY 7  /* Sweeps between partial blocks flushed out */
+#define CHECK_HEADER_MS 1234
+
+/* Small limits so rotation and renumbering happen within a few hundred sweeps */
+#define CHECK_FILE_BLOCKS 3
+#define CHECK_MAX_FILES 3
+#define CHECK_INDEX_MAX 12
+#define CHECK_FLUSH_US (10 * 1000000LL)
+#define CHECK_FILE_SWEEPS 600
+#define CHECK_FILES_MAX (CHECK_INDEX_MAX + 1)
+
+typedef struct {
+    wifi_ap_info_t aps[SCAN_LOG_MAX_APS];
+    uint16_t ap_count;
+    uint32_t seq;
+    uint32_t time_ms;
+    size_t start;  /* File offset of the record */
+    size_t end;    /* Just past it */
+} check_sweep_t;
+
+static check_sweep_t s_sweeps[CHECK_SWEEPS];
+static uint8_t s_file[CHECK_SWEEPS * SCAN_LOG_BLOCK_SIZE];
+static size_t s_header_end;
+static bool s_verbose;
+
+static uint32_t s_rand = 31337;
+
+static uint32_t check_rand(void)
+{
+    s_rand = s_rand * 1103515245u + 12345u;
+    return s_rand >> 16;
+}
+
+static void make_sweep(check_sweep_t *sweep, uint32_t seq)
+{
+    memset(sweep, 0, sizeof(*sweep));
+    sweep->seq = seq;
+    sweep->time_ms = seq * 2000 + check_rand() % 100;
+    sweep->ap_count = (uint16_t)(check_rand() % (SCAN_LOG_MAX_APS + 1));
+    for (int i = 0; i < sweep->ap_count; i++) {
+        wifi_ap_info_t *ap = &sweep->aps[i];
+        for (int b = 0; b < 6; b++) {
+            ap->bssid[b] = (uint8_t)check_rand();
+        }
+        ap->rssi = (int8_t)(-30 - (int)(check_rand() % 65));
+        ap->channel = (uint8_t)(1 + check_rand() % 13);
+        ap->authmode = (wifi_auth_mode_t)(check_rand() % 8);
+        /* Empty (hidden) to the full 32 bytes, which has no terminator room in the record */
+        int ssid_len = (int)(check_rand() % 33);
+        for (int c = 0; c < ssid_len; c++) {
+            ap->ssid[c] = (char)('a' + check_rand() % 26);
+        }
+    }
+}
+
+/* Delete the log files a previous run left in dir */
+static void clean_dir(const char *dir)
+{
+    DIR *d = opendir(dir);
+    if (!d) {
+        return;
+    }
+    struct dirent *entry;
+    char path[SCAN_LOG_PATH_MAX + sizeof(entry->d_name)];
+    while ((entry = readdir(d)) != NULL) {
+        unsigned long index;
+        if (sscanf(entry->d_name, "SCAN%4lu.BIN", &index) == 1) {
+            snprintf(path, sizeof(path), "%s/%s", dir, entry->d_name);
+            unlink(path);
+        }
+    }
+    closedir(d);
+}
+
+/* Write the sweeps to dir/SCAN0001.BIN and note where each record lands */
+static bool write_log(const char *dir, char *path, size_t path_size)
+{
+    const scan_log_file_config_t config = {
+        .max_file_size = UINT32_MAX,
+        .max_files = CHECK_MAX_FILES,
+        .index_max = SCAN_LOG_INDEX_MAX,
+        .flush_us = INT64_MAX / 2,  /* Partial blocks only where flushed below */
+    };
+    static scan_log_file_t log;
+    static uint8_t rec[SCAN_LOG_RECORD_MAX];
+
+    clean_dir(dir);
+    if (scan_log_file_open(&log, dir, &config, CHECK_HEADER_MS * 1000LL) != ESP_OK) {
+        return false;
+    }
+    scan_log_file_path(&log, path, path_size, log.index);
+    s_header_end = log.file_size + log.block.used;
+
+    s_rand = 31337;
+    for (int i = 0; i < CHECK_SWEEPS; i++) {
+        check_sweep_t *sweep = &s_sweeps[i];
+        /* Gaps in seq are sweeps the writer skipped */
+        make_sweep(sweep, (uint32_t)(i + 1 + i / 10));
+        size_t len = scan_log_encode_sweep(rec, sweep->aps, sweep->ap_count, sweep->seq, sweep->time_ms);
+        int64_t now_us = (int64_t)sweep->time_ms * 1000;
+        scan_log_file_append(&log, rec, len, now_us);
+        sweep->end = log.file_size + log.block.used;
+        sweep->start = sweep->end - len;
+        if (i % CHECK_FLUSH_EVERY == CHECK_FLUSH_EVERY - 1) {
+            scan_log_file_flush(&log, now_us);
+        }
+    }
+    scan_log_file_close(&log, 0);
+    return log.index == 1;
+}
+
+static long read_log(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    size_t len = fread(s_file, 1, sizeof(s_file), f);
+    fclose(f);
+    return (long)len;
+}
+
+static bool same_ap(const wifi_ap_info_t *a, const wifi_ap_info_t *b)
+{
+    return memcmp(a->bssid, b->bssid, 6) == 0 && a->rssi == b->rssi && a->channel == b->channel &&
+           a->authmode == b->authmode && strncmp(a->ssid, b->ssid, 32) == 0;
+}
+
+/* Read the file as it is on disk and compare it with what was written.
+ * expect_sweeps is how many leading sweeps must come back intact; nothing
+ * after them may. */
+static bool check(const char *path, const char *what, int expect_header, int expect_sweeps)
+{
+    long len = read_log(path);
+    if (len < 0) {
+        return false;
+    }
+
+    scan_log_reader_t reader;
+    scan_log_record_t rec;
+    int headers = 0;
+    int sweeps = 0;
+    bool ok = true;
+
+    scan_log_reader_init(&reader, s_file, (size_t)len);
+    while (ok && scan_log_reader_next(&reader, &rec)) {
+        if (rec.type == SCAN_LOG_TYPE_FILE_HEADER) {
+            ok = headers++ == 0 && sweeps == 0 && rec.time_ms == CHECK_HEADER_MS;
+            continue;
+        }
+        if (rec.type != SCAN_LOG_TYPE_SWEEP || sweeps >= CHECK_SWEEPS) {
+            ok = false;
+            break;
+        }
+        const check_sweep_t *sweep = &s_sweeps[sweeps++];
+        ok = rec.seq == sweep->seq && rec.time_ms == sweep->time_ms && rec.count == sweep->ap_count;
+        size_t offset = 0;
+        for (int i = 0; ok && i < rec.count; i++) {
+            wifi_ap_info_t ap;
+            ok = scan_log_decode_ap(&rec, &offset, &ap) && same_ap(&ap, &sweep->aps[i]);
+        }
+        ok = ok && offset == rec.payload_len;
+    }
+    ok = ok && headers == expect_header && sweeps == expect_sweeps;
+
+    if (!ok || s_verbose) {
+        printf("%-4s %-28s %7ld bytes: %d/%d sweeps back%s\n", ok ? "ok" : "FAIL", what, len, sweeps,
+               expect_sweeps, reader.stopped ? ", stopped at torn record" : "");
+    }
+    return ok;
+}
+
+static bool check_truncated(const char *path, size_t size, const char *what)
+{
+    if (truncate(path, (off_t)size) != 0) {
+        perror(path);
+        return false;
+    }
+    int expect = 0;
+    while (expect < CHECK_SWEEPS && s_sweeps[expect].end <= size) {
+        expect++;
+    }
+    char label[64];
+    snprintf(label, sizeof(label), "%s at %zu", what, size);
+    return check(path, label, size >= s_header_end, expect);
+}
+
+static bool check_format(const char *dir, long *file_size, char *path, size_t path_size)
+{
+    int failed = 0;
+
+    if (!write_log(dir, path, path_size)) {
+        printf("FAIL writing %s\n", dir);
+        return false;
+    }
+    long full = read_log(path);
+    *file_size = full;
+    failed += !check(path, "whole file", 1, CHECK_SWEEPS);
+
+    /* Every record boundary, and a torn write inside each record's header and body */
+    for (int i = CHECK_SWEEPS - 1; i >= 0; i--) {
+        failed += !check_truncated(path, s_sweeps[i].end, "record end");
+        failed += !check_truncated(path, s_sweeps[i].end - 1, "inside record");
+        failed += !check_truncated(path, s_sweeps[i].start + SCAN_LOG_HDR_SIZE / 2, "inside header");
+    }
+    failed += !check_truncated(path, 0, "empty");
+
+    /* A flipped byte mid-file hides everything from that record on */
+    if (!write_log(dir, path, path_size) || read_log(path) != full) {
+        printf("FAIL rewriting %s\n", path);
+        return false;
+    }
+    int victim = CHECK_SWEEPS / 2;
+    s_file[s_sweeps[victim].end - SCAN_LOG_CRC_SIZE - 1] ^= 0x40;
+    FILE *f = fopen(path, "wb");
+    if (!f || fwrite(s_file, 1, (size_t)full, f) != (size_t)full) {
+        perror(path);
+        return false;
+    }
+    fclose(f);
+    failed += !check(path, "flipped byte", 1, victim);
+
+    /* Leave an intact file behind for the Python reader */
+    write_log(dir, path, path_size);
+    return failed == 0;
+}
+
+/* Which SCANnnnn.BIN exist in dir; returns how many */
+static int list_files(const char *dir, bool present[CHECK_FILES_MAX])
+{
+    int count = 0;
+    memset(present, 0, CHECK_FILES_MAX * sizeof(bool));
+    DIR *d = opendir(dir);
+    if (!d) {
+        return 0;
+    }
+    struct dirent *entry;
+    while ((entry = readdir(d)) != NULL) {
+        unsigned long index;
+        if (sscanf(entry->d_name, "SCAN%4lu.BIN", &index) == 1) {
+            if (index < CHECK_FILES_MAX) {
+                present[index] = true;
+            }
+            count++;
+        }
+    }
+    closedir(d);
+    return count;
+}
+
+static long disk_size(const scan_log_file_t *log, uint32_t index)
+{
+    char path[SCAN_LOG_FILE_PATH_MAX];
+    struct stat st;
+    scan_log_file_path(log, path, sizeof(path), index);
+    return stat(path, &st) == 0 ? (long)st.st_size : -1;
+}
+
+static bool expect(bool ok, const char *what, long got, long want)
+{
+    if (!ok || s_verbose) {
+        printf("%-4s %-44s got %ld, want %ld\n", ok ? "ok" : "FAIL", what, got, want);
+    }
+    return ok;
+}
+
+/* Exactly files first..log->index exist, and those below full_below were
+ * rotated at the size limit */
+static bool check_window(const scan_log_file_t *log, uint32_t first, uint32_t full_below, const char *what)
+{
+    bool present[CHECK_FILES_MAX];
+    int count = list_files(log->dir, present);
+    bool ok = count == (int)(log->index - first + 1);
+    for (uint32_t i = first; ok && i <= log->index; i++) {
+        ok = present[i];
+        long size = disk_size(log, i);
+        if (i < full_below) {
+            /* The block holding the record that crossed the limit follows it out */
+            ok = ok && size >= (long)log->config.max_file_size &&
+                 size <= (long)log->config.max_file_size + SCAN_LOG_BLOCK_SIZE;
+        }
+    }
+    char label[96];
+    snprintf(label, sizeof(label), "%s: SCAN%04lu-%04lu", what, (unsigned long)first, (unsigned long)log->index);
+    return expect(ok, label, count, (long)(log->index - first + 1));
+}
+
+/* Every kept sweep reads back in order, with no gap up to the last one written */
+static bool check_kept_sweeps(const scan_log_file_t *log, uint32_t first, uint32_t last_seq)
+{
+    char path[SCAN_LOG_FILE_PATH_MAX];
+    uint32_t seq = 0;
+    int sweeps = 0;
+    bool ok = true;
+
+    for (uint32_t i = first; ok && i <= log->index; i++) {
+        scan_log_file_path(log, path, sizeof(path), i);
+        long len = read_log(path);
+        scan_log_reader_t reader;
+        scan_log_record_t rec;
+        int headers = 0;
+        scan_log_reader_init(&reader, s_file, len > 0 ? (size_t)len : 0);
+        while (ok && scan_log_reader_next(&reader, &rec)) {
+            if (rec.type == SCAN_LOG_TYPE_FILE_HEADER) {
+                headers++;
+                continue;
+            }
+            ok = (seq == 0 || rec.seq == seq + 1);
+            seq = rec.seq;
+            sweeps++;
+        }
+        ok = ok && len > 0 && headers == 1 && !reader.stopped;
+    }
+    ok = ok && seq == last_seq;
+    return expect(ok, "kept sweeps read back in order, last seq", (long)seq, (long)last_seq);
+}
+
+static bool check_files(const char *dir)
+{
+    const scan_log_file_config_t config = {
+        .max_file_size = CHECK_FILE_BLOCKS * SCAN_LOG_BLOCK_SIZE,
+        .max_files = CHECK_MAX_FILES,
+        .index_max = CHECK_INDEX_MAX,
+        .flush_us = CHECK_FLUSH_US,
+    };
+    static scan_log_file_t log;
+    static uint8_t rec[SCAN_LOG_RECORD_MAX];
+    static check_sweep_t sweep;
+    int failed = 0;
+
+    clean_dir(dir);
+    int64_t now_us = 0;
+    if (scan_log_file_open(&log, dir, &config, now_us) != ESP_OK) {
+        printf("FAIL opening %s\n", dir);
+        return false;
+    }
+
+    /* Flush by age: a small sweep every second, so blocks never fill. The
+     * partial block must reach the disk every CHECK_FLUSH_US regardless. */
+    uint32_t seq = 0;
+    bool age_ok = true;
+    for (int s = 1; s <= 25; s++) {
+        now_us = s * 1000000LL;
+        make_sweep(&sweep, ++seq);
+        sweep.ap_count = 1;
+        scan_log_file_append(&log, rec, scan_log_encode_sweep(rec, sweep.aps, 1, seq, (uint32_t)(now_us / 1000)),
+                             now_us);
+        /* Written out at 10 s and 20 s, nothing waiting right after */
+        long want = (s / 10) * SCAN_LOG_BLOCK_SIZE;
+        int64_t want_due = (s % 10 == 0) ? -1 : CHECK_FLUSH_US - (s % 10) * 1000000LL;
+        long size = disk_size(&log, log.index);
+        age_ok = size == want && scan_log_file_flush_due_us(&log, now_us) == want_due;
+        if (!age_ok) {
+            char label[64];
+            snprintf(label, sizeof(label), "on disk after %d s", s);
+            expect(false, label, size, want);
+            break;
+        }
+    }
+    failed += !expect(age_ok, "partial blocks written every 10 s of sweeps", disk_size(&log, log.index),
+                      2 * SCAN_LOG_BLOCK_SIZE);
+
+    /* Rotation and renumbering: full sweeps until the numbers run out and
+     * the kept files move down to SCAN0001.BIN */
+    bool renumbered = false;
+    uint32_t last_index = log.index;
+    for (int s = 0; s < CHECK_FILE_SWEEPS && failed == 0; s++) {
+        now_us += 1000;
+        make_sweep(&sweep, ++seq);
+        size_t len = scan_log_encode_sweep(rec, sweep.aps, sweep.ap_count, seq, (uint32_t)(now_us / 1000));
+        scan_log_file_append(&log, rec, len, now_us);
+        if (log.index == last_index) {
+            continue;
+        }
+        if (log.index < last_index) {
+            /* Kept CHECK_MAX_FILES - 1 files plus the new one, the oldest of the window deleted */
+            renumbered = true;
+            failed += !expect(last_index == CHECK_INDEX_MAX && log.index == CHECK_MAX_FILES + 1,
+                              "renumbered after SCAN0012 to SCAN0004", (long)log.index, CHECK_MAX_FILES + 1);
+        }
+        last_index = log.index;
+        uint32_t first = log.index > CHECK_MAX_FILES ? log.index - CHECK_MAX_FILES + 1 : 1;
+        failed += !check_window(&log, first, log.index, renumbered ? "after renumbering" : "after rotation");
+        if (renumbered && log.index > CHECK_MAX_FILES + 2) {
+            break;
+        }
+    }
+    failed += !expect(renumbered, "renumbering happened", renumbered, 1);
+
+    /* Reopening continues after the highest number, dropping the oldest */
+    scan_log_file_close(&log, now_us);
+    uint32_t first = log.index - CHECK_MAX_FILES + 1;
+    failed += !check_kept_sweeps(&log, first, seq);
+    uint32_t before = log.index;
+    if (scan_log_file_open(&log, dir, &config, now_us) != ESP_OK) {
+        printf("FAIL reopening %s\n", dir);
+        return false;
+    }
+    failed += !expect(log.index == before + 1, "reopened after the highest number", (long)log.index,
+                      (long)before + 1);
+    /* The file open at close is short */
+    failed += !check_window(&log, log.index - CHECK_MAX_FILES + 1, before, "after reopening");
+    scan_log_file_close(&log, now_us);
+
+    return failed == 0;
+}
+
+static bool make_dir(const char *path)
+{
+    if (mkdir(path, 0755) != 0 && access(path, W_OK) != 0) {
+        perror(path);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    char root[SCAN_LOG_PATH_MAX - 8] = "/tmp/scan_log_check.XXXXXX";
+    bool have_root = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-v") == 0) {
+            s_verbose = true;
+        } else if (strlen(argv[i]) < sizeof(root)) {
+            strcpy(root, argv[i]);
+            have_root = true;
+        } else {
+            fprintf(stderr, "%s: directory name too long\n", argv[i]);
+            return 2;
+        }
+    }
+    if (have_root ? !make_dir(root) : !mkdtemp(root)) {
+        perror(root);
+        return 1;
+    }
+
+    char format_dir[SCAN_LOG_PATH_MAX];
+    char files_dir[SCAN_LOG_PATH_MAX];
+    snprintf(format_dir, sizeof(format_dir), "%s/format", root);
+    snprintf(files_dir, sizeof(files_dir), "%s/files", root);
+    if (!make_dir(format_dir) || !make_dir(files_dir)) {
+        return 1;
+    }
+
+    char path[SCAN_LOG_FILE_PATH_MAX];
+    long size = 0;
+    bool format_ok = check_format(format_dir, &size, path, sizeof(path));
+    bool files_ok = check_files(files_dir);
+
+    printf("format %s: %d sweeps, %ld bytes in %s\n", format_ok ? "ok" : "FAILED", CHECK_SWEEPS, size, path);
+    printf("files %s: flush by age, rotation, renumbering and reopening in %s\n", files_ok ? "ok" : "FAILED",
+           files_dir);
+    return !(format_ok && files_ok);
+}
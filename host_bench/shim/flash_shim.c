@@ -0,0 +1,184 @@
+/*
+ * RAM-backed stand-ins for the ESP-IDF partition and NVS APIs, enough for
+ * fingerprint.c on the host. The partition list mirrors the data partitions
+ * in partitions.csv that host-built sources open.
+ */
+
+#include "esp_partition.h"
+#include "nvs.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define FLASH_SECTOR_SIZE 4096
+#define NVS_MAX_BLOBS 8
+#define NVS_KEY_LEN 16
+
+typedef struct {
+    esp_partition_t partition;
+    uint8_t *data;
+} host_partition_t;
+
+static host_partition_t s_partitions[] = {
+    {{ESP_PARTITION_TYPE_DATA, 0x40, 0x310000, 0x40000, "fprint"}, NULL},
+};
+
+#define PARTITION_COUNT ((int)(sizeof(s_partitions) / sizeof(s_partitions[0])))
+
+typedef struct {
+    char key[NVS_KEY_LEN];
+    uint8_t *value;
+    size_t length;
+} nvs_blob_t;
+
+static nvs_blob_t s_blobs[NVS_MAX_BLOBS];
+
+static host_partition_t *find_host_partition(const esp_partition_t *partition)
+{
+    for (int i = 0; i < PARTITION_COUNT; i++) {
+        if (&s_partitions[i].partition == partition) {
+            return &s_partitions[i];
+        }
+    }
+    return NULL;
+}
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                                const char *label)
+{
+    for (int i = 0; i < PARTITION_COUNT; i++) {
+        host_partition_t *p = &s_partitions[i];
+        if (p->partition.type != type || p->partition.subtype != subtype ||
+            (label && strcmp(p->partition.label, label) != 0)) {
+            continue;
+        }
+        if (!p->data) {
+            /* Fresh flash reads as erased */
+            p->data = malloc(p->partition.size);
+            if (!p->data) {
+                return NULL;
+            }
+            memset(p->data, 0xFF, p->partition.size);
+        }
+        return &p->partition;
+    }
+    return NULL;
+}
+
+esp_err_t esp_partition_mmap(const esp_partition_t *partition, size_t offset, size_t size,
+                             esp_partition_mmap_memory_t memory, const void **out_ptr,
+                             esp_partition_mmap_handle_t *out_handle)
+{
+    host_partition_t *p = find_host_partition(partition);
+    if (!p || !out_ptr || offset + size > partition->size) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *out_ptr = p->data + offset;
+    if (out_handle) {
+        *out_handle = 1;
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t *partition, size_t dst_offset, const void *src, size_t size)
+{
+    host_partition_t *p = find_host_partition(partition);
+    if (!p || !src || dst_offset + size > partition->size) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    /* NOR flash: programming only clears bits */
+    const uint8_t *bytes = src;
+    for (size_t i = 0; i < size; i++) {
+        p->data[dst_offset + i] &= bytes[i];
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t *partition, size_t offset, size_t size)
+{
+    host_partition_t *p = find_host_partition(partition);
+    if (!p || offset + size > partition->size) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (offset % FLASH_SECTOR_SIZE != 0 || size % FLASH_SECTOR_SIZE != 0) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memset(p->data + offset, 0xFF, size);
+    return ESP_OK;
+}
+
+static nvs_blob_t *find_blob(const char *key)
+{
+    for (int i = 0; i < NVS_MAX_BLOBS; i++) {
+        if (s_blobs[i].value && strncmp(s_blobs[i].key, key, NVS_KEY_LEN) == 0) {
+            return &s_blobs[i];
+        }
+    }
+    return NULL;
+}
+
+esp_err_t nvs_open(const char *name, nvs_open_mode_t open_mode, nvs_handle_t *out_handle)
+{
+    (void)name; (void)open_mode;
+    *out_handle = 1;
+    return ESP_OK;
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *key, const void *value, size_t length)
+{
+    nvs_blob_t *blob = find_blob(key);
+    for (int i = 0; !blob && i < NVS_MAX_BLOBS; i++) {
+        if (!s_blobs[i].value) {
+            blob = &s_blobs[i];
+            strncpy(blob->key, key, NVS_KEY_LEN - 1);
+        }
+    }
+    if (!blob) {
+        return ESP_ERR_NO_MEM;
+    }
+    uint8_t *copy = malloc(length ? length : 1);
+    if (!copy) {
+        return ESP_ERR_NO_MEM;
+    }
+    memcpy(copy, value, length);
+    free(blob->value);
+    blob->value = copy;
+    blob->length = length;
+    return ESP_OK;
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *key, void *out_value, size_t *length)
+{
+    nvs_blob_t *blob = find_blob(key);
+    if (!blob) {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    if (out_value) {
+        if (*length < blob->length) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        memcpy(out_value, blob->value, blob->length);
+    }
+    *length = blob->length;
+    return ESP_OK;
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char *key)
+{
+    nvs_blob_t *blob = find_blob(key);
+    if (!blob) {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    free(blob->value);
+    memset(blob, 0, sizeof(*blob));
+    return ESP_OK;
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle)
+{
+    return ESP_OK;
+}
+
+void nvs_close(nvs_handle_t handle)
+{
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+/* Host stand-in for the ESP-IDF header of the same name: the bench is
+ * single-threaded, so only the types the host-built sources name */
+
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+
+#define portMAX_DELAY ((TickType_t)0xffffffffu)
+#define pdTRUE 1
+#define pdFALSE 0
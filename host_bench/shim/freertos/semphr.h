@@ -0,0 +1,26 @@
+#pragma once
+
+/* Host stand-in for the ESP-IDF header of the same name: one thread, so
+ * mutexes never block */
+
+#include "freertos/FreeRTOS.h"
+
+typedef void *SemaphoreHandle_t;
+
+static inline SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    static int mutex;
+    return &mutex;
+}
+
+static inline int xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks)
+{
+    (void)sem; (void)ticks;
+    return pdTRUE;
+}
+
+static inline int xSemaphoreGive(SemaphoreHandle_t sem)
+{
+    (void)sem;
+    return pdTRUE;
+}
@@ -0,0 +1,526 @@
+/*
+ * Headless host bench for the LVGL UI.
+ *
+ * Runs ui.c and the scanner list view (wifi_list_ui.c) against a
+ * memory-backed display with the firmware's resolution and partial draw
+ * buffers, drives them with scripted touch input, sweeps published through
+ * scan_results.c and a virtual tick, and reports per-frame render time, flushed area and LVGL heap use.
+ *
+ *   cyd_ui_bench [-v] [--png DIR] [--budget-us N] [scenario...]
+ *   cyd_ui_bench [-v] --gestures
+ *   cyd_ui_bench [-v] --fingerprints
+ *   cyd_ui_bench [-v] --rogue [sightings.csv]
+ *
+ * Scenarios: open, aps20, aps100, aps500, scroll, overlay (default: all, in
+ * order). overlay repeats aps20 with the list laid out as it was before each
+ * view got its own screen: a 90% opaque container over the menu, which is
+ * rendered and blended underneath. With both selected the bench prints the
+ * two as before and after, render time and LVGL heap in use, with the change.
+ * A scenario that needs more list rows than the build's MAX_AP_COUNT is
+ * skipped (see BENCH_MAX_AP_COUNT in CMakeLists.txt). A final pool line
+ * gives LVGL's peak heap use against its pool, and the exit status is 1 if
+ * the peak is over BENCH_POOL_FILL_PCT, so a pool sized close to the limit
+ * for the build's rows fails before it runs out (which aborts, see lv_conf.h).
+ * With --budget-us the exit status is 1 if any scenario's average render
+ * time exceeds the budget, so the bench can gate UI changes. --gestures
+ * instead replays scripted strokes through the gesture recognizer
+ * (gesture_bench.c) and exits 1 if any is misclassified. --fingerprints
+ * times location matching against growing fingerprint databases
+ * (fingerprint_bench.c). --rogue replays sweeps through the rogue AP
+ * detector (rogue_bench.c), by default the scripted fixtures/rogue_sweeps.csv,
+ * and exits 1 if an alert is missed or raised where none was expected.
+ */
+
+#include "cyd_config.h"
+#include "fingerprint_bench.h"
+#include "gesture_bench.h"
+#include "png_writer.h"
+#include "rogue_bench.h"
+#include "scan_results.h"
+#include "ui.h"
+#include "wifi_list_ui.h"
+
+#include "esp_timer.h"
+#include "lvgl.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_MAX_FRAMES 2048
+#define BENCH_SWEEPS 10        /* Sweeps pushed per AP scenario */
+#define BENCH_SETTLE_FRAMES 5  /* Frames stepped after each scripted action */
+#define BENCH_SCROLL_ROWS 20   /* The firmware's list length (wifi_scanner.h) */
+#define BENCH_POOL_FILL_PCT 90 /* Peak LVGL heap use above this fails the run */
+
+typedef struct {
+    uint32_t render_us;
+    uint32_t px;  /* Pixels flushed, i.e. invalidated area actually redrawn */
+} bench_frame_t;
+
+typedef struct {
+    const char *name;
+    void (*run)(void);
+    void (*setup)(void);  /* Precondition, not measured */
+    int rows;  /* List rows the scenario shows; more than MAX_AP_COUNT skips it */
+} bench_scenario_t;
+
+typedef struct {
+    bool ran;
+    uint32_t avg_us;
+    uint32_t mem_used;  /* LVGL heap in use at the end of the scenario */
+} bench_result_t;
+
+static uint16_t s_fb[LCD_H_RES * LCD_V_RES];
+static uint8_t s_buf1[LCD_H_RES * LCD_BUFFER_LINES * 2];
+static uint8_t s_buf2[LCD_H_RES * LCD_BUFFER_LINES * 2];
+
+static uint32_t s_now_ms;
+static int64_t s_render_start_us;
+static uint32_t s_frame_px;
+static bench_frame_t s_frames[BENCH_MAX_FRAMES];
+static int s_frame_count;
+static lv_obj_t *s_overlay;  /* Container of the overlay scenario's list */
+
+static struct {
+    bool pressed;
+    int32_t x;
+    int32_t y;
+} s_input;
+
+static uint32_t s_rand = 12345;
+
+/* Deterministic LCG so every run pushes the same sweeps */
+static uint32_t bench_rand(void)
+{
+    s_rand = s_rand * 1103515245u + 12345u;
+    return s_rand >> 16;
+}
+
+static uint32_t bench_tick_cb(void)
+{
+    return s_now_ms;
+}
+
+static void bench_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
+{
+    const uint16_t *src = (const uint16_t *)px_map;
+    int32_t w = area->x2 - area->x1 + 1;
+    for (int32_t y = area->y1; y <= area->y2; y++) {
+        memcpy(&s_fb[y * LCD_H_RES + area->x1], src, (size_t)w * 2);
+        src += w;
+    }
+    s_frame_px += (uint32_t)(w * (area->y2 - area->y1 + 1));
+    lv_display_flush_ready(disp);
+}
+
+static void bench_render_event_cb(lv_event_t *e)
+{
+    if (lv_event_get_code(e) == LV_EVENT_RENDER_START) {
+        s_render_start_us = esp_timer_get_time();
+        s_frame_px = 0;
+        return;
+    }
+    if (s_frame_count < BENCH_MAX_FRAMES) {
+        s_frames[s_frame_count].render_us = (uint32_t)(esp_timer_get_time() - s_render_start_us);
+        s_frames[s_frame_count].px = s_frame_px;
+        s_frame_count++;
+    }
+}
+
+static void bench_touch_read_cb(lv_indev_t *indev, lv_indev_data_t *data)
+{
+    data->state = s_input.pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+    data->point.x = s_input.x;
+    data->point.y = s_input.y;
+}
+
+/* Advance virtual time by one refresh period and run LVGL once */
+static void step(int frames)
+{
+    for (int i = 0; i < frames; i++) {
+        s_now_ms += LV_DEF_REFR_PERIOD;
+        lv_timer_handler();
+    }
+}
+
+static void tap(int32_t x, int32_t y)
+{
+    s_input.x = x;
+    s_input.y = y;
+    s_input.pressed = true;
+    step(2);
+    s_input.pressed = false;
+    step(BENCH_SETTLE_FRAMES);
+}
+
+/* Vertical drag moving `speed` pixels per frame, then release */
+static void drag(int32_t x, int32_t y_from, int32_t y_to, int32_t speed)
+{
+    int32_t dir = (y_to > y_from) ? 1 : -1;
+    s_input.x = x;
+    s_input.y = y_from;
+    s_input.pressed = true;
+    step(1);
+    while (s_input.y != y_to) {
+        int32_t left = (y_to - s_input.y) * dir;
+        s_input.y += dir * (left < speed ? left : speed);
+        step(1);
+    }
+    s_input.pressed = false;
+}
+
+static void on_green_button(void)
+{
+    ui_show_view(&wifi_list_ui_view);
+}
+
+/* ap_count is at most MAX_AP_COUNT; scenarios needing more are skipped */
+static void push_sweeps(int ap_count)
+{
+    if (ap_count > MAX_AP_COUNT) {
+        abort();
+    }
+    wifi_ap_info_t *aps = calloc((size_t)ap_count, sizeof(*aps));
+    if (!aps) {
+        abort();
+    }
+    for (int i = 0; i < ap_count; i++) {
+        snprintf(aps[i].ssid, sizeof(aps[i].ssid), "Network-%03d", i);
+        aps[i].bssid[5] = (uint8_t)i;
+        aps[i].channel = (uint8_t)(1 + i % 13);
+        aps[i].authmode = (wifi_auth_mode_t)(i % 8);
+        aps[i].rssi_q4 = (int16_t)(-(30 + (int)(bench_rand() % 65)) * (1 << RSSI_FILTER_Q));
+    }
+
+    for (int sweep = 0; sweep < BENCH_SWEEPS; sweep++) {
+        /* Jitter every AP a little, as consecutive sweeps do */
+        for (int i = 0; i < ap_count; i++) {
+            int delta = (int)(bench_rand() % 5) - 2;
+            aps[i].rssi_q4 = (int16_t)(aps[i].rssi_q4 + delta * (1 << RSSI_FILTER_Q));
+            aps[i].trend = delta > 1 ? RSSI_TREND_RISING : delta < -1 ? RSSI_TREND_FALLING : RSSI_TREND_FLAT;
+        }
+        /* Strongest first; the real scanner adds hysteresis on top */
+        for (int i = 1; i < ap_count; i++) {
+            wifi_ap_info_t ap = aps[i];
+            int j = i;
+            while (j > 0 && ap.rssi_q4 > aps[j - 1].rssi_q4) {
+                aps[j] = aps[j - 1];
+                j--;
+            }
+            aps[j] = ap;
+        }
+        /* Published the way the scan task does; the view picks it up from
+         * its poll timer within the settle frames */
+        scan_snapshot_t *snap = scan_results_begin();
+        if (!snap) {
+            abort();
+        }
+        snap->ap_count = (uint16_t)ap_count;
+        memcpy(snap->aps, aps, snap->ap_count * sizeof(*aps));
+        scan_results_publish(snap);
+        step(BENCH_SETTLE_FRAMES);
+    }
+    free(aps);
+}
+
+static void open_scanner(void)
+{
+    /* Tap the green button's centre, wherever the menu laid it out */
+    lv_obj_t *button = ui_get_button(UI_BUTTON_GREEN);
+    if (!button) {
+        return;
+    }
+    lv_area_t area;
+    lv_obj_get_coords(button, &area);
+    tap((area.x1 + area.x2) / 2, (area.y1 + area.y2) / 2);
+}
+
+static void close_overlay(void)
+{
+    if (s_overlay) {
+        wifi_list_ui_view.destroy();
+        lv_obj_delete(s_overlay);
+        s_overlay = NULL;
+    }
+}
+
+static void show_menu(void)
+{
+    close_overlay();
+    ui_show_home();
+}
+
+static void ensure_scanner(void)
+{
+    close_overlay();
+    if (!wifi_list_ui_get_container()) {
+        open_scanner();
+    }
+}
+
+/* The list as it was built before views had their own screens: a child of
+ * the menu screen, inset and 90% opaque, so every frame also draws the menu */
+static void open_overlay(void)
+{
+    show_menu();
+    step(BENCH_SETTLE_FRAMES);
+    s_overlay = lv_obj_create(lv_screen_active());
+    lv_obj_set_size(s_overlay, LCD_H_RES - 20, LCD_V_RES - 40);
+    lv_obj_align(s_overlay, LV_ALIGN_CENTER, 0, 10);
+    lv_obj_set_style_bg_opa(s_overlay, LV_OPA_90, 0);
+    wifi_list_ui_view.create(s_overlay);
+}
+
+static void scenario_open(void)
+{
+    open_scanner();
+    if (!wifi_list_ui_get_container()) {
+        fprintf(stderr, "open: tap did not reach the green button\n");
+    }
+}
+
+static void scenario_aps20(void)
+{
+    push_sweeps(20);
+}
+
+static void scenario_aps100(void)
+{
+    push_sweeps(100);
+}
+
+static void scenario_aps500(void)
+{
+    push_sweeps(500);
+}
+
+static void scenario_overlay(void)
+{
+    push_sweeps(20);
+}
+
+static void scenario_scroll(void)
+{
+    push_sweeps(BENCH_SCROLL_ROWS);
+    int32_t x = LCD_H_RES / 2;
+    drag(x, LCD_V_RES - 20, 40, 12);  /* Fling up, let it coast */
+    step(40);
+    drag(x, 40, LCD_V_RES - 20, 6);   /* Slow drag back down */
+    step(40);
+}
+
+static const bench_scenario_t s_scenarios[] = {
+    {"open", scenario_open, show_menu, 0},
+    {"aps20", scenario_aps20, ensure_scanner, 20},
+    {"aps100", scenario_aps100, ensure_scanner, 100},
+    {"aps500", scenario_aps500, ensure_scanner, 500},
+    {"scroll", scenario_scroll, ensure_scanner, BENCH_SCROLL_ROWS},
+    {"overlay", scenario_overlay, open_overlay, 20},
+};
+
+#define SCENARIO_COUNT ((int)(sizeof(s_scenarios) / sizeof(s_scenarios[0])))
+
+static int scenario_index(const char *name)
+{
+    for (int i = 0; i < SCENARIO_COUNT; i++) {
+        if (strcmp(s_scenarios[i].name, name) == 0) {
+            return i;
+        }
+    }
+    abort();
+}
+
+static int compare_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+/* Print one summary line; returns the average render time */
+static uint32_t report(const char *name, bool verbose, uint32_t *mem_used)
+{
+    static uint32_t sorted[BENCH_MAX_FRAMES];
+    uint64_t total_us = 0;
+    uint64_t total_px = 0;
+    uint32_t max_px = 0;
+
+    for (int i = 0; i < s_frame_count; i++) {
+        if (verbose) {
+            printf("  %s frame %d: %lu us, %lu px\n", name, i,
+                   (unsigned long)s_frames[i].render_us, (unsigned long)s_frames[i].px);
+        }
+        sorted[i] = s_frames[i].render_us;
+        total_us += s_frames[i].render_us;
+        total_px += s_frames[i].px;
+        if (s_frames[i].px > max_px) {
+            max_px = s_frames[i].px;
+        }
+    }
+
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    *mem_used = (uint32_t)(mon.total_size - mon.free_size);
+
+    if (s_frame_count == 0) {
+        printf("%-8s frames=0 mem_used=%lu mem_max=%lu\n", name,
+               (unsigned long)(mon.total_size - mon.free_size), (unsigned long)mon.max_used);
+        return 0;
+    }
+
+    qsort(sorted, (size_t)s_frame_count, sizeof(sorted[0]), compare_u32);
+    uint32_t avg_us = (uint32_t)(total_us / (uint64_t)s_frame_count);
+    printf("%-8s frames=%d render_us avg=%lu p50=%lu p99=%lu max=%lu px avg=%lu max=%lu "
+           "mem_used=%lu mem_max=%lu frag=%u%%\n",
+           name, s_frame_count, (unsigned long)avg_us,
+           (unsigned long)sorted[s_frame_count / 2],
+           (unsigned long)sorted[(s_frame_count * 99) / 100],
+           (unsigned long)sorted[s_frame_count - 1],
+           (unsigned long)(total_px / (uint64_t)s_frame_count), (unsigned long)max_px,
+           (unsigned long)(mon.total_size - mon.free_size), (unsigned long)mon.max_used,
+           (unsigned)mon.frag_pct);
+    return avg_us;
+}
+
+static bool scenario_selected(const char *name, int argc, char **argv, int first)
+{
+    if (first >= argc) {
+        return true;
+    }
+    for (int i = first; i < argc; i++) {
+        if (strcmp(argv[i], name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int main(int argc, char **argv)
+{
+    bool verbose = false;
+    const char *png_dir = NULL;
+    long budget_us = 0;
+    bool gestures = false;
+    bool fingerprints = false;
+    bool rogue = false;
+    int first = 1;
+
+    while (first < argc && argv[first][0] == '-') {
+        if (strcmp(argv[first], "-v") == 0) {
+            verbose = true;
+        } else if (strcmp(argv[first], "--png") == 0 && first + 1 < argc) {
+            png_dir = argv[++first];
+        } else if (strcmp(argv[first], "--budget-us") == 0 && first + 1 < argc) {
+            budget_us = strtol(argv[++first], NULL, 10);
+        } else if (strcmp(argv[first], "--gestures") == 0) {
+            gestures = true;
+        } else if (strcmp(argv[first], "--fingerprints") == 0) {
+            fingerprints = true;
+        } else if (strcmp(argv[first], "--rogue") == 0) {
+            rogue = true;
+        } else {
+            fprintf(stderr, "usage: %s [-v] [--png DIR] [--budget-us N] [--gestures|--fingerprints|--rogue [csv]] [scenario...]\n", argv[0]);
+            return 2;
+        }
+        first++;
+    }
+
+    /* No display needed: the recognizer, the matcher and the detector are pure C */
+    if (gestures) {
+        return gesture_bench_run(verbose) > 0;
+    }
+    if (fingerprints) {
+        return fingerprint_bench_run(verbose) > 0;
+    }
+    if (rogue) {
+        return rogue_bench_run(first < argc ? argv[first] : ROGUE_FIXTURE, verbose) > 0;
+    }
+
+    /* Timings only compare between runs of the same profile */
+    printf("board %s %dx%d, %d buffer lines\n", CYD_BOARD_NAME, LCD_H_RES, LCD_V_RES, LCD_BUFFER_LINES);
+
+    lv_init();
+    lv_tick_set_cb(bench_tick_cb);
+
+    lv_display_t *disp = lv_display_create(LCD_H_RES, LCD_V_RES);
+    lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565);
+    lv_display_set_flush_cb(disp, bench_flush_cb);
+    lv_display_set_buffers(disp, s_buf1, s_buf2, sizeof(s_buf1), LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_add_event_cb(disp, bench_render_event_cb, LV_EVENT_RENDER_START, NULL);
+    lv_display_add_event_cb(disp, bench_render_event_cb, LV_EVENT_RENDER_READY, NULL);
+
+    lv_indev_t *indev = lv_indev_create();
+    lv_indev_set_type(indev, LV_INDEV_TYPE_POINTER);
+    lv_indev_set_display(indev, disp);
+    lv_indev_set_read_cb(indev, bench_touch_read_cb);
+
+    ui_init();
+    ui_set_button_callback(UI_BUTTON_GREEN, on_green_button);
+    step(BENCH_SETTLE_FRAMES);
+
+    int failed = 0;
+    bench_result_t results[SCENARIO_COUNT] = {0};
+    for (int i = 0; i < SCENARIO_COUNT; i++) {
+        const bench_scenario_t *sc = &s_scenarios[i];
+        if (!scenario_selected(sc->name, argc, argv, first)) {
+            continue;
+        }
+        if (sc->rows > MAX_AP_COUNT) {
+            printf("%-8s skipped: needs %d rows, built with MAX_AP_COUNT=%d\n", sc->name, sc->rows, MAX_AP_COUNT);
+            continue;
+        }
+
+        /* Each scenario starts from its precondition, which is not measured */
+        sc->setup();
+        step(BENCH_SETTLE_FRAMES);
+
+        s_frame_count = 0;
+        sc->run();
+        bench_result_t *result = &results[i];
+        result->ran = true;
+        result->avg_us = report(sc->name, verbose, &result->mem_used);
+        uint32_t avg_us = result->avg_us;
+
+        if (png_dir) {
+            char path[512];
+            snprintf(path, sizeof(path), "%s/%s.png", png_dir, sc->name);
+            if (png_write_rgb565(path, s_fb, LCD_H_RES, LCD_V_RES) != 0) {
+                fprintf(stderr, "Failed to write %s\n", path);
+            }
+        }
+        if (budget_us > 0 && avg_us > (uint32_t)budget_us) {
+            printf("FAIL %s: avg render %lu us over budget %ld us\n", sc->name, (unsigned long)avg_us, budget_us);
+            failed = 1;
+        }
+    }
+
+    /* aps20 and overlay push the same sweeps; only the layout differs */
+    const bench_result_t *own = &results[scenario_index("aps20")];
+    const bench_result_t *overlay = &results[scenario_index("overlay")];
+    if (own->ran && overlay->ran) {
+        /* Before: the overlay; after: the view on its own screen */
+        long render_pct = 0;
+        if (overlay->avg_us > 0) {
+            render_pct = ((long)own->avg_us - (long)overlay->avg_us) * 100 / (long)overlay->avg_us;
+        }
+        printf("view     before (overlay) avg=%lu us mem_used=%lu, after (own screen) avg=%lu us mem_used=%lu, "
+               "render %+ld%% mem %+ld\n",
+               (unsigned long)overlay->avg_us, (unsigned long)overlay->mem_used,
+               (unsigned long)own->avg_us, (unsigned long)own->mem_used, render_pct,
+               (long)own->mem_used - (long)overlay->mem_used);
+    }
+
+    /* The pool grows with BENCH_MAX_AP_COUNT by an estimate per row; check it held */
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    uint32_t peak_pct = (uint32_t)((uint64_t)mon.max_used * 100 / mon.total_size);
+    printf("pool     rows=%d size=%lu peak=%lu (%lu%%)\n", MAX_AP_COUNT, (unsigned long)mon.total_size,
+           (unsigned long)mon.max_used, (unsigned long)peak_pct);
+    if (peak_pct > BENCH_POOL_FILL_PCT) {
+        printf("FAIL pool: peak %lu%% of LVGL's pool, over %d%%\n", (unsigned long)peak_pct, BENCH_POOL_FILL_PCT);
+        failed = 1;
+    }
+
+    return failed;
+}
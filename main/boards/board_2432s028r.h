@@ -0,0 +1,66 @@
+#pragma once
+
+/* ======= ESP32-2432S028R: 2.8" ILI9341 + XPT2046 resistive touch ======= */
+
+#define CYD_BOARD_NAME "2432S028R"
+
+/* Panel */
+#define LCD_PANEL CYD_PANEL_ILI9341
+#define LCD_PANEL_NAME "ILI9341"
+#define LCD_H_RES 320
+#define LCD_V_RES 240
+#define LCD_GRAM_LINES 320                       /* Frame memory lines along the panel's scroll axis */
+#define LCD_GRAM_LINES_ALONG_X 1                 /* At rotation 0 those lines run along screen x */
+#define LCD_PCLK_HZ (40 * 1000 * 1000)           /* Panel SPI clock */
+#define LCD_BUFFER_LINES 40                      /* Lines per LVGL draw buffer (25 KB each) */
+#define LCD_COLOR_SPACE ESP_LCD_COLOR_SPACE_RGB  /* esp_lcd constant, only expanded in cyd_hw.c */
+#define LCD_INVERT_COLOR 0
+#define LCD_MIRROR_X 1
+#define LCD_MIRROR_Y 0
+#define LCD_SWAP_COLOR_BYTES 1                   /* LVGL renders little-endian RGB565, the panel takes big-endian */
+#define LCD_SWAP_RB 0
+
+/* Touch: own SPI bus, which the microSD slot also needs */
+#define TOUCH_CONTROLLER CYD_TOUCH_XPT2046
+#define TOUCH_CONTROLLER_NAME "XPT2046"
+#define TOUCH_SPI_HOST SPI3_HOST                 /* Only expanded in cyd_hw.c */
+#define TOUCH_SHARES_SD_BUS 1                    /* On the microSD slot's SPI3 host */
+#define TOUCH_SHARES_LCD_BUS 0
+#define TOUCH_CLK_HZ (2 * 1000 * 1000)
+#define TOUCH_SWAP_XY 1
+#define TOUCH_MIRROR_X 1
+#define TOUCH_MIRROR_Y 1
+
+/* Raw touch bounds observed on this panel; update them if touch does not
+ * reach the screen edges */
+#define TOUCH_RAW_X_MIN 21
+#define TOUCH_RAW_X_MAX 220
+#define TOUCH_RAW_Y_MIN 23
+#define TOUCH_RAW_Y_MAX 289
+
+/* LCD SPI pins */
+#define CYD_PIN_NUM_MOSI     13
+#define CYD_PIN_NUM_MISO     12
+#define CYD_PIN_NUM_SCLK     14
+
+/* LCD control pins */
+#define CYD_PIN_NUM_LCD_CS   15
+#define CYD_PIN_NUM_LCD_DC    2
+#define CYD_PIN_NUM_LCD_RST   4
+#define CYD_PIN_NUM_BCKL     21
+
+/* Touch SPI pins (separate bus) */
+#define CYD_PIN_NUM_TCH_MOSI 32
+#define CYD_PIN_NUM_TCH_MISO 39
+#define CYD_PIN_NUM_TCH_SCLK 25
+#define CYD_PIN_NUM_TCH_CS   33
+#define CYD_PIN_NUM_TCH_IRQ  36
+
+/* Framebuffer mirror UART TX (CN1 connector) */
+#define CYD_PIN_NUM_MIRROR_TX 27
+
+/* microSD slot (SPI) */
+#define CYD_PIN_NUM_SD_MOSI  23
+#define CYD_PIN_NUM_SD_MISO  19
+#define CYD_PIN_NUM_SD_SCLK  18
+#define CYD_PIN_NUM_SD_CS     5
@@ -0,0 +1,64 @@
+#pragma once
+
+/* ======= ESP32-3248S035C: 3.5" ST7796 + GT911 capacitive touch ======= */
+
+#define CYD_BOARD_NAME "3248S035C"
+
+/* Panel, in its native portrait orientation */
+#define LCD_PANEL CYD_PANEL_ST7796
+#define LCD_PANEL_NAME "ST7796"
+#define LCD_H_RES 320
+#define LCD_V_RES 480
+#define LCD_GRAM_LINES 480                       /* Frame memory lines along the panel's scroll axis */
+#define LCD_GRAM_LINES_ALONG_X 0                 /* At rotation 0 those lines run along screen y */
+#define LCD_PCLK_HZ (40 * 1000 * 1000)           /* Panel SPI clock */
+#define LCD_BUFFER_LINES 40                      /* Lines per LVGL draw buffer (25 KB each) */
+#define LCD_COLOR_SPACE ESP_LCD_COLOR_SPACE_BGR  /* esp_lcd constant, only expanded in cyd_hw.c */
+#define LCD_INVERT_COLOR 0
+#define LCD_MIRROR_X 1
+#define LCD_MIRROR_Y 0
+#define LCD_SWAP_COLOR_BYTES 1                   /* LVGL renders little-endian RGB565, the panel takes big-endian */
+#define LCD_SWAP_RB 0                            /* BGR is set in the panel instead */
+
+/* Touch: I2C, reports screen pixels in the panel's native orientation */
+#define TOUCH_CONTROLLER CYD_TOUCH_GT911
+#define TOUCH_CONTROLLER_NAME "GT911"
+#define TOUCH_I2C_PORT I2C_NUM_0                 /* Only expanded in cyd_hw.c */
+#define TOUCH_SHARES_SD_BUS 0                    /* On the microSD slot's SPI3 host */
+#define TOUCH_SHARES_LCD_BUS 0
+#define TOUCH_CLK_HZ (400 * 1000)
+#define TOUCH_SWAP_XY 0
+#define TOUCH_MIRROR_X 0
+#define TOUCH_MIRROR_Y 0
+
+/* Already calibrated: the full range maps one to one */
+#define TOUCH_RAW_X_MIN 0
+#define TOUCH_RAW_X_MAX (LCD_H_RES - 1)
+#define TOUCH_RAW_Y_MIN 0
+#define TOUCH_RAW_Y_MAX (LCD_V_RES - 1)
+
+/* LCD SPI pins */
+#define CYD_PIN_NUM_MOSI     13
+#define CYD_PIN_NUM_MISO     12
+#define CYD_PIN_NUM_SCLK     14
+
+/* LCD control pins; reset is tied to EN */
+#define CYD_PIN_NUM_LCD_CS   15
+#define CYD_PIN_NUM_LCD_DC    2
+#define CYD_PIN_NUM_LCD_RST  -1
+#define CYD_PIN_NUM_BCKL     27
+
+/* Touch I2C pins */
+#define CYD_PIN_NUM_TCH_SDA  33
+#define CYD_PIN_NUM_TCH_SCL  32
+#define CYD_PIN_NUM_TCH_RST  25
+#define CYD_PIN_NUM_TCH_INT  21
+
+/* Framebuffer mirror UART TX (P3 connector) */
+#define CYD_PIN_NUM_MIRROR_TX 22
+
+/* microSD slot (SPI) */
+#define CYD_PIN_NUM_SD_MOSI  23
+#define CYD_PIN_NUM_SD_MISO  19
+#define CYD_PIN_NUM_SD_SCLK  18
+#define CYD_PIN_NUM_SD_CS     5
@@ -0,0 +1,66 @@
+#pragma once
+
+/* ======= ESP32-3248S035R: 3.5" ST7796 + XPT2046 resistive touch ======= */
+
+#define CYD_BOARD_NAME "3248S035R"
+
+/* Panel, in its native portrait orientation */
+#define LCD_PANEL CYD_PANEL_ST7796
+#define LCD_PANEL_NAME "ST7796"
+#define LCD_H_RES 320
+#define LCD_V_RES 480
+#define LCD_GRAM_LINES 480                       /* Frame memory lines along the panel's scroll axis */
+#define LCD_GRAM_LINES_ALONG_X 0                 /* At rotation 0 those lines run along screen y */
+#define LCD_PCLK_HZ (40 * 1000 * 1000)           /* Panel SPI clock */
+#define LCD_BUFFER_LINES 40                      /* Lines per LVGL draw buffer (25 KB each) */
+#define LCD_COLOR_SPACE ESP_LCD_COLOR_SPACE_BGR  /* esp_lcd constant, only expanded in cyd_hw.c */
+#define LCD_INVERT_COLOR 0
+#define LCD_MIRROR_X 1
+#define LCD_MIRROR_Y 0
+#define LCD_SWAP_COLOR_BYTES 1                   /* LVGL renders little-endian RGB565, the panel takes big-endian */
+#define LCD_SWAP_RB 0                            /* BGR is set in the panel instead */
+
+/* Touch: a second device on the LCD's SPI bus, so the microSD slot keeps
+ * its own */
+#define TOUCH_CONTROLLER CYD_TOUCH_XPT2046
+#define TOUCH_CONTROLLER_NAME "XPT2046"
+#define TOUCH_SPI_HOST SPI2_HOST                 /* Only expanded in cyd_hw.c */
+#define TOUCH_SHARES_SD_BUS 0                    /* On the microSD slot's SPI3 host */
+#define TOUCH_SHARES_LCD_BUS 1
+#define TOUCH_CLK_HZ (2 * 1000 * 1000)
+#define TOUCH_SWAP_XY 0
+#define TOUCH_MIRROR_X 0
+#define TOUCH_MIRROR_Y 1
+
+/* Raw touch bounds, starting points; measure yours as for the 2.8" board */
+#define TOUCH_RAW_X_MIN 14
+#define TOUCH_RAW_X_MAX 305
+#define TOUCH_RAW_Y_MIN 20
+#define TOUCH_RAW_Y_MAX 462
+
+/* LCD SPI pins, shared with touch */
+#define CYD_PIN_NUM_MOSI     13
+#define CYD_PIN_NUM_MISO     12
+#define CYD_PIN_NUM_SCLK     14
+
+/* LCD control pins; reset is tied to EN */
+#define CYD_PIN_NUM_LCD_CS   15
+#define CYD_PIN_NUM_LCD_DC    2
+#define CYD_PIN_NUM_LCD_RST  -1
+#define CYD_PIN_NUM_BCKL     27
+
+/* Touch pins on the LCD bus */
+#define CYD_PIN_NUM_TCH_MOSI CYD_PIN_NUM_MOSI
+#define CYD_PIN_NUM_TCH_MISO CYD_PIN_NUM_MISO
+#define CYD_PIN_NUM_TCH_SCLK CYD_PIN_NUM_SCLK
+#define CYD_PIN_NUM_TCH_CS   33
+#define CYD_PIN_NUM_TCH_IRQ  36
+
+/* Framebuffer mirror UART TX (P3 connector) */
+#define CYD_PIN_NUM_MIRROR_TX 22
+
+/* microSD slot (SPI) */
+#define CYD_PIN_NUM_SD_MOSI  23
+#define CYD_PIN_NUM_SD_MISO  19
+#define CYD_PIN_NUM_SD_SCLK  18
+#define CYD_PIN_NUM_SD_CS     5
@@ -0,0 +1,50 @@
+#pragma once
+
+/*
+ * Board profile selection.
+ *
+ * The board is picked in menuconfig (CYD board, main/Kconfig.projbuild) and
+ * its profile in boards/ supplies everything that differs between CYD
+ * variants as compile-time constants: resolution, panel and touch
+ * controller, SPI clocks, orientation and color flags, pins and touch
+ * calibration. Code that depends on them tests the constants, so each
+ * build carries only its own board's path.
+ *
+ * Host builds (host_bench) have no sdkconfig; they pass the same
+ * CONFIG_CYD_BOARD_* define themselves and default to the 2.8" board.
+ */
+
+#if __has_include("sdkconfig.h")
+#include "sdkconfig.h"
+#endif
+
+/* Panel controllers (LCD_PANEL) */
+#define CYD_PANEL_ILI9341 1
+#define CYD_PANEL_ST7796 2
+
+/* Touch controllers (TOUCH_CONTROLLER) */
+#define CYD_TOUCH_XPT2046 1  /* Resistive, SPI, raw readings scaled by TOUCH_RAW_* */
+#define CYD_TOUCH_GT911 2    /* Capacitive, I2C, reports screen pixels */
+
+#if defined(CONFIG_CYD_BOARD_3248S035C)
+#include "boards/board_3248s035c.h"
+#elif defined(CONFIG_CYD_BOARD_3248S035R)
+#include "boards/board_3248s035r.h"
+#elif defined(CONFIG_CYD_BOARD_2432S028R) || !defined(ESP_PLATFORM)
+#include "boards/board_2432s028r.h"
+#else
+#error "No CYD board selected; pick one under 'CYD board' in menuconfig"
+#endif
+
+_Static_assert(LCD_H_RES > 0 && LCD_V_RES > 0, "Board profile needs a resolution");
+_Static_assert(LCD_GRAM_LINES >= LCD_H_RES && LCD_GRAM_LINES >= LCD_V_RES,
+               "Frame memory must cover the panel in both orientations");
+_Static_assert(LCD_GRAM_LINES == (LCD_GRAM_LINES_ALONG_X ? LCD_H_RES : LCD_V_RES),
+               "Frame memory lines must span the screen axis they run along");
+_Static_assert(LCD_BUFFER_LINES > 0 && LCD_BUFFER_LINES <= LCD_V_RES && LCD_BUFFER_LINES <= LCD_H_RES,
+               "Draw buffer lines must fit the panel in both orientations");
+_Static_assert(TOUCH_RAW_X_MAX > TOUCH_RAW_X_MIN && TOUCH_RAW_Y_MAX > TOUCH_RAW_Y_MIN,
+               "Touch calibration range is empty");
+_Static_assert(LCD_PANEL == CYD_PANEL_ILI9341 || LCD_PANEL == CYD_PANEL_ST7796, "Unknown panel");
+_Static_assert(TOUCH_CONTROLLER == CYD_TOUCH_XPT2046 || TOUCH_CONTROLLER == CYD_TOUCH_GT911,
+               "Unknown touch controller");
@@ -1,8 +0,0 @@
-#pragma once
-
-/* Raw touch bounds observed on this panel */
-/* Update these values if touch does not reach the screen edges */
-#define TOUCH_RAW_X_MIN 21
-#define TOUCH_RAW_X_MAX 220
-#define TOUCH_RAW_Y_MIN 23
-#define TOUCH_RAW_Y_MAX 289
@@ -1,12 +1,89 @@
 #pragma once
 
-/* Main configuration file - includes all CYD-specific settings */
-#include "cyd_pins.h"
+/* Main configuration file - includes the selected board profile and all
+ * CYD-specific settings */
 #include "cyd_display_config.h"
-#include "cyd_calibration.h"
 
 /* UI Configuration */
 #define CURSOR_OFFSET 6  /* Cursor centering offset in pixels */
 #define TOUCH_LABEL_MAX_LEN 64  /* Maximum length for touch coordinate label */
-#define LVGL_TASK_DELAY_MS 10  /* LVGL task handler delay */
-#define LVGL_TICK_PERIOD_MS 1  /* LVGL tick timer period */
+#define LVGL_TASK_DELAY_MS 10  /* Minimum LVGL task handler delay */
+#define LVGL_TASK_PRIORITY 1  /* Priority of the LVGL loop (app_main) task */
+
+/* Touch sampling (see touch_sampler.h) and gestures (see gesture.h) */
+#define TOUCH_SAMPLE_PERIOD_MS 5    /* While in contact; otherwise the touch_period tuning */
+#define TOUCH_SAMPLE_TAIL_MS 100    /* Keep sampling fast this long after contact ends */
+#define TOUCH_SAMPLER_PRIORITY 6    /* Above the LVGL loop and the scan task */
+#define GESTURE_SLOP_PX 8           /* Resistive jitter stays well inside this */
+#define GESTURE_RELEASE_MS 30       /* Pressure dropouts mid-drag are shorter */
+#define GESTURE_LONG_PRESS_MS 500
+#define GESTURE_VELOCITY_WINDOW_MS 60
+#define GESTURE_SWIPE_MIN_PX 40
+#define GESTURE_SWIPE_MAX_MS 300
+#define GESTURE_FLING_MIN_PX_S 300
+
+/* Kinetic scrolling of the active view's scroll body from the fling
+ * velocity, in place of LVGL's own scroll momentum (see kinetic_scroll.h) */
+#define KINETIC_SCROLL_ENABLE 1
+#define KINETIC_SCROLL_TAU_MS 325     /* Velocity decays by 1/e in this time */
+#define KINETIC_SCROLL_MIN_PX_S 20    /* Stop below this speed */
+#define KINETIC_SCROLL_MAX_PX_S 4000  /* Clamp for wild flings */
+
+/* Power management (see power.h). DFS and automatic light sleep also need
+ * CONFIG_PM_ENABLE and CONFIG_FREERTOS_USE_TICKLESS_IDLE (sdkconfig.defaults). */
+#define POWER_MGMT_ENABLE 1
+#define POWER_CPU_MAX_MHZ 240
+#define POWER_CPU_MIN_MHZ 80
+#define POWER_LVGL_MAX_WAIT_MS 200  /* Longest LVGL loop sleep while no timer is due */
+#define POWER_IDLE_TOUCH_PERIOD_MS 100  /* Touch polling while the backlight is dimmed */
+
+/* Backlight PWM */
+#define BACKLIGHT_LEDC_FREQ_HZ 5000
+#define BACKLIGHT_LEDC_RESOLUTION LEDC_TIMER_10_BIT  /* Only expanded in cyd_hw.c */
+#define BACKLIGHT_DIM_AFTER_MS 30000  /* Dim after this long without touch, 0 = never */
+#define BACKLIGHT_DIM_PCT 15
+
+/* Rough board currents per state for the charge estimate on the power page.
+ * Defaults are ballpark figures for a CYD on 5 V; measure yours. */
+#define POWER_MA_SCAN 120
+#define POWER_MA_RENDER 70
+#define POWER_MA_IDLE 35
+#define POWER_MA_SLEEP 8
+#define POWER_MA_BACKLIGHT 45  /* At full brightness, scaled by the PWM duty */
+
+/* WiFi scanner */
+#define WIFI_SCAN_INTERVAL_MS 2000  /* Delay between sweeps */
+#define WIFI_SCAN_TASK_PRIORITY 5
+/* Pause sweeping while the scanner view is not shown. The SD log records
+ * sweeps nobody looks at, so it keeps the radio going. */
+#define WIFI_SCAN_PAUSE_HIDDEN (!SCAN_LOG_ENABLE)
+
+/* Tracking one AP (see wifi_track.h): scans locked to its channel and BSSID */
+#define WIFI_TRACK_DWELL_MS 30          /* Active scan: wait this long for the probe response */
+#define WIFI_TRACK_BEACON_DWELL_MS 110  /* Passive scan: one beacon interval (102.4 ms) */
+#define WIFI_TRACK_INTERVAL_MS 20       /* Gap between locked scans */
+
+/* Flag evil twins, downgraded security and moved APs (see rogue_detect.h) */
+#define ROGUE_DETECT_ENABLE 1
+
+/* Serial console for runtime tuning (see tuning.h and cyd_console.c) */
+#define CONSOLE_ENABLE 1
+
+/* Metrics (see metrics.h) */
+#define METRICS_DUMP_INTERVAL_S 300  /* Print all metrics this often, 0 to disable */
+
+/* Framebuffer mirror (see fb_mirror.h) */
+#define FB_MIRROR_ENABLE 0  /* Stream flushed areas to a host viewer over UART */
+#define FB_MIRROR_UART_NUM 1
+#define FB_MIRROR_BAUD 2000000
+#define FB_MIRROR_REFRESH_MS 1000  /* Minimum time between resends of dropped tiles */
+
+/* SD card scan log (see scan_log.h). The SD slot needs the SPI3 host, which
+ * the 2.8" board also uses for touch (TOUCH_SHARES_SD_BUS); there enabling
+ * this turns the board into a headless logger: touch is skipped and the
+ * scanner starts at boot. Other boards log alongside touch. */
+#define SCAN_LOG_ENABLE 0
+#define SCAN_LOG_MOUNT_POINT "/sdcard"
+#define SCAN_LOG_FLUSH_MS 10000  /* Write out a partial block this long after the last write */
+#define SCAN_LOG_MAX_FILE_SIZE (4 * 1024 * 1024)  /* Rotate to a new file at this size */
+#define SCAN_LOG_MAX_FILES 16  /* Oldest files beyond this are deleted */
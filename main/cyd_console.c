@@ -0,0 +1,479 @@
+#include "cyd_console.h"
+#include "cyd_config.h"
+#include "fingerprint.h"
+#include "lcd_vscroll.h"
+#include "metrics.h"
+#include "rogue_detect.h"
+#include "rssi_filter.h"
+#include "scan_results.h"
+#include "tuning.h"
+#include "ui.h"
+#include "wifi_scanner.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "esp_console.h"
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "console";
+
+#define BENCH_DEFAULT_FRAMES 30
+#define BENCH_DEFAULT_SCANS 3
+#define BENCH_TILES_DEFAULT_FRAMES 100
+#define SCROLL_DEFAULT_STEPS 20
+#define SCROLL_DEFAULT_PX 8
+#define FINGERPRINT_LIST_MAX 64
+
+typedef struct {
+    uint32_t n;
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+} bench_stats_t;
+
+static void bench_add(bench_stats_t *stats, uint32_t value)
+{
+    if (stats->n == 0 || value < stats->min) {
+        stats->min = value;
+    }
+    if (value > stats->max) {
+        stats->max = value;
+    }
+    stats->total += value;
+    stats->n++;
+}
+
+static void bench_print(const char *name, const bench_stats_t *stats)
+{
+    if (stats->n == 0) {
+        printf("%s: no samples\n", name);
+        return;
+    }
+    printf("%s: n=%lu min=%lu avg=%lu max=%lu us\n", name, (unsigned long)stats->n,
+           (unsigned long)stats->min, (unsigned long)(stats->total / stats->n), (unsigned long)stats->max);
+}
+
+static int cmd_tune(int argc, char **argv)
+{
+    if (argc == 1) {
+        tuning_print(stdout, TUNING_COUNT);
+        return 0;
+    }
+
+    tuning_id_t id = tuning_find(argv[1]);
+    if (id == TUNING_COUNT) {
+        printf("Unknown parameter '%s'\n", argv[1]);
+        return 1;
+    }
+    if (argc > 2) {
+        char *end;
+        long value = strtol(argv[2], &end, 0);
+        if (*end != '\0' || tuning_set(id, (int32_t)value) != ESP_OK) {
+            printf("Invalid value '%s'\n", argv[2]);
+            return 1;
+        }
+    }
+    tuning_print(stdout, id);
+    return 0;
+}
+
+static int cmd_tune_save(int argc, char **argv)
+{
+    (void)argc; (void)argv;
+    return tuning_save() == ESP_OK ? 0 : 1;
+}
+
+static int cmd_tune_reset(int argc, char **argv)
+{
+    (void)argc; (void)argv;
+    return tuning_reset() == ESP_OK ? 0 : 1;
+}
+
+/* Fixed workload: full-screen redraws of the active view, then scan sweeps */
+static int cmd_bench(int argc, char **argv)
+{
+    int frames = (argc > 1) ? atoi(argv[1]) : BENCH_DEFAULT_FRAMES;
+    int scans = (argc > 2) ? atoi(argv[2]) : BENCH_DEFAULT_SCANS;
+
+    printf("bench: board %s (%s %dx%d, %s), pclk %ld Hz, %ld buffer lines, refr %ld ms, scan %s dwell %ld ms\n",
+           CYD_BOARD_NAME, LCD_PANEL_NAME, LCD_H_RES, LCD_V_RES, TOUCH_CONTROLLER_NAME,
+           (long)tuning_get(TUNING_LCD_PCLK_HZ), (long)tuning_get(TUNING_LCD_BUFFER_LINES),
+           (long)tuning_get(TUNING_REFR_PERIOD_MS), tuning_get(TUNING_SCAN_PASSIVE) ? "passive" : "active",
+           (long)tuning_get(TUNING_SCAN_DWELL_MS));
+
+    bench_stats_t redraw = {0};
+    for (int i = 0; i < frames; i++) {
+        ui_lock();
+        int64_t start = esp_timer_get_time();
+        lv_obj_invalidate(lv_screen_active());
+        lv_refr_now(NULL);
+        bench_add(&redraw, (uint32_t)(esp_timer_get_time() - start));
+        ui_unlock();
+        /* Let the LVGL loop and idle task run between frames */
+        vTaskDelay(1);
+    }
+    bench_print("redraw", &redraw);
+
+    if (scans > 0 && wifi_scanner_init() != ESP_OK) {
+        printf("scan: WiFi unavailable\n");
+        return 1;
+    }
+    bench_stats_t sweep = {0};
+    uint32_t total_aps = 0;
+    for (int i = 0; i < scans; i++) {
+        uint16_t ap_count = 0;
+        uint32_t elapsed_us = 0;
+        if (wifi_scanner_scan_once(&ap_count, &elapsed_us) != ESP_OK) {
+            printf("scan: sweep %d failed\n", i);
+            continue;
+        }
+        bench_add(&sweep, elapsed_us);
+        total_aps += ap_count;
+    }
+    bench_print("scan", &sweep);
+    if (sweep.n > 0) {
+        printf("scan: %lu networks per sweep\n", (unsigned long)(total_aps / sweep.n));
+    }
+    return 0;
+}
+
+/* Full-screen redraws of the scanner list with one render tile, then one per
+ * draw thread, while the scanner keeps sweeping in the background */
+static int cmd_bench_tiles(int argc, char **argv)
+{
+    int frames = (argc > 1) ? atoi(argv[1]) : BENCH_TILES_DEFAULT_FRAMES;
+    if (frames <= 0) {
+        printf("Invalid arguments\n");
+        return 1;
+    }
+
+    /* Shows the list, which also resumes a paused scanner */
+    if (wifi_scanner_init() != ESP_OK || wifi_scanner_start() != ESP_OK) {
+        printf("Scanner unavailable\n");
+        return 1;
+    }
+    wifi_scanner_resume();
+    printf("bench_tiles: %d draw threads, %d buffer lines\n", LV_DRAW_SW_DRAW_UNIT_CNT,
+           (int)tuning_get(TUNING_LCD_BUFFER_LINES));
+
+    lv_display_t *disp = lv_display_get_default();
+    const uint32_t tile_counts[] = {1, LV_DRAW_SW_DRAW_UNIT_CNT};
+    uint32_t avg_us[2] = {0};
+    for (int t = 0; t < 2; t++) {
+        if (t > 0 && tile_counts[t] == tile_counts[0]) {
+            printf("Only one draw thread; build with CONFIG_LV_DRAW_SW_DRAW_UNIT_CNT=2 to compare\n");
+            break;
+        }
+        bench_stats_t redraw = {0};
+        uint32_t start_scans = metrics_counter(METRIC_CNT_SCANS);
+        for (int i = 0; i < frames; i++) {
+            ui_lock();
+            lv_display_set_tile_cnt(disp, tile_counts[t]);
+            int64_t start = esp_timer_get_time();
+            lv_obj_invalidate(lv_screen_active());
+            lv_refr_now(disp);
+            bench_add(&redraw, (uint32_t)(esp_timer_get_time() - start));
+            ui_unlock();
+            /* Let the LVGL loop and the scan task run between frames */
+            vTaskDelay(1);
+        }
+        char name[16];
+        snprintf(name, sizeof(name), "%lu tile%s", (unsigned long)tile_counts[t], tile_counts[t] > 1 ? "s" : "");
+        bench_print(name, &redraw);
+        printf("%s: %lu sweeps during the run\n", name,
+               (unsigned long)(metrics_counter(METRIC_CNT_SCANS) - start_scans));
+        avg_us[t] = (uint32_t)(redraw.total / redraw.n);
+    }
+    if (avg_us[1] > 0) {
+        printf("speedup: %lu.%02lux\n", (unsigned long)(avg_us[0] / avg_us[1]),
+               (unsigned long)(avg_us[0] % avg_us[1] * 100 / avg_us[1]));
+    }
+
+    ui_lock();
+    lv_display_set_tile_cnt(disp, (uint32_t)tuning_get(TUNING_LVGL_TILES));
+    ui_unlock();
+    return 0;
+}
+
+/* Scroll the shown list body step by step, in the panel and in software,
+ * and compare what each step sends over SPI */
+static int cmd_scroll(int argc, char **argv)
+{
+    int steps = (argc > 1) ? atoi(argv[1]) : SCROLL_DEFAULT_STEPS;
+    int px = (argc > 2) ? atoi(argv[2]) : SCROLL_DEFAULT_PX;
+    if (steps <= 0 || px <= 0) {
+        printf("Invalid arguments\n");
+        return 1;
+    }
+
+    ui_lock();
+    lv_obj_t *body = lcd_vscroll_get_body();
+    if (!body) {
+        ui_unlock();
+        printf("No scrollable list shown\n");
+        return 1;
+    }
+
+    bool was_enabled = lcd_vscroll_set_enabled(true);
+    for (int hw = 1; hw >= 0; hw--) {
+        lcd_vscroll_set_enabled(hw);
+        if (hw && !lcd_vscroll_is_active()) {
+            printf("hw: not usable in this orientation\n");
+            continue;
+        }
+        lv_obj_scroll_to_y(body, 0, LV_ANIM_OFF);
+        lv_refr_now(NULL);
+
+        bench_stats_t step = {0};
+        bool down = true;
+        uint32_t start_bytes = metrics_counter(METRIC_CNT_LCD_BYTES);
+        for (int i = 0; i < steps; i++) {
+            /* Back and forth within the scroll range */
+            if ((down ? lv_obj_get_scroll_bottom(body) : lv_obj_get_scroll_top(body)) < px) {
+                down = !down;
+                if ((down ? lv_obj_get_scroll_bottom(body) : lv_obj_get_scroll_top(body)) < px) {
+                    break;
+                }
+            }
+            int64_t start = esp_timer_get_time();
+            lv_obj_scroll_by(body, 0, down ? -px : px, LV_ANIM_OFF);
+            lv_refr_now(NULL);
+            bench_add(&step, (uint32_t)(esp_timer_get_time() - start));
+        }
+        uint32_t bytes = metrics_counter(METRIC_CNT_LCD_BYTES) - start_bytes;
+
+        if (step.n == 0) {
+            printf("List too short to scroll by %d px\n", px);
+            break;
+        }
+        bench_print(hw ? "hw step" : "sw step", &step);
+        printf("%s: %lu SPI bytes per %d px step\n", hw ? "hw" : "sw", (unsigned long)(bytes / step.n), px);
+    }
+    lcd_vscroll_set_enabled(was_enabled);
+    ui_unlock();
+    return 0;
+}
+
+static int cmd_metrics(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "reset") == 0) {
+        metrics_reset();
+        return 0;
+    }
+    metrics_dump(stdout);
+    return 0;
+}
+
+/* Another snapshot reader: print the latest sweep without touching the scanner */
+static int cmd_aps(int argc, char **argv)
+{
+    (void)argc; (void)argv;
+    const scan_snapshot_t *snap = scan_results_acquire();
+    if (!snap) {
+        printf("No sweep published yet\n");
+        return 1;
+    }
+    printf("sweep %lu, %lld ms ago, %u networks\n", (unsigned long)snap->version,
+           (long long)((esp_timer_get_time() - snap->time_us) / 1000), snap->ap_count);
+    for (int i = 0; i < snap->ap_count; i++) {
+        const wifi_ap_info_t *ap = &snap->aps[i];
+        printf("%2d %02x:%02x:%02x:%02x:%02x:%02x ch%-2u %4d dBm %s\n", i + 1,
+               ap->bssid[0], ap->bssid[1], ap->bssid[2], ap->bssid[3], ap->bssid[4], ap->bssid[5],
+               ap->channel, rssi_filter_to_dbm(ap->rssi_q4), ap->ssid);
+    }
+    scan_results_release(snap);
+    return 0;
+}
+
+static int cmd_rogue(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "reset") == 0) {
+        /* Applied by the scan task at the end of its current sweep */
+        rogue_detect_reset();
+        printf("Rogue detector will relearn from the next sweep\n");
+        return 0;
+    }
+    rogue_stats_t stats;
+    rogue_detect_get_stats(&stats);
+    printf("sweeps %lu, records %lu, unindexed %lu\n", (unsigned long)stats.sweeps,
+           (unsigned long)stats.records, (unsigned long)stats.unindexed);
+    printf("ssids %lu/%d, trusted %lu\n", (unsigned long)stats.ssids, ROGUE_INDEX_SLOTS,
+           (unsigned long)stats.trusted);
+    for (int i = 0; i < ROGUE_ALERT_COUNT; i++) {
+        printf("%-14s %lu\n", rogue_alert_name((rogue_alert_type_t)i), (unsigned long)stats.alerts[i]);
+    }
+    return 0;
+}
+
+static int cmd_fingerprint(int argc, char **argv)
+{
+    esp_err_t ret = ESP_OK;
+    if (argc > 1) {
+        if (strcmp(argv[1], "clear") == 0) {
+            ret = fingerprint_clear();
+        } else if (strcmp(argv[1], "loc") == 0) {
+            /* Without a name, start a new auto-named location */
+            ret = fingerprint_set_location(argc > 2 ? argv[2] : NULL);
+        } else {
+            printf("Unknown action '%s'\n", argv[1]);
+            return 1;
+        }
+    }
+    if (ret != ESP_OK) {
+        printf("Failed: %s\n", esp_err_to_name(ret));
+        return 1;
+    }
+
+    static fingerprint_location_t locations[FINGERPRINT_LIST_MAX];
+    int count = fingerprint_list_locations(locations, FINGERPRINT_LIST_MAX);
+    for (int i = 0; i < count; i++) {
+        printf("%-*s %lu\n", FINGERPRINT_LABEL_LEN - 1, locations[i].label, (unsigned long)locations[i].samples);
+    }
+    char selected[FINGERPRINT_LABEL_LEN];
+    fingerprint_get_location(selected);
+    printf("%lu fingerprints, recording to %s\n", (unsigned long)fingerprint_count(),
+           selected[0] ? selected : "a new location");
+    return 0;
+}
+
+static int cmd_scanner(int argc, char **argv)
+{
+    esp_err_t ret = ESP_OK;
+    if (argc > 1) {
+        if (strcmp(argv[1], "pause") == 0) {
+            ret = wifi_scanner_pause();
+        } else if (strcmp(argv[1], "resume") == 0) {
+            ret = wifi_scanner_resume();
+        } else if (strcmp(argv[1], "stop") == 0) {
+            ret = wifi_scanner_stop();
+        } else if (strcmp(argv[1], "start") == 0) {
+            ret = wifi_scanner_init();
+            if (ret == ESP_OK) {
+                ret = wifi_scanner_start();
+            }
+        } else {
+            printf("Unknown action '%s'\n", argv[1]);
+            return 1;
+        }
+    }
+    if (ret != ESP_OK) {
+        printf("Failed: %s\n", esp_err_to_name(ret));
+        return 1;
+    }
+    printf("scanner %s\n", wifi_scanner_state_name(wifi_scanner_get_state()));
+    return 0;
+}
+
+static int cmd_restart(int argc, char **argv)
+{
+    (void)argc; (void)argv;
+    esp_restart();
+    return 0;
+}
+
+static const esp_console_cmd_t s_commands[] = {
+    {
+        .command = "tune",
+        .help = "Show all parameters, one parameter, or set one",
+        .hint = "[name [value]]",
+        .func = cmd_tune,
+    },
+    {
+        .command = "tune_save",
+        .help = "Save parameters to NVS",
+        .func = cmd_tune_save,
+    },
+    {
+        .command = "tune_reset",
+        .help = "Restore default parameters and erase saved ones",
+        .func = cmd_tune_reset,
+    },
+    {
+        .command = "bench",
+        .help = "Time full-screen redraws and WiFi sweeps",
+        .hint = "[frames [scans]]",
+        .func = cmd_bench,
+    },
+    {
+        .command = "bench_tiles",
+        .help = "Compare list redraws with 1 render tile and one per draw thread while scanning",
+        .hint = "[frames]",
+        .func = cmd_bench_tiles,
+    },
+    {
+        .command = "scroll",
+        .help = "Compare hardware and software scrolling of the shown list",
+        .hint = "[steps [px]]",
+        .func = cmd_scroll,
+    },
+    {
+        .command = "metrics",
+        .help = "Print the metrics registry, or clear it",
+        .hint = "[reset]",
+        .func = cmd_metrics,
+    },
+    {
+        .command = "aps",
+        .help = "Print the latest published sweep",
+        .func = cmd_aps,
+    },
+    {
+        .command = "rogue",
+        .help = "Print rogue AP detector counters, or forget what it learned",
+        .hint = "[reset]",
+        .func = cmd_rogue,
+    },
+    {
+        .command = "fingerprint",
+        .help = "List stored locations, select the one Rec records to (new if no name), or erase all",
+        .hint = "[loc [name]|clear]",
+        .func = cmd_fingerprint,
+    },
+    {
+        .command = "scanner",
+        .help = "Show the scanner state, or start, pause, resume or stop it",
+        .hint = "[start|pause|resume|stop]",
+        .func = cmd_scanner,
+    },
+    {
+        .command = "restart",
+        .help = "Reboot, applying boot-only parameters",
+        .func = cmd_restart,
+    },
+};
+
+esp_err_t cyd_console_init(void)
+{
+    esp_console_repl_t *repl = NULL;
+    esp_console_repl_config_t repl_config = ESP_CONSOLE_REPL_CONFIG_DEFAULT();
+    repl_config.prompt = "cyd>";
+
+    esp_console_dev_uart_config_t uart_config = ESP_CONSOLE_DEV_UART_CONFIG_DEFAULT();
+    esp_err_t ret = esp_console_new_repl_uart(&uart_config, &repl_config, &repl);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create console: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    esp_console_register_help_command();
+    for (size_t i = 0; i < sizeof(s_commands) / sizeof(s_commands[0]); i++) {
+        ret = esp_console_cmd_register(&s_commands[i]);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to register '%s': %s", s_commands[i].command, esp_err_to_name(ret));
+            return ret;
+        }
+    }
+
+    ret = esp_console_start_repl(repl);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start console: %s", esp_err_to_name(ret));
+    }
+    return ret;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "esp_err.h"
+
+/**
+ * @brief Start the serial REPL on the default console UART
+ *
+ * Commands:
+ *   tune [name [value]]   show or change tuning parameters (see tuning.h)
+ *   tune_save             persist parameters to NVS
+ *   tune_reset            restore defaults and erase saved parameters
+ *   bench [frames [scans]] time full-screen redraws and scan sweeps
+ *   bench_tiles [frames]  list redraws with one render tile vs one per draw thread
+ *   scroll [steps [px]]   SPI bytes per list scroll step, hardware vs software
+ *   metrics [reset]       print or clear the metrics registry
+ *   aps                   print the latest published sweep
+ *   rogue [reset]         rogue AP detector counters, or forget what it learned
+ *   fingerprint [loc [name]|clear] list locations, pick the one Rec records to,
+ *                         or erase all fingerprints
+ *   scanner [start|pause|resume|stop] show or change the scan task state
+ *   restart               reboot, applying boot-only parameters
+ *
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t cyd_console_init(void);
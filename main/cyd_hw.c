@@ -1,34 +1,65 @@
 #include "cyd_hw.h"
 #include "cyd_config.h"
-#include "cyd_pins.h"
-#include "cyd_display_config.h"
-#include "cyd_calibration.h"
+#include "tuning.h"
 
 #include "driver/gpio.h"
+#include "driver/ledc.h"
+#include "driver/sdspi_host.h"
 #include "driver/spi_master.h"
 #include "esp_err.h"
 #include "esp_log.h"
+#include "esp_vfs_fat.h"
+#include "sdmmc_cmd.h"
 
+#include "esp_lcd_panel_vendor.h"
+
+/* Only the selected board's drivers are dependencies (idf_component.yml) */
+#if LCD_PANEL == CYD_PANEL_ST7796
+#include "esp_lcd_st7796.h"
+#else
 #include "esp_lcd_ili9341.h"
+#endif
+#if TOUCH_CONTROLLER == CYD_TOUCH_GT911
+#include "driver/i2c_master.h"
+#include "esp_lcd_touch_gt911.h"
+#else
 #include "esp_lcd_touch_xpt2046.h"
+#endif
 
 static const char *TAG = "cyd_hw";
 
+static cyd_rotation_t s_rotation = CYD_ROTATION_0;
+static bool s_swap_xy;
+static bool s_mirror_x = LCD_MIRROR_X;
+static bool s_mirror_y = LCD_MIRROR_Y;
+
 esp_err_t cyd_hw_init_backlight(void)
 {
-    gpio_config_t bk = {
-        .pin_bit_mask = 1ULL << CYD_PIN_NUM_BCKL,
-        .mode = GPIO_MODE_OUTPUT,
+    /* RC_FAST keeps the PWM running through automatic light sleep */
+    ledc_timer_config_t timer_cfg = {
+        .speed_mode = LEDC_LOW_SPEED_MODE,
+        .duty_resolution = BACKLIGHT_LEDC_RESOLUTION,
+        .timer_num = LEDC_TIMER_0,
+        .freq_hz = BACKLIGHT_LEDC_FREQ_HZ,
+        .clk_cfg = LEDC_USE_RC_FAST_CLK,
     };
-    esp_err_t ret = gpio_config(&bk);
+    esp_err_t ret = ledc_timer_config(&timer_cfg);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to configure backlight GPIO: %s", esp_err_to_name(ret));
+        ESP_LOGE(TAG, "Failed to configure backlight timer: %s", esp_err_to_name(ret));
         return ret;
     }
-    
-    ret = gpio_set_level(CYD_PIN_NUM_BCKL, 1);
+
+    ledc_channel_config_t channel_cfg = {
+        .gpio_num = CYD_PIN_NUM_BCKL,
+        .speed_mode = LEDC_LOW_SPEED_MODE,
+        .channel = LEDC_CHANNEL_0,
+        .timer_sel = LEDC_TIMER_0,
+        .duty = (1u << BACKLIGHT_LEDC_RESOLUTION) - 1,
+        .sleep_mode = LEDC_SLEEP_MODE_KEEP_ALIVE,
+    };
+    ret = ledc_channel_config(&channel_cfg);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to set backlight level: %s", esp_err_to_name(ret));
+        ESP_LOGE(TAG, "Failed to configure backlight channel: %s", esp_err_to_name(ret));
         return ret;
     }
     
@@ -36,6 +67,22 @@ esp_err_t cyd_hw_init_backlight(void)
     return ESP_OK;
 }
 
+esp_err_t cyd_hw_set_backlight(uint8_t percent)
+{
+    if (percent > 100) {
+        percent = 100;
+    }
+    uint32_t duty = (((1u << BACKLIGHT_LEDC_RESOLUTION) - 1) * percent) / 100;
+    esp_err_t ret = ledc_set_duty(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_0, duty);
+    if (ret == ESP_OK) {
+        ret = ledc_update_duty(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_0);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set backlight: %s", esp_err_to_name(ret));
+    }
+    return ret;
+}
+
 esp_err_t cyd_hw_init_lcd(esp_lcd_panel_io_handle_t *out_lcd_io, esp_lcd_panel_handle_t *out_panel)
 {
     if (out_panel == NULL) {
@@ -61,7 +108,7 @@ esp_err_t cyd_hw_init_lcd(esp_lcd_panel_io_handle_t *out_lcd_io, esp_lcd_panel_h
     esp_lcd_panel_io_spi_config_t lcd_io_cfg = {
         .dc_gpio_num = CYD_PIN_NUM_LCD_DC,
         .cs_gpio_num = CYD_PIN_NUM_LCD_CS,
-        .pclk_hz = 40 * 1000 * 1000,
+        .pclk_hz = tuning_get(TUNING_LCD_PCLK_HZ),
         .lcd_cmd_bits = 8,
         .lcd_param_bits = 8,
         .spi_mode = 0,
@@ -80,9 +127,13 @@ esp_err_t cyd_hw_init_lcd(esp_lcd_panel_io_handle_t *out_lcd_io, esp_lcd_panel_h
         .bits_per_pixel = 16,
     };
 
+#if LCD_PANEL == CYD_PANEL_ST7796
+    ret = esp_lcd_new_panel_st7796(lcd_io, &panel_cfg, &panel);
+#else
     ret = esp_lcd_new_panel_ili9341(lcd_io, &panel_cfg, &panel);
+#endif
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to create ILI9341 panel: %s", esp_err_to_name(ret));
+        ESP_LOGE(TAG, "Failed to create %s panel: %s", LCD_PANEL_NAME, esp_err_to_name(ret));
         return ret;
     }
     ret = esp_lcd_panel_reset(panel);
@@ -109,9 +160,8 @@ esp_err_t cyd_hw_init_lcd(esp_lcd_panel_io_handle_t *out_lcd_io, esp_lcd_panel_h
         return ret;
     }
     
-    ret = esp_lcd_panel_mirror(panel, LCD_MIRROR_X, LCD_MIRROR_Y);
+    ret = cyd_hw_set_rotation(panel, (cyd_rotation_t)LCD_ROTATION);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to mirror panel: %s", esp_err_to_name(ret));
         return ret;
     }
 
@@ -120,44 +170,159 @@ esp_err_t cyd_hw_init_lcd(esp_lcd_panel_io_handle_t *out_lcd_io, esp_lcd_panel_h
     }
     *out_panel = panel;
 
-    ESP_LOGI(TAG, "LCD initialized (%dx%d)", LCD_H_RES, LCD_V_RES);
+    ESP_LOGI(TAG, "LCD initialized (%s %dx%d, board %s)", LCD_PANEL_NAME, LCD_H_RES, LCD_V_RES, CYD_BOARD_NAME);
     return ESP_OK;
 }
 
-esp_err_t cyd_hw_init_touch(esp_lcd_touch_handle_t *out_touch)
+esp_err_t cyd_hw_set_rotation(esp_lcd_panel_handle_t panel, cyd_rotation_t rotation)
 {
-    if (out_touch == NULL) {
-        ESP_LOGE(TAG, "out_touch cannot be NULL");
+    if (panel == NULL || rotation > CYD_ROTATION_270) {
         return ESP_ERR_INVALID_ARG;
     }
-    
-    spi_bus_config_t touch_buscfg = {
-        .mosi_io_num = CYD_PIN_NUM_TCH_MOSI,
-        .miso_io_num = CYD_PIN_NUM_TCH_MISO,
-        .sclk_io_num = CYD_PIN_NUM_TCH_SCLK,
-        .quadwp_io_num = -1,
-        .quadhd_io_num = -1,
-        .max_transfer_sz = 0,
+
+    /* Each 90 degree step swaps the axes and flips one mirror bit relative
+     * to the base orientation (LCD_MIRROR_X/Y at rotation 0) */
+    bool swap_xy = (rotation == CYD_ROTATION_90 || rotation == CYD_ROTATION_270);
+    bool mirror_x = LCD_MIRROR_X;
+    bool mirror_y = LCD_MIRROR_Y;
+    if (rotation == CYD_ROTATION_90 || rotation == CYD_ROTATION_180) {
+        mirror_x = !mirror_x;
+    }
+    if (rotation == CYD_ROTATION_180 || rotation == CYD_ROTATION_270) {
+        mirror_y = !mirror_y;
+    }
+
+    /* Address mode commands are queued behind any color data still in flight */
+    esp_err_t ret = esp_lcd_panel_swap_xy(panel, swap_xy);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to swap panel axes: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    ret = esp_lcd_panel_mirror(panel, mirror_x, mirror_y);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to mirror panel: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    s_rotation = rotation;
+    s_swap_xy = swap_xy;
+    s_mirror_x = mirror_x;
+    s_mirror_y = mirror_y;
+    ESP_LOGI(TAG, "Rotation set to %d degrees", (int)rotation * 90);
+    return ESP_OK;
+}
+
+cyd_rotation_t cyd_hw_get_rotation(void)
+{
+    return s_rotation;
+}
+
+void cyd_hw_get_address_mode(bool *swap_xy, bool *mirror_x, bool *mirror_y)
+{
+    if (swap_xy) {
+        *swap_xy = s_swap_xy;
+    }
+    if (mirror_x) {
+        *mirror_x = s_mirror_x;
+    }
+    if (mirror_y) {
+        *mirror_y = s_mirror_y;
+    }
+}
+
+void cyd_hw_get_resolution(uint16_t *h_res, uint16_t *v_res)
+{
+    bool swapped = (s_rotation == CYD_ROTATION_90 || s_rotation == CYD_ROTATION_270);
+    if (h_res) {
+        *h_res = swapped ? LCD_V_RES : LCD_H_RES;
+    }
+    if (v_res) {
+        *v_res = swapped ? LCD_H_RES : LCD_V_RES;
+    }
+}
+
+#if TOUCH_CONTROLLER == CYD_TOUCH_GT911
+/* GT911: its own I2C bus */
+static esp_err_t init_touch_io(esp_lcd_panel_io_handle_t *out_io)
+{
+    i2c_master_bus_config_t bus_cfg = {
+        .i2c_port = TOUCH_I2C_PORT,
+        .sda_io_num = CYD_PIN_NUM_TCH_SDA,
+        .scl_io_num = CYD_PIN_NUM_TCH_SCL,
+        .clk_source = I2C_CLK_SRC_DEFAULT,
+        .glitch_ignore_cnt = 7,
+        .flags.enable_internal_pullup = true,
     };
-    esp_err_t ret = spi_bus_initialize(SPI3_HOST, &touch_buscfg, SPI_DMA_CH_AUTO);
+    i2c_master_bus_handle_t bus = NULL;
+    esp_err_t ret = i2c_new_master_bus(&bus_cfg, &bus);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to initialize touch SPI bus: %s", esp_err_to_name(ret));
+        ESP_LOGE(TAG, "Failed to initialize touch I2C bus: %s", esp_err_to_name(ret));
         return ret;
     }
 
-    esp_lcd_panel_io_handle_t touch_io = NULL;
+    esp_lcd_panel_io_i2c_config_t io_cfg = ESP_LCD_TOUCH_IO_I2C_GT911_CONFIG();
+    io_cfg.scl_speed_hz = TOUCH_CLK_HZ;
+    ret = esp_lcd_new_panel_io_i2c(bus, &io_cfg, out_io);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create touch IO: %s", esp_err_to_name(ret));
+    }
+    return ret;
+}
+#else
+/* XPT2046: its own SPI bus, or a second device on the LCD's */
+static esp_err_t init_touch_io(esp_lcd_panel_io_handle_t *out_io)
+{
+    esp_err_t ret;
+    if (!TOUCH_SHARES_LCD_BUS) {
+        spi_bus_config_t touch_buscfg = {
+            .mosi_io_num = CYD_PIN_NUM_TCH_MOSI,
+            .miso_io_num = CYD_PIN_NUM_TCH_MISO,
+            .sclk_io_num = CYD_PIN_NUM_TCH_SCLK,
+            .quadwp_io_num = -1,
+            .quadhd_io_num = -1,
+            .max_transfer_sz = 0,
+        };
+        ret = spi_bus_initialize(TOUCH_SPI_HOST, &touch_buscfg, SPI_DMA_CH_AUTO);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to initialize touch SPI bus: %s", esp_err_to_name(ret));
+            return ret;
+        }
+    }
+
     esp_lcd_panel_io_spi_config_t touch_io_cfg = ESP_LCD_TOUCH_IO_SPI_XPT2046_CONFIG(CYD_PIN_NUM_TCH_CS);
-    ret = esp_lcd_new_panel_io_spi((esp_lcd_spi_bus_handle_t)SPI3_HOST, &touch_io_cfg, &touch_io);
+    touch_io_cfg.pclk_hz = TOUCH_CLK_HZ;
+    ret = esp_lcd_new_panel_io_spi((esp_lcd_spi_bus_handle_t)TOUCH_SPI_HOST, &touch_io_cfg, out_io);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to create touch IO: %s", esp_err_to_name(ret));
+    }
+    return ret;
+}
+#endif
+
+esp_err_t cyd_hw_init_touch(esp_lcd_touch_handle_t *out_touch)
+{
+    if (out_touch == NULL) {
+        ESP_LOGE(TAG, "out_touch cannot be NULL");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_lcd_panel_io_handle_t touch_io = NULL;
+    esp_err_t ret = init_touch_io(&touch_io);
+    if (ret != ESP_OK) {
         return ret;
     }
 
     esp_lcd_touch_config_t touch_cfg = {
         .x_max = LCD_H_RES,
         .y_max = LCD_V_RES,
+#if TOUCH_CONTROLLER == CYD_TOUCH_GT911
+        .rst_gpio_num = CYD_PIN_NUM_TCH_RST,
+        .int_gpio_num = CYD_PIN_NUM_TCH_INT,
+#else
         .rst_gpio_num = -1,
         .int_gpio_num = GPIO_NUM_NC,
+#endif
         .levels = {.reset = 0, .interrupt = 0},
         .flags = {
             .swap_xy = TOUCH_SWAP_XY,
@@ -168,14 +333,65 @@ esp_err_t cyd_hw_init_touch(esp_lcd_touch_handle_t *out_touch)
     };
 
     esp_lcd_touch_handle_t touch = NULL;
+#if TOUCH_CONTROLLER == CYD_TOUCH_GT911
+    ret = esp_lcd_touch_new_i2c_gt911(touch_io, &touch_cfg, &touch);
+#else
     ret = esp_lcd_touch_new_spi_xpt2046(touch_io, &touch_cfg, &touch);
+#endif
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to create XPT2046 touch: %s", esp_err_to_name(ret));
+        ESP_LOGE(TAG, "Failed to create %s touch: %s", TOUCH_CONTROLLER_NAME, esp_err_to_name(ret));
         return ret;
     }
     
     *out_touch = touch;
-    ESP_LOGI(TAG, "Touch initialized");
+    ESP_LOGI(TAG, "Touch initialized (%s)", TOUCH_CONTROLLER_NAME);
+    return ESP_OK;
+}
+
+esp_err_t cyd_hw_init_sdcard(const char *mount_point)
+{
+    if (mount_point == NULL) {
+        ESP_LOGE(TAG, "mount_point cannot be NULL");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    spi_bus_config_t sd_buscfg = {
+        .mosi_io_num = CYD_PIN_NUM_SD_MOSI,
+        .miso_io_num = CYD_PIN_NUM_SD_MISO,
+        .sclk_io_num = CYD_PIN_NUM_SD_SCLK,
+        .quadwp_io_num = -1,
+        .quadhd_io_num = -1,
+        .max_transfer_sz = 4096,
+    };
+    esp_err_t ret = spi_bus_initialize(SPI3_HOST, &sd_buscfg, SPI_DMA_CH_AUTO);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to initialize SD SPI bus: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    sdmmc_host_t host = SDSPI_HOST_DEFAULT();
+    host.slot = SPI3_HOST;
+
+    sdspi_device_config_t slot_cfg = SDSPI_DEVICE_CONFIG_DEFAULT();
+    slot_cfg.gpio_cs = CYD_PIN_NUM_SD_CS;
+    slot_cfg.host_id = SPI3_HOST;
+
+    esp_vfs_fat_sdmmc_mount_config_t mount_cfg = {
+        .format_if_mount_failed = false,
+        .max_files = 4,
+        .allocation_unit_size = 16 * 1024,
+    };
+
+    sdmmc_card_t *card = NULL;
+    ret = esp_vfs_fat_sdspi_mount(mount_point, &host, &slot_cfg, &mount_cfg, &card);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to mount SD card: %s", esp_err_to_name(ret));
+        spi_bus_free(SPI3_HOST);
+        return ret;
+    }
+
+    ESP_LOGI(TAG, "SD card mounted at %s (%llu MB)", mount_point,
+             ((uint64_t)card->csd.capacity * card->csd.sector_size) / (1024 * 1024));
     return ESP_OK;
 }
 
@@ -193,10 +409,34 @@ bool cyd_hw_map_touch_coords(uint16_t *x, uint16_t *y)
     if (raw_y < TOUCH_RAW_Y_MIN) raw_y = TOUCH_RAW_Y_MIN;
     if (raw_y > TOUCH_RAW_Y_MAX) raw_y = TOUCH_RAW_Y_MAX;
 
-    *x = (uint16_t)(((raw_x - TOUCH_RAW_X_MIN) * (LCD_H_RES - 1)) /
-                    (TOUCH_RAW_X_MAX - TOUCH_RAW_X_MIN));
-    *y = (uint16_t)(((raw_y - TOUCH_RAW_Y_MIN) * (LCD_V_RES - 1)) /
-                    (TOUCH_RAW_Y_MAX - TOUCH_RAW_Y_MIN));
+    /* Map to the rotation 0 frame first; capacitive controllers already
+     * report pixels, so only resistive ones are scaled */
+    int px = raw_x;
+    int py = raw_y;
+    if (TOUCH_CONTROLLER == CYD_TOUCH_XPT2046) {
+        px = ((raw_x - TOUCH_RAW_X_MIN) * (LCD_H_RES - 1)) / (TOUCH_RAW_X_MAX - TOUCH_RAW_X_MIN);
+        py = ((raw_y - TOUCH_RAW_Y_MIN) * (LCD_V_RES - 1)) / (TOUCH_RAW_Y_MAX - TOUCH_RAW_Y_MIN);
+    }
+
+    /* Then into the rotated frame, matching cyd_hw_set_rotation() */
+    switch (s_rotation) {
+        case CYD_ROTATION_90:
+            *x = (uint16_t)py;
+            *y = (uint16_t)(LCD_H_RES - 1 - px);
+            break;
+        case CYD_ROTATION_180:
+            *x = (uint16_t)(LCD_H_RES - 1 - px);
+            *y = (uint16_t)(LCD_V_RES - 1 - py);
+            break;
+        case CYD_ROTATION_270:
+            *x = (uint16_t)(LCD_V_RES - 1 - py);
+            *y = (uint16_t)px;
+            break;
+        default:
+            *x = (uint16_t)px;
+            *y = (uint16_t)py;
+            break;
+    }
     return true;
 }
 
@@ -8,22 +8,78 @@
 #include <stdint.h>
 #include <stddef.h>
 
+/* Display rotation, applied through the panel address mode (no software rotation) */
+typedef enum {
+    CYD_ROTATION_0 = 0,
+    CYD_ROTATION_90,
+    CYD_ROTATION_180,
+    CYD_ROTATION_270,
+} cyd_rotation_t;
+
 /**
- * @brief Initialize backlight GPIO
+ * @brief Initialize the backlight PWM (LEDC), at full brightness
  * 
  * @return ESP_OK on success, error code otherwise
  */
 esp_err_t cyd_hw_init_backlight(void);
 
+/**
+ * @brief Set the backlight brightness
+ * 
+ * @param[in] percent PWM duty, 0 (off) to 100
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t cyd_hw_set_backlight(uint8_t percent);
+
 /**
  * @brief Initialize LCD display
  * 
+ * The SPI clock comes from the lcd_pclk_hz tuning parameter, so
+ * tuning_init() must run first.
+ * 
  * @param[out] out_lcd_io Optional pointer to receive LCD IO handle
  * @param[out] out_panel Pointer to receive LCD panel handle
  * @return ESP_OK on success, error code otherwise
  */
 esp_err_t cyd_hw_init_lcd(esp_lcd_panel_io_handle_t *out_lcd_io, esp_lcd_panel_handle_t *out_panel);
 
+/**
+ * @brief Rotate the display by reprogramming the panel address mode
+ * 
+ * Sets swap_xy/mirror on the panel so the controller writes rotated pixels
+ * itself. Touch mapping follows the new rotation. The caller must resize
+ * the LVGL display to cyd_hw_get_resolution() afterwards.
+ * 
+ * @param[in] panel LCD panel handle
+ * @param[in] rotation New rotation
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t cyd_hw_set_rotation(esp_lcd_panel_handle_t panel, cyd_rotation_t rotation);
+
+/**
+ * @brief Get the current display rotation
+ * 
+ * @return Current rotation
+ */
+cyd_rotation_t cyd_hw_get_rotation(void);
+
+/**
+ * @brief Get the address mode the current rotation programmed into the panel
+ *
+ * @param[out] swap_xy Axes exchanged relative to rotation 0, may be NULL
+ * @param[out] mirror_x Panel x mirror, may be NULL
+ * @param[out] mirror_y Panel y mirror, may be NULL
+ */
+void cyd_hw_get_address_mode(bool *swap_xy, bool *mirror_x, bool *mirror_y);
+
+/**
+ * @brief Get the logical resolution for the current rotation
+ * 
+ * @param[out] h_res Horizontal resolution in pixels
+ * @param[out] v_res Vertical resolution in pixels
+ */
+void cyd_hw_get_resolution(uint16_t *h_res, uint16_t *v_res);
+
 /**
  * @brief Initialize touch controller
  * 
@@ -32,9 +88,25 @@ esp_err_t cyd_hw_init_lcd(esp_lcd_panel_io_handle_t *out_lcd_io, esp_lcd_panel_h
  */
 esp_err_t cyd_hw_init_touch(esp_lcd_touch_handle_t *out_touch);
 
+/**
+ * @brief Mount the microSD card (SPI mode) as a FAT filesystem
+ * 
+ * The SD slot uses the SPI3 host. On boards where that is also the touch
+ * bus (TOUCH_SHARES_SD_BUS) this must be called instead of
+ * cyd_hw_init_touch(), not alongside it.
+ * 
+ * @param[in] mount_point VFS path to mount the card at (e.g. "/sdcard")
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t cyd_hw_init_sdcard(const char *mount_point);
+
 /**
  * @brief Map raw touch coordinates to screen coordinates
  * 
+ * Coordinates are calibrated in the panel's native orientation (resistive
+ * boards scale raw readings by TOUCH_RAW_*, capacitive ones only clamp) and
+ * then rotated to match cyd_hw_get_rotation().
+ * 
  * @param[in,out] x Pointer to X coordinate (raw in, mapped out)
  * @param[in,out] y Pointer to Y coordinate (raw in, mapped out)
  * @return true if mapping was successful, false if calibration is invalid
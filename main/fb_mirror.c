@@ -0,0 +1,370 @@
+#include "fb_mirror.h"
+#include "cyd_config.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/ringbuf.h"
+
+#include "driver/uart.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+#include <string.h>
+
+static const char *TAG = "fb_mirror";
+
+#define FB_MIRROR_TILE_W 32
+#define FB_MIRROR_TILE_H 16
+/* Sized for either orientation, since rotation swaps the resolution */
+#define FB_MIRROR_MAX_RES ((LCD_H_RES > LCD_V_RES) ? LCD_H_RES : LCD_V_RES)
+#define FB_MIRROR_TILES_X ((FB_MIRROR_MAX_RES + FB_MIRROR_TILE_W - 1) / FB_MIRROR_TILE_W)
+#define FB_MIRROR_TILES_Y ((FB_MIRROR_MAX_RES + FB_MIRROR_TILE_H - 1) / FB_MIRROR_TILE_H)
+#define FB_MIRROR_HDR_SIZE 11
+#define FB_MIRROR_MAX_PAYLOAD (FB_MIRROR_TILE_W * FB_MIRROR_TILE_H * 2)
+#define FB_MIRROR_QUEUE_SIZE (16 * 1024)
+#define FB_MIRROR_STATS_INTERVAL_MS 10000
+
+#define FB_MIRROR_ENC_RAW 0
+#define FB_MIRROR_ENC_RLE 1
+
+/* Pieces remembered per tile. Flushes are cut at draw buffer boundaries,
+ * so a tile row crossing one arrives as two pieces every time. */
+#define FB_MIRROR_TILE_SLOTS 2
+
+_Static_assert(FB_MIRROR_TILES_X <= 32, "stale tiles of a row must fit a uint32_t");
+
+/* A piece of a tile the host holds: its rectangle (see piece_key()) and the
+ * hash of its pixels. hash 0 marks a free slot. */
+typedef struct {
+    uint32_t key;
+    uint32_t hash;
+} fb_mirror_slot_t;
+
+/* Most recently sent first */
+static fb_mirror_slot_t s_slots[FB_MIRROR_TILES_Y][FB_MIRROR_TILES_X][FB_MIRROR_TILE_SLOTS];
+/* Per tile row, a bit per tile whose pixels the host missed */
+static uint32_t s_stale_rows[FB_MIRROR_TILES_Y];
+static uint8_t s_packet[FB_MIRROR_HDR_SIZE + FB_MIRROR_MAX_PAYLOAD];
+static RingbufHandle_t s_queue;
+static bool s_initialized;
+
+/* Token bucket: bytes the UART can still absorb at its line rate */
+static int64_t s_budget_bytes;
+static int64_t s_budget_stamp_us;
+
+/* Statistics, written from the flush path and read by the sender task */
+static volatile uint32_t s_stat_raw_bytes;
+static volatile uint32_t s_stat_tx_bytes;
+static volatile uint32_t s_stat_skipped;
+static volatile uint32_t s_stat_dropped;
+static volatile uint32_t s_stat_flushes;
+static volatile uint32_t s_stat_encode_us;
+
+/* Rectangle of a piece relative to its tile; pieces never cross tiles */
+static inline uint32_t piece_key(int x, int y, int w, int h)
+{
+    return (uint32_t)((x % FB_MIRROR_TILE_W) | ((y % FB_MIRROR_TILE_H) << 8) | (w << 16) | (h << 24));
+}
+
+static bool keys_overlap(uint32_t a, uint32_t b)
+{
+    int ax = a & 0xFF, ay = (a >> 8) & 0xFF, aw = (a >> 16) & 0xFF, ah = a >> 24;
+    int bx = b & 0xFF, by = (b >> 8) & 0xFF, bw = (b >> 16) & 0xFF, bh = b >> 24;
+    return ax < bx + bw && bx < ax + aw && ay < by + bh && by < ay + ah;
+}
+
+/* The host's pixels under key changed (hash != 0) or are unknown (hash 0):
+ * every other remembered piece they overlap no longer matches the host */
+static void update_slots(fb_mirror_slot_t *slots, uint32_t key, uint32_t hash)
+{
+    int kept = 0;
+    fb_mirror_slot_t keep[FB_MIRROR_TILE_SLOTS];
+    for (int i = 0; i < FB_MIRROR_TILE_SLOTS; i++) {
+        if (slots[i].hash != 0 && !keys_overlap(slots[i].key, key)) {
+            keep[kept++] = slots[i];
+        }
+    }
+    int n = 0;
+    if (hash != 0) {
+        slots[n++] = (fb_mirror_slot_t){.key = key, .hash = hash};
+    }
+    for (int i = 0; i < kept && n < FB_MIRROR_TILE_SLOTS; i++) {
+        slots[n++] = keep[i];
+    }
+    for (; n < FB_MIRROR_TILE_SLOTS; n++) {
+        slots[n].hash = 0;
+    }
+}
+
+static uint32_t hash_piece(int x, int y, int w, int h, const uint16_t *px, int stride)
+{
+    /* FNV-1a, seeded with the rectangle so different pieces of a tile never match */
+    uint32_t hash = 2166136261u;
+    hash = (hash ^ (uint32_t)((x << 16) | y)) * 16777619u;
+    hash = (hash ^ (uint32_t)((w << 16) | h)) * 16777619u;
+    for (int row = 0; row < h; row++) {
+        const uint16_t *p = px + row * stride;
+        for (int col = 0; col < w; col++) {
+            hash = (hash ^ p[col]) * 16777619u;
+        }
+    }
+    return hash | 1;
+}
+
+static size_t encode_rle(uint8_t *out, int w, int h, const uint16_t *px, int stride)
+{
+    size_t len = 0;
+    uint16_t run_px = px[0];
+    int run = 0;
+
+    for (int row = 0; row < h; row++) {
+        const uint16_t *p = px + row * stride;
+        for (int col = 0; col < w; col++) {
+            if (p[col] == run_px && run < 256) {
+                run++;
+                continue;
+            }
+            /* Bail out as soon as RLE is no smaller than raw */
+            if (len + 3 > (size_t)(w * h * 2)) {
+                return 0;
+            }
+            out[len++] = (uint8_t)(run - 1);
+            out[len++] = (uint8_t)(run_px & 0xFF);
+            out[len++] = (uint8_t)(run_px >> 8);
+            run_px = p[col];
+            run = 1;
+        }
+    }
+    if (len + 3 > (size_t)(w * h * 2)) {
+        return 0;
+    }
+    out[len++] = (uint8_t)(run - 1);
+    out[len++] = (uint8_t)(run_px & 0xFF);
+    out[len++] = (uint8_t)(run_px >> 8);
+    return len;
+}
+
+static size_t encode_raw(uint8_t *out, int w, int h, const uint16_t *px, int stride)
+{
+    for (int row = 0; row < h; row++) {
+        memcpy(out + row * w * 2, px + row * stride, (size_t)w * 2);
+    }
+    return (size_t)(w * h * 2);
+}
+
+static bool take_budget(size_t bytes)
+{
+    int64_t now = esp_timer_get_time();
+    /* 10 bits per byte on the wire (8N1) */
+    s_budget_bytes += (now - s_budget_stamp_us) * (FB_MIRROR_BAUD / 10) / 1000000;
+    s_budget_stamp_us = now;
+    if (s_budget_bytes > FB_MIRROR_QUEUE_SIZE) {
+        s_budget_bytes = FB_MIRROR_QUEUE_SIZE;
+    }
+    if (s_budget_bytes < (int64_t)bytes) {
+        return false;
+    }
+    s_budget_bytes -= (int64_t)bytes;
+    return true;
+}
+
+static void send_piece(int tx, int ty, int x, int y, int w, int h, const uint16_t *px, int stride)
+{
+    fb_mirror_slot_t *slots = s_slots[ty][tx];
+    uint32_t key = piece_key(x, y, w, h);
+    uint32_t hash = hash_piece(x, y, w, h, px, stride);
+    for (int i = 0; i < FB_MIRROR_TILE_SLOTS; i++) {
+        if (slots[i].hash == hash && slots[i].key == key) {
+            s_stat_skipped++;
+            return;
+        }
+    }
+
+    uint8_t *payload = s_packet + FB_MIRROR_HDR_SIZE;
+    uint8_t enc = FB_MIRROR_ENC_RLE;
+    size_t len = encode_rle(payload, w, h, px, stride);
+    if (len == 0) {
+        enc = FB_MIRROR_ENC_RAW;
+        len = encode_raw(payload, w, h, px, stride);
+    }
+
+    s_packet[0] = 'F';
+    s_packet[1] = 'M';
+    s_packet[2] = enc;
+    s_packet[3] = (uint8_t)(x & 0xFF);
+    s_packet[4] = (uint8_t)(x >> 8);
+    s_packet[5] = (uint8_t)(y & 0xFF);
+    s_packet[6] = (uint8_t)(y >> 8);
+    s_packet[7] = (uint8_t)w;
+    s_packet[8] = (uint8_t)h;
+    s_packet[9] = (uint8_t)(len & 0xFF);
+    s_packet[10] = (uint8_t)(len >> 8);
+
+    size_t total = FB_MIRROR_HDR_SIZE + len;
+    if (!take_budget(total) || xRingbufferSend(s_queue, s_packet, total, 0) != pdTRUE) {
+        /* Host now holds stale pixels for this piece */
+        update_slots(slots, key, 0);
+        __atomic_fetch_or(&s_stale_rows[ty], 1u << tx, __ATOMIC_RELAXED);
+        s_stat_dropped++;
+        return;
+    }
+
+    update_slots(slots, key, hash);
+    s_stat_tx_bytes += (uint32_t)total;
+}
+
+void fb_mirror_push(int x1, int y1, int x2, int y2, const uint16_t *px)
+{
+    if (!s_initialized || !px) {
+        return;
+    }
+
+    int64_t start = esp_timer_get_time();
+    int stride = x2 - x1 + 1;
+
+    /* Walk the screen-aligned tiles the area overlaps */
+    for (int ty = y1 / FB_MIRROR_TILE_H; ty <= y2 / FB_MIRROR_TILE_H; ty++) {
+        int py1 = ty * FB_MIRROR_TILE_H;
+        int py2 = py1 + FB_MIRROR_TILE_H - 1;
+        if (py1 < y1) py1 = y1;
+        if (py2 > y2) py2 = y2;
+
+        for (int tx = x1 / FB_MIRROR_TILE_W; tx <= x2 / FB_MIRROR_TILE_W; tx++) {
+            int px1 = tx * FB_MIRROR_TILE_W;
+            int px2 = px1 + FB_MIRROR_TILE_W - 1;
+            if (px1 < x1) px1 = x1;
+            if (px2 > x2) px2 = x2;
+
+            const uint16_t *piece = px + (py1 - y1) * stride + (px1 - x1);
+            send_piece(tx, ty, px1, py1, px2 - px1 + 1, py2 - py1 + 1, piece, stride);
+        }
+    }
+
+    s_stat_raw_bytes += (uint32_t)(stride * (y2 - y1 + 1) * 2);
+    s_stat_flushes++;
+    s_stat_encode_us += (uint32_t)(esp_timer_get_time() - start);
+}
+
+void fb_mirror_reset(void)
+{
+    memset(s_slots, 0, sizeof(s_slots));
+    for (int ty = 0; ty < FB_MIRROR_TILES_Y; ty++) {
+        __atomic_store_n(&s_stale_rows[ty], 0, __ATOMIC_RELAXED);
+    }
+}
+
+int fb_mirror_take_stale_areas(fb_mirror_area_t *out, int max)
+{
+    int count = 0;
+    for (int ty = 0; ty < FB_MIRROR_TILES_Y && count < max; ty++) {
+        uint32_t row = __atomic_exchange_n(&s_stale_rows[ty], 0, __ATOMIC_RELAXED);
+        /* One area per run of stale tiles */
+        int tx = 0;
+        while (row >> tx) {
+            if (!(row & (1u << tx))) {
+                tx++;
+                continue;
+            }
+            if (count == max) {
+                /* Out of room: the rest of the row waits for the next call */
+                __atomic_fetch_or(&s_stale_rows[ty], row & ~((1u << tx) - 1), __ATOMIC_RELAXED);
+                break;
+            }
+            int run = tx;
+            while (run + 1 < 32 && (row & (1u << (run + 1)))) {
+                run++;
+            }
+            out[count].x1 = tx * FB_MIRROR_TILE_W;
+            out[count].y1 = ty * FB_MIRROR_TILE_H;
+            out[count].x2 = (run + 1) * FB_MIRROR_TILE_W - 1;
+            out[count].y2 = (ty + 1) * FB_MIRROR_TILE_H - 1;
+            count++;
+            tx = run + 1;
+        }
+    }
+    return count;
+}
+
+static void log_stats(void)
+{
+    uint32_t raw = s_stat_raw_bytes;
+    uint32_t tx = s_stat_tx_bytes;
+    uint32_t flushes = s_stat_flushes;
+
+    ESP_LOGI(TAG, "raw %lu B, sent %lu B (ratio %lu.%02lu:1), skipped %lu, dropped %lu, "
+             "encode %lu us/flush",
+             (unsigned long)raw, (unsigned long)tx,
+             (unsigned long)(tx ? raw / tx : 0), (unsigned long)(tx ? (raw % tx) * 100 / tx : 0),
+             (unsigned long)s_stat_skipped, (unsigned long)s_stat_dropped,
+             (unsigned long)(flushes ? s_stat_encode_us / flushes : 0));
+}
+
+static void fb_mirror_task(void *pvParameters)
+{
+    (void)pvParameters;
+    int64_t last_stats_us = esp_timer_get_time();
+
+    while (1) {
+        size_t len = 0;
+        void *item = xRingbufferReceive(s_queue, &len, pdMS_TO_TICKS(FB_MIRROR_STATS_INTERVAL_MS));
+        if (item) {
+            uart_write_bytes(FB_MIRROR_UART_NUM, item, len);
+            vRingbufferReturnItem(s_queue, item);
+        }
+
+        int64_t now = esp_timer_get_time();
+        if (now - last_stats_us >= FB_MIRROR_STATS_INTERVAL_MS * 1000LL) {
+            log_stats();
+            last_stats_us = now;
+        }
+    }
+}
+
+esp_err_t fb_mirror_init(void)
+{
+    if (s_initialized) {
+        return ESP_OK;
+    }
+
+    uart_config_t uart_cfg = {
+        .baud_rate = FB_MIRROR_BAUD,
+        .data_bits = UART_DATA_8_BITS,
+        .parity = UART_PARITY_DISABLE,
+        .stop_bits = UART_STOP_BITS_1,
+        .flow_ctrl = UART_HW_FLOWCTRL_DISABLE,
+        .source_clk = UART_SCLK_DEFAULT,
+    };
+    esp_err_t ret = uart_driver_install(FB_MIRROR_UART_NUM, 256, 4096, 0, NULL, 0);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to install UART driver: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    ret = uart_param_config(FB_MIRROR_UART_NUM, &uart_cfg);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to configure UART: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    ret = uart_set_pin(FB_MIRROR_UART_NUM, CYD_PIN_NUM_MIRROR_TX, UART_PIN_NO_CHANGE,
+                       UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set UART pins: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    s_queue = xRingbufferCreate(FB_MIRROR_QUEUE_SIZE, RINGBUF_TYPE_NOSPLIT);
+    if (!s_queue) {
+        ESP_LOGE(TAG, "Failed to create mirror queue");
+        return ESP_ERR_NO_MEM;
+    }
+
+    /* Low priority: the sender only ever uses spare time */
+    if (xTaskCreate(fb_mirror_task, "fb_mirror", 3072, NULL, 2, NULL) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create mirror task");
+        return ESP_FAIL;
+    }
+
+    s_budget_stamp_us = esp_timer_get_time();
+    s_initialized = true;
+    ESP_LOGI(TAG, "Mirroring display on UART%d (%d baud)", FB_MIRROR_UART_NUM, FB_MIRROR_BAUD);
+    return ESP_OK;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Framebuffer mirror: streams every flushed area to a host viewer over UART.
+ *
+ * Areas are cut into screen-aligned tiles. A tile piece whose pixels match
+ * what was last sent for the same rectangle is skipped (a couple of pieces
+ * are remembered per tile, since draw buffer stripes split some tile rows); the rest are RLE encoded
+ * (or sent raw when RLE does not pay off). Packet layout, little-endian:
+ *
+ *   'F' 'M' | enc u8 | x u16 | y u16 | w u8 | h u8 | len u16 | payload[len]
+ *
+ * enc 0: raw RGB565 pixels, row-major
+ * enc 1: RLE runs of (count-1 u8, RGB565 u16)
+ *
+ * See tools/fb_mirror_viewer.py for the host side.
+ */
+
+/**
+ * @brief Set up the mirror UART, queue and sender task
+ * 
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t fb_mirror_init(void);
+
+/**
+ * @brief Queue a flushed area for the host viewer
+ * 
+ * Never blocks: tiles that do not fit in the byte budget or the queue are
+ * dropped and marked for resend. Must be called with the pixels as rendered
+ * by LVGL, before panel color correction.
+ * 
+ * @param x1 Left edge (inclusive)
+ * @param y1 Top edge (inclusive)
+ * @param x2 Right edge (inclusive)
+ * @param y2 Bottom edge (inclusive)
+ * @param px RGB565 pixels of the area, row-major
+ */
+void fb_mirror_push(int x1, int y1, int x2, int y2, const uint16_t *px);
+
+/**
+ * @brief Forget what the host has, e.g. after a rotation change
+ * 
+ * Every tile is sent again on its next flush.
+ */
+void fb_mirror_reset(void);
+
+/* Screen area, edges inclusive */
+typedef struct {
+    int x1;
+    int y1;
+    int x2;
+    int y2;
+} fb_mirror_area_t;
+
+/**
+ * @brief Take the areas of tiles the host missed since the last call
+ *
+ * One area per run of such tiles in a tile row; areas may extend past the
+ * screen edge. Invalidate them so the dropped tiles are flushed and sent
+ * again. Areas that do not fit in out are kept for the next call.
+ *
+ * @param[out] out Stale areas
+ * @param max Capacity of out
+ * @return Number of areas stored in out
+ */
+int fb_mirror_take_stale_areas(fb_mirror_area_t *out, int max);
@@ -0,0 +1,539 @@
+#include "fingerprint.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "esp_timer.h"
+#include "nvs.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "fingerprint";
+
+#define FP_PARTITION_LABEL "fprint"
+#define FP_PARTITION_SUBTYPE 0x40
+#define FP_NVS_NAMESPACE "fingerprint"
+#define FP_NVS_DICT_KEY "dict"
+
+#define FP_DICT_MAX 512        /* Distinct BSSIDs across all fingerprints */
+#define FP_RECORD_APS 14       /* Strongest APs kept per fingerprint */
+#define FP_RSSI_FLOOR (-100)   /* Value assumed for an AP missing from a vector */
+#define FP_RSSI_CEIL (-20)
+#define FP_RECORD_MAGIC 0x46
+#define FP_RECORD_COMMIT 0xA5
+#define FP_LIVE_MAX 32
+
+/* One fingerprint as stored in flash. Entries are sorted by dictionary
+ * index so two vectors can be compared with a single merge pass. The commit
+ * byte is written last; records torn by a power loss are skipped. */
+typedef struct __attribute__((packed)) {
+    uint8_t magic;
+    uint8_t count;
+    char label[FINGERPRINT_LABEL_LEN];
+    struct __attribute__((packed)) {
+        uint16_t idx;
+        int8_t rssi;
+    } aps[FP_RECORD_APS];
+    uint8_t reserved[3];
+    uint8_t commit;
+} fp_record_t;
+
+_Static_assert(sizeof(fp_record_t) == 64, "fingerprint record must stay 64 bytes");
+
+typedef struct {
+    uint16_t idx;
+    int8_t rssi;
+} fp_entry_t;
+
+static const esp_partition_t *s_partition;
+static const fp_record_t *s_records;  /* Memory-mapped partition */
+static esp_partition_mmap_handle_t s_map_handle;
+static uint32_t s_record_count;
+static uint32_t s_record_capacity;
+
+static uint8_t s_dict[FP_DICT_MAX][6];
+static uint16_t s_dict_sorted[FP_DICT_MAX];  /* Dictionary indexes ordered by BSSID */
+static uint16_t s_dict_count;
+
+static char s_location[FINGERPRINT_LABEL_LEN];  /* Label Rec stores under, "" until selected */
+
+static SemaphoreHandle_t s_lock;
+
+static bool record_valid(const fp_record_t *rec)
+{
+    return rec->magic == FP_RECORD_MAGIC && rec->commit == FP_RECORD_COMMIT;
+}
+
+static int8_t quantize_rssi(int dbm)
+{
+    if (dbm < FP_RSSI_FLOOR) return FP_RSSI_FLOOR;
+    if (dbm > FP_RSSI_CEIL) return FP_RSSI_CEIL;
+    return (int8_t)dbm;
+}
+
+static int dict_find(const uint8_t bssid[6], int *insert_pos)
+{
+    int lo = 0;
+    int hi = s_dict_count;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        int cmp = memcmp(s_dict[s_dict_sorted[mid]], bssid, 6);
+        if (cmp == 0) {
+            return s_dict_sorted[mid];
+        }
+        if (cmp < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (insert_pos) {
+        *insert_pos = lo;
+    }
+    return -1;
+}
+
+static int dict_add(const uint8_t bssid[6])
+{
+    int pos = 0;
+    int idx = dict_find(bssid, &pos);
+    if (idx >= 0) {
+        return idx;
+    }
+    if (s_dict_count >= FP_DICT_MAX) {
+        return -1;
+    }
+
+    idx = s_dict_count++;
+    memcpy(s_dict[idx], bssid, 6);
+    memmove(&s_dict_sorted[pos + 1], &s_dict_sorted[pos], (size_t)(idx - pos) * sizeof(s_dict_sorted[0]));
+    s_dict_sorted[pos] = (uint16_t)idx;
+    return idx;
+}
+
+static void dict_rebuild_index(void)
+{
+    /* Insertion sort; runs at boot and after a failed save */
+    for (int i = 0; i < s_dict_count; i++) {
+        int j = i;
+        while (j > 0 && memcmp(s_dict[s_dict_sorted[j - 1]], s_dict[i], 6) > 0) {
+            s_dict_sorted[j] = s_dict_sorted[j - 1];
+            j--;
+        }
+        s_dict_sorted[j] = (uint16_t)i;
+    }
+}
+
+static esp_err_t dict_save(void)
+{
+    nvs_handle_t nvs;
+    esp_err_t ret = nvs_open(FP_NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    if (s_dict_count > 0) {
+        ret = nvs_set_blob(nvs, FP_NVS_DICT_KEY, s_dict, (size_t)s_dict_count * 6);
+    } else {
+        ret = nvs_erase_key(nvs, FP_NVS_DICT_KEY);
+        if (ret == ESP_ERR_NVS_NOT_FOUND) {
+            ret = ESP_OK;
+        }
+    }
+    if (ret == ESP_OK) {
+        ret = nvs_commit(nvs);
+    }
+    nvs_close(nvs);
+    return ret;
+}
+
+static void sort_entries(fp_entry_t *entries, int count)
+{
+    for (int i = 1; i < count; i++) {
+        fp_entry_t e = entries[i];
+        int j = i;
+        while (j > 0 && entries[j - 1].idx > e.idx) {
+            entries[j] = entries[j - 1];
+            j--;
+        }
+        entries[j] = e;
+    }
+}
+
+static inline uint32_t sq(int v)
+{
+    return (uint32_t)(v * v);
+}
+
+/* Squared euclidean distance between a live vector and a stored record, with
+ * missing APs at FP_RSSI_FLOOR. live_suffix[i] holds the penalty of live
+ * entries i..n-1 so the tail after the record ends costs O(1). Returns as
+ * soon as the partial sum passes limit, since every term is non-negative. */
+static uint32_t sparse_distance(const fp_entry_t *live, int live_count, const uint32_t *live_suffix,
+                                const fp_record_t *rec, uint32_t limit)
+{
+    uint32_t dist = 0;
+    int i = 0;
+    int j = 0;
+
+    while (i < live_count && j < rec->count) {
+        uint16_t ridx = rec->aps[j].idx;
+        if (live[i].idx == ridx) {
+            dist += sq(live[i].rssi - rec->aps[j].rssi);
+            i++;
+            j++;
+        } else if (live[i].idx < ridx) {
+            dist += sq(live[i].rssi - FP_RSSI_FLOOR);
+            i++;
+        } else {
+            dist += sq(rec->aps[j].rssi - FP_RSSI_FLOOR);
+            j++;
+        }
+        if (dist > limit) {
+            return dist;
+        }
+    }
+    for (; j < rec->count; j++) {
+        dist += sq(rec->aps[j].rssi - FP_RSSI_FLOOR);
+    }
+    return dist + live_suffix[i];
+}
+
+esp_err_t fingerprint_init(void)
+{
+    if (s_records) {
+        return ESP_OK;
+    }
+
+    if (!s_lock) {
+        s_lock = xSemaphoreCreateMutex();
+        if (!s_lock) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    s_partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, FP_PARTITION_SUBTYPE, FP_PARTITION_LABEL);
+    if (!s_partition) {
+        ESP_LOGE(TAG, "Partition '%s' not found", FP_PARTITION_LABEL);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    const void *map = NULL;
+    esp_err_t ret = esp_partition_mmap(s_partition, 0, s_partition->size, ESP_PARTITION_MMAP_DATA,
+                                       &map, &s_map_handle);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to map partition: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    s_records = (const fp_record_t *)map;
+    s_record_capacity = s_partition->size / sizeof(fp_record_t);
+
+    /* Records are appended, so the first erased slot ends the database */
+    s_record_count = 0;
+    while (s_record_count < s_record_capacity && s_records[s_record_count].magic != 0xFF) {
+        s_record_count++;
+    }
+
+    nvs_handle_t nvs;
+    if (nvs_open(FP_NVS_NAMESPACE, NVS_READONLY, &nvs) == ESP_OK) {
+        size_t len = sizeof(s_dict);
+        if (nvs_get_blob(nvs, FP_NVS_DICT_KEY, s_dict, &len) == ESP_OK) {
+            s_dict_count = (uint16_t)(len / 6);
+        }
+        nvs_close(nvs);
+    }
+    dict_rebuild_index();
+
+    ESP_LOGI(TAG, "%lu fingerprints (capacity %lu), %u BSSIDs",
+             (unsigned long)s_record_count, (unsigned long)s_record_capacity, s_dict_count);
+    return ESP_OK;
+}
+
+esp_err_t fingerprint_record(const char *label, const wifi_ap_info_t *ap_list, uint16_t ap_count)
+{
+    if (!s_records) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (!label || (!ap_list && ap_count > 0)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+
+    if (s_record_count >= s_record_capacity) {
+        xSemaphoreGive(s_lock);
+        ESP_LOGE(TAG, "Fingerprint database is full");
+        return ESP_ERR_NO_MEM;
+    }
+
+    fp_record_t rec;
+    memset(&rec, 0xFF, sizeof(rec));
+    rec.magic = FP_RECORD_MAGIC;
+    strncpy(rec.label, label, sizeof(rec.label) - 1);
+    rec.label[sizeof(rec.label) - 1] = '\0';
+
+    /* Keep the strongest APs; ap_list is already ranked by smoothed RSSI */
+    fp_entry_t entries[FP_RECORD_APS];
+    int count = 0;
+    uint16_t dict_before = s_dict_count;
+    for (int i = 0; i < ap_count && count < FP_RECORD_APS; i++) {
+        int idx = dict_add(ap_list[i].bssid);
+        if (idx < 0) {
+            ESP_LOGW(TAG, "BSSID dictionary full, dropping AP");
+            continue;
+        }
+        entries[count].idx = (uint16_t)idx;
+        entries[count].rssi = quantize_rssi(rssi_filter_to_dbm(ap_list[i].rssi_q4));
+        count++;
+    }
+    sort_entries(entries, count);
+
+    rec.count = (uint8_t)count;
+    for (int i = 0; i < count; i++) {
+        rec.aps[i].idx = entries[i].idx;
+        rec.aps[i].rssi = entries[i].rssi;
+    }
+
+    /* The dictionary must be durable before any record refers to new entries */
+    esp_err_t ret = ESP_OK;
+    if (s_dict_count != dict_before) {
+        ret = dict_save();
+        if (ret != ESP_OK) {
+            /* Forget the new entries: a later record that adds none would
+             * skip the save and refer to indexes only this boot knows */
+            ESP_LOGE(TAG, "Failed to save BSSID dictionary: %s", esp_err_to_name(ret));
+            s_dict_count = dict_before;
+            dict_rebuild_index();
+        }
+    }
+
+    if (ret == ESP_OK) {
+        size_t offset = s_record_count * sizeof(fp_record_t);
+        ret = esp_partition_write(s_partition, offset, &rec, sizeof(rec) - 1);
+        if (ret == ESP_OK) {
+            uint8_t commit = FP_RECORD_COMMIT;
+            ret = esp_partition_write(s_partition, offset + sizeof(rec) - 1, &commit, 1);
+        }
+        if (ret == ESP_OK) {
+            s_record_count++;
+        } else {
+            ESP_LOGE(TAG, "Failed to write fingerprint: %s", esp_err_to_name(ret));
+        }
+    }
+
+    xSemaphoreGive(s_lock);
+
+    if (ret == ESP_OK) {
+        ESP_LOGI(TAG, "Recorded '%s' with %d APs (%lu stored)", rec.label, count,
+                 (unsigned long)s_record_count);
+    }
+    return ret;
+}
+
+esp_err_t fingerprint_match(const wifi_ap_info_t *ap_list, uint16_t ap_count, fingerprint_match_t *out_match)
+{
+    if (!s_records) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (!out_match || (!ap_list && ap_count > 0)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    int64_t start = esp_timer_get_time();
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+
+    /* Live scan as a sparse vector over the dictionary; BSSIDs never recorded
+     * cost the same against every fingerprint and are left out */
+    fp_entry_t live[FP_LIVE_MAX];
+    int live_count = 0;
+    for (int i = 0; i < ap_count && live_count < FP_LIVE_MAX; i++) {
+        int idx = dict_find(ap_list[i].bssid, NULL);
+        if (idx >= 0) {
+            live[live_count].idx = (uint16_t)idx;
+            live[live_count].rssi = quantize_rssi(rssi_filter_to_dbm(ap_list[i].rssi_q4));
+            live_count++;
+        }
+    }
+    if (live_count == 0 || s_record_count == 0) {
+        xSemaphoreGive(s_lock);
+        return ESP_ERR_NOT_FOUND;
+    }
+    sort_entries(live, live_count);
+
+    uint32_t live_suffix[FP_LIVE_MAX + 1];
+    live_suffix[live_count] = 0;
+    for (int i = live_count - 1; i >= 0; i--) {
+        live_suffix[i] = live_suffix[i + 1] + sq(live[i].rssi - FP_RSSI_FLOOR);
+    }
+
+    /* k nearest, kept sorted by distance */
+    uint32_t best_dist[FINGERPRINT_K];
+    uint32_t best_rec[FINGERPRINT_K];
+    int best_count = 0;
+
+    for (uint32_t r = 0; r < s_record_count; r++) {
+        const fp_record_t *rec = &s_records[r];
+        if (!record_valid(rec)) {
+            continue;
+        }
+        uint32_t limit = (best_count == FINGERPRINT_K) ? best_dist[FINGERPRINT_K - 1] : UINT32_MAX;
+        uint32_t dist = sparse_distance(live, live_count, live_suffix, rec, limit);
+        if (dist >= limit) {
+            continue;
+        }
+
+        int pos = (best_count < FINGERPRINT_K) ? best_count++ : FINGERPRINT_K - 1;
+        while (pos > 0 && best_dist[pos - 1] > dist) {
+            best_dist[pos] = best_dist[pos - 1];
+            best_rec[pos] = best_rec[pos - 1];
+            pos--;
+        }
+        best_dist[pos] = dist;
+        best_rec[pos] = r;
+    }
+
+    /* Majority vote among the neighbours, nearest first on ties */
+    int winner = -1;
+    int winner_votes = 0;
+    for (int i = 0; i < best_count; i++) {
+        int votes = 0;
+        for (int j = 0; j < best_count; j++) {
+            if (strncmp(s_records[best_rec[i]].label, s_records[best_rec[j]].label,
+                        FINGERPRINT_LABEL_LEN) == 0) {
+                votes++;
+            }
+        }
+        if (votes > winner_votes) {
+            winner = i;
+            winner_votes = votes;
+        }
+    }
+
+    if (winner >= 0) {
+        memcpy(out_match->label, s_records[best_rec[winner]].label, FINGERPRINT_LABEL_LEN);
+        out_match->label[FINGERPRINT_LABEL_LEN - 1] = '\0';
+        out_match->distance = best_dist[winner];
+        out_match->votes = (uint8_t)winner_votes;
+    }
+
+    xSemaphoreGive(s_lock);
+
+    if (winner < 0) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    out_match->elapsed_us = (uint32_t)(esp_timer_get_time() - start);
+    return ESP_OK;
+}
+
+uint32_t fingerprint_count(void)
+{
+    return s_record_count;
+}
+
+esp_err_t fingerprint_clear(void)
+{
+    if (!s_records) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+
+    esp_err_t ret = esp_partition_erase_range(s_partition, 0, s_partition->size);
+    if (ret == ESP_OK) {
+        s_record_count = 0;
+        s_dict_count = 0;
+        s_location[0] = '\0';
+        ret = dict_save();
+    }
+
+    xSemaphoreGive(s_lock);
+
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to clear fingerprints: %s", esp_err_to_name(ret));
+    }
+    return ret;
+}
+
+esp_err_t fingerprint_set_location(const char *label)
+{
+    if (!s_records) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+
+    if (label && label[0] != '\0') {
+        strncpy(s_location, label, sizeof(s_location) - 1);
+        s_location[sizeof(s_location) - 1] = '\0';
+    } else {
+        /* One past the highest auto-named location, so a name is never reused
+         * even if the labels in between were typed by hand */
+        unsigned long next = 1;
+        for (uint32_t r = 0; r < s_record_count; r++) {
+            const fp_record_t *rec = &s_records[r];
+            char *end = NULL;
+            if (!record_valid(rec) || rec->label[0] != 'P') {
+                continue;
+            }
+            unsigned long n = strtoul(&rec->label[1], &end, 10);
+            if (end != &rec->label[1] && *end == '\0' && n >= next) {
+                next = n + 1;
+            }
+        }
+        snprintf(s_location, sizeof(s_location), "P%03lu", next);
+    }
+
+    xSemaphoreGive(s_lock);
+
+    ESP_LOGI(TAG, "Recording location '%s'", s_location);
+    return ESP_OK;
+}
+
+void fingerprint_get_location(char label[FINGERPRINT_LABEL_LEN])
+{
+    if (!s_lock) {
+        label[0] = '\0';
+        return;
+    }
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    memcpy(label, s_location, FINGERPRINT_LABEL_LEN);
+    xSemaphoreGive(s_lock);
+}
+
+int fingerprint_list_locations(fingerprint_location_t *out, int max)
+{
+    if (!s_records || !out) {
+        return 0;
+    }
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+
+    /* Linear in records times locations; only the console lists them */
+    int count = 0;
+    for (uint32_t r = 0; r < s_record_count; r++) {
+        const fp_record_t *rec = &s_records[r];
+        if (!record_valid(rec)) {
+            continue;
+        }
+        int i = 0;
+        while (i < count && strncmp(out[i].label, rec->label, FINGERPRINT_LABEL_LEN) != 0) {
+            i++;
+        }
+        if (i < count) {
+            out[i].samples++;
+        } else if (count < max) {
+            memcpy(out[count].label, rec->label, FINGERPRINT_LABEL_LEN);
+            out[count].label[FINGERPRINT_LABEL_LEN - 1] = '\0';
+            out[count].samples = 1;
+            count++;
+        }
+    }
+
+    xSemaphoreGive(s_lock);
+    return count;
+}
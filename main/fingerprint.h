@@ -0,0 +1,100 @@
+#pragma once
+
+#include "esp_err.h"
+#include "wifi_scanner.h"
+#include <stdint.h>
+
+#define FINGERPRINT_LABEL_LEN 16  /* Including the terminator */
+#define FINGERPRINT_K 3           /* Neighbours that vote on a match */
+
+/* Result of matching a live scan against the database */
+typedef struct {
+    char label[FINGERPRINT_LABEL_LEN];
+    uint32_t distance;   /* Squared distance to the nearest fingerprint with this label */
+    uint8_t votes;       /* Neighbours out of FINGERPRINT_K that carry this label */
+    uint32_t elapsed_us; /* Time spent matching */
+} fingerprint_match_t;
+
+/* A stored location and how many fingerprints carry its label */
+typedef struct {
+    char label[FINGERPRINT_LABEL_LEN];
+    uint32_t samples;
+} fingerprint_location_t;
+
+/**
+ * @brief Load the BSSID dictionary and index the fingerprint partition
+ *
+ * Requires NVS to be initialized.
+ *
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t fingerprint_init(void);
+
+/**
+ * @brief Store the current scan as a labeled fingerprint
+ *
+ * The strongest APs are quantized to int8 dBm over the BSSID dictionary and
+ * appended to the fingerprint partition.
+ *
+ * @param[in] label Location label (truncated to FINGERPRINT_LABEL_LEN - 1)
+ * @param[in] ap_list Scan results
+ * @param[in] ap_count Number of scan results
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if the database or dictionary is full
+ */
+esp_err_t fingerprint_record(const char *label, const wifi_ap_info_t *ap_list, uint16_t ap_count);
+
+/**
+ * @brief Find the location whose fingerprints are nearest to a scan
+ *
+ * k-NN over all stored fingerprints with a sparse, sorted-index distance kernel.
+ *
+ * @param[in] ap_list Scan results
+ * @param[in] ap_count Number of scan results
+ * @param[out] out_match Best location
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if nothing could be matched
+ */
+esp_err_t fingerprint_match(const wifi_ap_info_t *ap_list, uint16_t ap_count, fingerprint_match_t *out_match);
+
+/**
+ * @brief Get the number of stored fingerprints
+ *
+ * @return Fingerprint count
+ */
+uint32_t fingerprint_count(void);
+
+/**
+ * @brief Select the location that recordings are stored under
+ *
+ * Several recordings under one label give the k-NN vote more than one
+ * sample per place. The selection is not persisted.
+ *
+ * @param[in] label Location label (truncated to FINGERPRINT_LABEL_LEN - 1),
+ *                  NULL or "" for a new one named after the highest stored Pnnn
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE before fingerprint_init()
+ */
+esp_err_t fingerprint_set_location(const char *label);
+
+/**
+ * @brief Get the location that recordings are stored under
+ *
+ * @param[out] label Selected label, "" if none has been selected yet
+ */
+void fingerprint_get_location(char label[FINGERPRINT_LABEL_LEN]);
+
+/**
+ * @brief List the stored locations in order of first recording
+ *
+ * @param[out] out Locations
+ * @param max Capacity of out
+ * @return Number of locations stored in out; any past max are left out
+ */
+int fingerprint_list_locations(fingerprint_location_t *out, int max);
+
+/**
+ * @brief Erase all fingerprints and the BSSID dictionary
+ *
+ * Also drops the selected location.
+ *
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t fingerprint_clear(void);
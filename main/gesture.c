@@ -0,0 +1,249 @@
+#include "gesture.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define VELOCITY_MIN_SAMPLES 3  /* Fewer than this and the fit is just noise */
+
+typedef enum {
+    PHASE_IDLE = 0,
+    PHASE_PRESSED,   /* In contact, within the slop */
+    PHASE_DRAGGING,  /* Moved past the slop */
+    PHASE_HELD,      /* Long press fired; movement no longer matters */
+} gesture_phase_t;
+
+static const char *const s_type_names[GESTURE_TYPE_COUNT] = {
+    [GESTURE_PRESS] = "press",
+    [GESTURE_DRAG_START] = "drag_start",
+    [GESTURE_LONG_PRESS] = "long_press",
+    [GESTURE_TAP] = "tap",
+    [GESTURE_SWIPE] = "swipe",
+    [GESTURE_FLING] = "fling",
+    [GESTURE_RELEASE] = "release",
+};
+
+void gesture_init(gesture_t *g, const gesture_config_t *config)
+{
+    memset(g, 0, sizeof(*g));
+    g->config = *config;
+}
+
+static int16_t median3(const int16_t v[3])
+{
+    int16_t a = v[0], b = v[1], c = v[2];
+    if (a > b) {
+        int16_t t = a; a = b; b = t;
+    }
+    /* a <= b: the median is b unless c is below or above both */
+    if (c < b) {
+        b = (c > a) ? c : a;
+    }
+    return b;
+}
+
+static const gesture_sample_t *newest(const gesture_t *g)
+{
+    return &g->history[(g->history_count - 1) % GESTURE_HISTORY];
+}
+
+/* Least-squares slope of x(t) and y(t) over the newest samples in the window */
+static void fit_velocity(const gesture_t *g, float *vx, float *vy)
+{
+    *vx = 0.0f;
+    *vy = 0.0f;
+    if (g->history_count == 0) {
+        return;
+    }
+
+    /* Times in ms relative to the newest sample keep the sums small for float */
+    const gesture_sample_t *last = newest(g);
+    int64_t window_us = (int64_t)g->config.velocity_window_ms * 1000;
+    uint32_t available = g->history_count < GESTURE_HISTORY ? g->history_count : GESTURE_HISTORY;
+    float n = 0, st = 0, sx = 0, sy = 0, stt = 0, stx = 0, sty = 0;
+    for (uint32_t i = 0; i < available; i++) {
+        const gesture_sample_t *s = &g->history[(g->history_count - 1 - i) % GESTURE_HISTORY];
+        if (last->time_us - s->time_us > window_us) {
+            break;
+        }
+        float t = (float)(s->time_us - last->time_us) / 1000.0f;
+        n += 1;
+        st += t;
+        sx += s->x;
+        sy += s->y;
+        stt += t * t;
+        stx += t * s->x;
+        sty += t * s->y;
+    }
+
+    float den = n * stt - st * st;
+    if (n < VELOCITY_MIN_SAMPLES || den <= 0.0f) {
+        return;
+    }
+    *vx = (n * stx - st * sx) / den * 1000.0f;
+    *vy = (n * sty - st * sy) / den * 1000.0f;
+}
+
+static gesture_dir_t main_direction(float dx, float dy)
+{
+    if (dx == 0 && dy == 0) {
+        return GESTURE_DIR_NONE;
+    }
+    if (fabsf(dx) >= fabsf(dy)) {
+        return dx < 0 ? GESTURE_DIR_LEFT : GESTURE_DIR_RIGHT;
+    }
+    return dy < 0 ? GESTURE_DIR_UP : GESTURE_DIR_DOWN;
+}
+
+static int emit(const gesture_t *g, gesture_type_t type, int64_t time_us,
+                gesture_event_t *events, int count, int max)
+{
+    if (count >= max) {
+        return count;
+    }
+    const gesture_sample_t *last = newest(g);
+    gesture_event_t *e = &events[count];
+    memset(e, 0, sizeof(*e));
+    e->type = type;
+    e->x = last->x;
+    e->y = last->y;
+    e->dx = last->x - g->down_x;
+    e->dy = last->y - g->down_y;
+    e->duration_ms = (uint32_t)((time_us - g->down_us) / 1000);
+    e->time_us = time_us;
+    return count + 1;
+}
+
+/* Contact ended: classify the stroke by its travel, timing and release speed */
+static int release(gesture_t *g, int64_t time_us, gesture_event_t *events, int max)
+{
+    const gesture_config_t *c = &g->config;
+    int count = 0;
+
+    if (g->phase == PHASE_PRESSED) {
+        count = emit(g, GESTURE_TAP, time_us, events, count, max);
+    } else if (g->phase == PHASE_DRAGGING) {
+        const gesture_sample_t *last = newest(g);
+        int dx = last->x - g->down_x;
+        int dy = last->y - g->down_y;
+        int along = abs(dx) > abs(dy) ? abs(dx) : abs(dy);
+        int across = abs(dx) > abs(dy) ? abs(dy) : abs(dx);
+        float vx, vy;
+        fit_velocity(g, &vx, &vy);
+
+        /* Timed press to lift: the debounce is not the user's */
+        if (g->lift_us - g->down_us <= (int64_t)c->swipe_max_ms * 1000 &&
+            along >= c->swipe_min_px && across * 2 <= along) {
+            int n = emit(g, GESTURE_SWIPE, time_us, events, count, max);
+            if (n > count) {
+                events[count].dir = main_direction((float)dx, (float)dy);
+                events[count].vx = vx;
+                events[count].vy = vy;
+            }
+            count = n;
+        }
+        if (vx * vx + vy * vy >= (float)c->fling_min_px_s * c->fling_min_px_s) {
+            int n = emit(g, GESTURE_FLING, time_us, events, count, max);
+            if (n > count) {
+                events[count].dir = main_direction(vx, vy);
+                events[count].vx = vx;
+                events[count].vy = vy;
+            }
+            count = n;
+        }
+    }
+    count = emit(g, GESTURE_RELEASE, time_us, events, count, max);
+
+    g->phase = PHASE_IDLE;
+    g->raw_count = 0;
+    g->lift_us = 0;
+    return count;
+}
+
+int gesture_feed(gesture_t *g, const gesture_sample_t *sample, gesture_event_t *events, int max)
+{
+    const gesture_config_t *c = &g->config;
+
+    if (!sample->pressed) {
+        if (g->phase == PHASE_IDLE) {
+            return 0;
+        }
+        if (g->lift_us == 0) {
+            g->lift_us = sample->time_us;
+        }
+        if (sample->time_us - g->lift_us < (int64_t)c->release_ms * 1000) {
+            return 0;
+        }
+        return release(g, sample->time_us, events, max);
+    }
+
+    /* A dropout shorter than release_ms: the stroke goes on */
+    g->lift_us = 0;
+
+    g->raw_x[g->raw_count % 3] = sample->x;
+    g->raw_y[g->raw_count % 3] = sample->y;
+    g->raw_count++;
+    gesture_sample_t filtered = *sample;
+    if (g->raw_count >= 3) {
+        filtered.x = median3(g->raw_x);
+        filtered.y = median3(g->raw_y);
+    }
+
+    int count = 0;
+    if (g->phase == PHASE_IDLE) {
+        g->phase = PHASE_PRESSED;
+        g->history_count = 0;
+        g->down_x = filtered.x;
+        g->down_y = filtered.y;
+        g->down_us = sample->time_us;
+    }
+    g->history[g->history_count % GESTURE_HISTORY] = filtered;
+    g->history_count++;
+
+    if (g->history_count == 1) {
+        return emit(g, GESTURE_PRESS, sample->time_us, events, count, max);
+    }
+
+    if (g->phase == PHASE_PRESSED) {
+        int dx = filtered.x - g->down_x;
+        int dy = filtered.y - g->down_y;
+        if (dx * dx + dy * dy > c->slop_px * c->slop_px) {
+            g->phase = PHASE_DRAGGING;
+            count = emit(g, GESTURE_DRAG_START, sample->time_us, events, count, max);
+        } else if (sample->time_us - g->down_us >= (int64_t)c->long_press_ms * 1000) {
+            g->phase = PHASE_HELD;
+            count = emit(g, GESTURE_LONG_PRESS, sample->time_us, events, count, max);
+        }
+    }
+    return count;
+}
+
+bool gesture_get_point(const gesture_t *g, int16_t *x, int16_t *y)
+{
+    if (g->history_count > 0) {
+        const gesture_sample_t *last = newest(g);
+        if (x) {
+            *x = last->x;
+        }
+        if (y) {
+            *y = last->y;
+        }
+    }
+    return g->phase != PHASE_IDLE;
+}
+
+const char *gesture_type_name(gesture_type_t type)
+{
+    return (type < GESTURE_TYPE_COUNT) ? s_type_names[type] : "?";
+}
+
+const char *gesture_dir_name(gesture_dir_t dir)
+{
+    switch (dir) {
+        case GESTURE_DIR_LEFT: return "left";
+        case GESTURE_DIR_RIGHT: return "right";
+        case GESTURE_DIR_UP: return "up";
+        case GESTURE_DIR_DOWN: return "down";
+        default: return "-";
+    }
+}
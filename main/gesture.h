@@ -0,0 +1,147 @@
+#pragma once
+
+#include "cyd_config.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Single-touch gesture recognition over timestamped touch samples.
+ *
+ * Fed every sample the touch sampler takes (touch_sampler.h), at a steady
+ * rate well above the LVGL read rate. Tuned for the resistive XPT2046:
+ * - positions go through a 3-sample median, which drops the one-sample
+ *   spikes the panel produces at light pressure,
+ * - a release is only believed after release_ms without contact, so
+ *   pressure dropouts in the middle of a drag do not end it,
+ * - movement within slop_px of the press point is jitter, not a drag.
+ *
+ * Velocity is the least-squares slope of position over time across the
+ * samples of the last velocity_window_ms, which is far steadier than the
+ * difference of the last two points. Pure C with no LVGL or driver calls,
+ * so the host bench replays scripted strokes through it.
+ */
+
+#define GESTURE_HISTORY 32    /* Filtered samples kept for the velocity fit */
+#define GESTURE_MAX_EVENTS 3  /* Most events one sample can produce */
+
+typedef struct {
+    int64_t time_us;
+    int16_t x;
+    int16_t y;
+    bool pressed;
+} gesture_sample_t;
+
+typedef enum {
+    GESTURE_PRESS = 0,   /* Contact, at its first sample */
+    GESTURE_DRAG_START,  /* Moved past the slop */
+    GESTURE_LONG_PRESS,  /* Held still for long_press_ms; fires while held */
+    GESTURE_TAP,         /* Released before a long press without moving */
+    GESTURE_SWIPE,       /* Short, quick stroke mostly along one axis */
+    GESTURE_FLING,       /* Released while moving at fling_min_px_s or more */
+    GESTURE_RELEASE,     /* Contact ended, after any of the above */
+    GESTURE_TYPE_COUNT,
+} gesture_type_t;
+
+typedef enum {
+    GESTURE_DIR_NONE = 0,
+    GESTURE_DIR_LEFT,
+    GESTURE_DIR_RIGHT,
+    GESTURE_DIR_UP,
+    GESTURE_DIR_DOWN,
+} gesture_dir_t;
+
+typedef struct {
+    gesture_type_t type;
+    gesture_dir_t dir;     /* Swipe and fling only */
+    int16_t x;             /* Filtered position */
+    int16_t y;
+    int16_t dx;            /* From the press point */
+    int16_t dy;
+    float vx;              /* px/s, least-squares fit over the window */
+    float vy;
+    uint32_t duration_ms;  /* Since the press */
+    int64_t time_us;       /* Sample that decided the event */
+} gesture_event_t;
+
+typedef struct {
+    uint16_t slop_px;             /* Movement that makes a press a drag */
+    uint16_t release_ms;          /* Contact lost this long ends the gesture */
+    uint16_t long_press_ms;
+    uint16_t velocity_window_ms;  /* Samples fitted for the velocity */
+    uint16_t swipe_min_px;        /* Travel along the main axis */
+    uint16_t swipe_max_ms;        /* Press to lift */
+    uint16_t fling_min_px_s;      /* Release speed */
+} gesture_config_t;
+
+#define GESTURE_CONFIG_DEFAULT() {                     \
+    .slop_px = GESTURE_SLOP_PX,                        \
+    .release_ms = GESTURE_RELEASE_MS,                  \
+    .long_press_ms = GESTURE_LONG_PRESS_MS,            \
+    .velocity_window_ms = GESTURE_VELOCITY_WINDOW_MS,  \
+    .swipe_min_px = GESTURE_SWIPE_MIN_PX,              \
+    .swipe_max_ms = GESTURE_SWIPE_MAX_MS,              \
+    .fling_min_px_s = GESTURE_FLING_MIN_PX_S,          \
+}
+
+/* Recognizer state; one per input device, fed from one task */
+typedef struct {
+    gesture_config_t config;
+    gesture_sample_t history[GESTURE_HISTORY];  /* Filtered, in contact */
+    uint32_t history_count;
+    int16_t raw_x[3];
+    int16_t raw_y[3];
+    uint32_t raw_count;
+    int16_t down_x;
+    int16_t down_y;
+    int64_t down_us;
+    int64_t lift_us;  /* First sample without contact, 0 while in contact */
+    uint8_t phase;
+} gesture_t;
+
+/**
+ * @brief Reset a recognizer
+ *
+ * @param g Recognizer
+ * @param config Thresholds, copied
+ */
+void gesture_init(gesture_t *g, const gesture_config_t *config);
+
+/**
+ * @brief Feed one touch sample
+ *
+ * Samples must be in time order. Samples without contact are only needed
+ * until the release is decided; while idle they are ignored.
+ *
+ * @param g Recognizer
+ * @param sample Sample, in screen coordinates
+ * @param[out] events Events decided by this sample, oldest first
+ * @param max Room in events, GESTURE_MAX_EVENTS for all of them
+ * @return Number of events written
+ */
+int gesture_feed(gesture_t *g, const gesture_sample_t *sample, gesture_event_t *events, int max);
+
+/**
+ * @brief Get the debounced contact state and filtered position
+ *
+ * @param g Recognizer
+ * @param[out] x Last filtered x, may be NULL
+ * @param[out] y Last filtered y, may be NULL
+ * @return true while in contact, dropouts shorter than release_ms included
+ */
+bool gesture_get_point(const gesture_t *g, int16_t *x, int16_t *y);
+
+/**
+ * @brief Get an event type's name, for logs
+ *
+ * @param type Event type
+ * @return Name
+ */
+const char *gesture_type_name(gesture_type_t type);
+
+/**
+ * @brief Get a direction's name, for logs
+ *
+ * @param dir Direction
+ * @return Name
+ */
+const char *gesture_dir_name(gesture_dir_t dir);
@@ -0,0 +1,69 @@
+#include "kinetic_scroll.h"
+#include "cyd_config.h"
+
+#include <math.h>
+
+static lv_obj_t *s_obj = NULL;
+static lv_timer_t *s_timer = NULL;
+static float s_v0;           /* px/s at the start */
+static uint32_t s_start_ms;
+static int32_t s_applied;    /* Whole pixels scrolled so far */
+
+static void kinetic_step_cb(lv_timer_t *timer)
+{
+    (void)timer;
+    float t_ms = (float)lv_tick_elaps(s_start_ms);
+    float decay = expf(-t_ms / KINETIC_SCROLL_TAU_MS);
+
+    /* Distance covered by v0 * exp(-t / tau) since the start */
+    float travel = s_v0 * (KINETIC_SCROLL_TAU_MS / 1000.0f) * (1.0f - decay);
+    int32_t target = (int32_t)lroundf(travel);
+    int32_t step = target - s_applied;
+
+    if (step != 0) {
+        int32_t before = lv_obj_get_scroll_y(s_obj);
+        lv_obj_scroll_by_bounded(s_obj, 0, step, LV_ANIM_OFF);
+        s_applied = target;
+        if (lv_obj_get_scroll_y(s_obj) == before) {
+            /* End of the content */
+            kinetic_scroll_stop();
+            return;
+        }
+    }
+    if (fabsf(s_v0 * decay) < KINETIC_SCROLL_MIN_PX_S) {
+        kinetic_scroll_stop();
+    }
+}
+
+void kinetic_scroll_start(lv_obj_t *obj, float vy_px_s, uint32_t period_ms)
+{
+    kinetic_scroll_stop();
+    if (!obj || fabsf(vy_px_s) < KINETIC_SCROLL_MIN_PX_S) {
+        return;
+    }
+    if (vy_px_s > KINETIC_SCROLL_MAX_PX_S) {
+        vy_px_s = KINETIC_SCROLL_MAX_PX_S;
+    } else if (vy_px_s < -KINETIC_SCROLL_MAX_PX_S) {
+        vy_px_s = -KINETIC_SCROLL_MAX_PX_S;
+    }
+
+    s_obj = obj;
+    s_v0 = vy_px_s;
+    s_start_ms = lv_tick_get();
+    s_applied = 0;
+    s_timer = lv_timer_create(kinetic_step_cb, period_ms, NULL);
+}
+
+void kinetic_scroll_stop(void)
+{
+    if (s_timer) {
+        lv_timer_delete(s_timer);
+        s_timer = NULL;
+    }
+    s_obj = NULL;
+}
+
+bool kinetic_scroll_active(void)
+{
+    return s_timer != NULL;
+}
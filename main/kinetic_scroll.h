@@ -0,0 +1,38 @@
+#pragma once
+
+#include "lvgl.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Kinetic scrolling from a fling velocity.
+ *
+ * The object keeps scrolling after the finger lifts, with the velocity
+ * decaying exponentially (time constant KINETIC_SCROLL_TAU_MS). A timer
+ * stepping with the display refresh places the content where the decay
+ * curve puts it at that time, so late steps catch up instead of slowing the
+ * motion down, and fractions of a pixel carry over to the next step. It
+ * stops below KINETIC_SCROLL_MIN_PX_S or at the end of the content. LVGL
+ * only, in LVGL context.
+ */
+
+/**
+ * @brief Start coasting, replacing any motion in progress
+ *
+ * @param obj Scrollable object
+ * @param vy_px_s Finger velocity at release; positive moves the content down
+ * @param period_ms Step period, normally the display refresh period
+ */
+void kinetic_scroll_start(lv_obj_t *obj, float vy_px_s, uint32_t period_ms);
+
+/**
+ * @brief Stop coasting, e.g. when the finger touches down again
+ */
+void kinetic_scroll_stop(void);
+
+/**
+ * @brief Check whether the content is coasting
+ *
+ * @return true while moving
+ */
+bool kinetic_scroll_active(void);
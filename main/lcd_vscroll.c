@@ -0,0 +1,335 @@
+#include "lcd_vscroll.h"
+#include "cyd_config.h"
+#include "cyd_hw.h"
+#include "metrics.h"
+
+#include "esp_log.h"
+
+static const char *TAG = "lcd_vscroll";
+
+#define DCS_CMD_VSCRDEF 0x33       /* Vertical scrolling definition (MIPI DCS, ILI9341 and ST7796) */
+#define DCS_CMD_VSCRSA 0x37        /* Vertical scrolling start address */
+#define LCD_VSCROLL_MIN_ROWS 16    /* Smaller bodies are not worth it */
+
+static lv_display_t *s_disp;
+static esp_lcd_panel_io_handle_t s_io;
+static bool s_enabled = true;
+
+/* LVGL context only */
+static lv_obj_t *s_body;
+static bool s_active;         /* Flushes into the scroll area are translated */
+static int32_t s_top;         /* Scroll area, screen rows */
+static int32_t s_height;
+static int32_t s_scroll_y;    /* Body scroll position s_offset corresponds to */
+static int32_t s_offset;      /* Scroll area row shown at its top, 0..s_height-1 */
+static int32_t s_frame_delta; /* Net scroll since the last render started */
+static bool s_shrink_next;    /* Cut the invalidation that follows a scroll */
+static bool s_pending;        /* Something in the scroll area is dirty for the next render */
+static lv_area_t s_pending_area; /* Bounding box of it, screen coordinates */
+static bool s_frame_scrolled; /* The body scrolled, in hardware or not, since the last render */
+static uint32_t s_frame_start_bytes;
+
+/* What the panel has been sent */
+static bool s_def_pending;
+static int32_t s_sent_offset = -1;
+
+/* Why the panel cannot scroll the body at the current rotation, or NULL */
+static const char *hw_scroll_blocker(void)
+{
+    if (FB_MIRROR_ENABLE) {
+        return "framebuffer mirror would miss the moved rows";
+    }
+
+    /* VSCRDEF/VSCRSA move frame memory lines. Those run along screen x at
+     * rotation 0 when LCD_GRAM_LINES_ALONG_X is set, and each swap_xy
+     * exchanges the axes again; only along screen y do they move rows. */
+    bool swap_xy, mirror_y;
+    cyd_hw_get_address_mode(&swap_xy, NULL, &mirror_y);
+    if ((LCD_GRAM_LINES_ALONG_X != 0) != swap_xy) {
+        return "the panel scroll axis is screen x at this rotation";
+    }
+    if (mirror_y) {
+        return "the panel scroll axis is mirrored at this rotation";
+    }
+    if (lv_display_get_vertical_resolution(s_disp) != LCD_GRAM_LINES) {
+        return "the screen height is not the frame memory line count";
+    }
+    return NULL;
+}
+
+/* Make the body's visible rows the scroll area, starting unscrolled */
+static void define_area(lv_obj_t *body)
+{
+    lv_obj_update_layout(body);
+    lv_area_t coords;
+    lv_obj_get_coords(body, &coords);
+
+    int32_t v_res = lv_display_get_vertical_resolution(s_disp);
+    s_top = LV_MAX(coords.y1, 0);
+    s_height = LV_MIN(coords.y2, v_res - 1) - s_top + 1;
+    s_scroll_y = lv_obj_get_scroll_y(body);
+    s_offset = 0;
+    s_frame_delta = 0;
+    s_shrink_next = false;
+    s_pending = false;
+    s_active = s_height >= LCD_VSCROLL_MIN_ROWS;
+    s_def_pending = s_active;
+
+    /* Frame memory still holds the rows as laid out for the old offset */
+    lv_obj_invalidate(body);
+}
+
+static void body_event_cb(lv_event_t *e)
+{
+    lv_obj_t *body = lv_event_get_target_obj(e);
+
+    switch (lv_event_get_code(e)) {
+        case LV_EVENT_DELETE:
+            s_body = NULL;
+            s_active = false;
+            s_offset = 0;
+            return;
+        case LV_EVENT_SIZE_CHANGED:
+            if (s_active) {
+                lv_obj_invalidate(lv_screen_active());
+                define_area(body);
+            }
+            return;
+        case LV_EVENT_SCROLL:
+            break;
+        default:
+            return;
+    }
+
+    int32_t scroll_y = lv_obj_get_scroll_y(body);
+    int32_t delta = scroll_y - s_scroll_y;
+    s_scroll_y = scroll_y;
+    /* Off screen the body is redrawn whole when it is shown again */
+    if (delta == 0 || lv_obj_get_screen(body) != lv_screen_active()) {
+        return;
+    }
+    s_frame_scrolled = true;
+    if (!s_active) {
+        return;
+    }
+
+    lv_area_t coords;
+    lv_obj_get_coords(body, &coords);
+    if (LV_MAX(coords.y1, 0) != s_top) {
+        lv_obj_invalidate(lv_screen_active());
+        define_area(body);
+        return;
+    }
+
+    /* Areas invalidated since the last render were marked where their
+     * content was before this scroll, but the frame memory rows that hold
+     * the stale content now show delta rows higher up. Mark those too; the
+     * old positions are redrawn anyway, which is only wasted work. */
+    if (s_pending) {
+        lv_area_t moved = s_pending_area;
+        lv_area_move(&moved, 0, -delta);
+        lv_obj_invalidate_area(body, &moved);
+    }
+
+    /* Content moved up by delta rows; so does the panel's scroll start */
+    s_offset = ((s_offset + delta) % s_height + s_height) % s_height;
+    s_frame_delta += delta;
+    s_shrink_next = true;
+    metrics_inc(METRIC_CNT_HW_SCROLLS, 1);
+}
+
+/* Runs for every invalidated area; LVGL invalidates the body right after
+ * sending LV_EVENT_SCROLL */
+static void invalidate_area_cb(lv_event_t *e)
+{
+    lv_area_t *area = lv_event_get_param(e);
+    int32_t bottom = s_top + s_height - 1;
+    if (!s_active || area->y2 < s_top || area->y1 > bottom) {
+        return;
+    }
+
+    if (!s_shrink_next) {
+        /* Content redrawn in place, e.g. a label rewritten mid-drag; a later
+         * scroll in this frame has to follow it (see body_event_cb) */
+        lv_area_t clipped = {area->x1, LV_MAX(area->y1, s_top), area->x2, LV_MIN(area->y2, bottom)};
+        if (s_pending) {
+            lv_area_join(&s_pending_area, &s_pending_area, &clipped);
+        } else {
+            s_pending_area = clipped;
+            s_pending = true;
+        }
+        return;
+    }
+    s_shrink_next = false;
+
+    if (area->y1 > s_top || area->y2 < bottom) {
+        return;
+    }
+
+    /* Everything scrolled in since the last render: the union of the cut
+     * areas of one frame is always the strip for the net scroll */
+    int32_t delta = s_frame_delta;
+    if (delta >= s_height || -delta >= s_height) {
+        return;
+    }
+    if (delta > 0) {
+        area->y1 = bottom - delta + 1;
+        area->y2 = bottom;
+    } else if (delta < 0) {
+        area->y1 = s_top;
+        area->y2 = s_top - delta - 1;
+    } else {
+        /* Back where the frame started; an area cannot be dropped here */
+        area->y1 = s_top;
+        area->y2 = s_top;
+    }
+}
+
+static void render_event_cb(lv_event_t *e)
+{
+    if (lv_event_get_code(e) == LV_EVENT_RENDER_START) {
+        s_frame_delta = 0;
+        s_pending = false;
+        s_frame_start_bytes = metrics_counter(METRIC_CNT_LCD_BYTES);
+        return;
+    }
+    /* Every flush of the frame has been queued and counted by now: what a
+     * scroll step costs on the SPI bus in real use, both paths alike */
+    if (s_frame_scrolled) {
+        s_frame_scrolled = false;
+        metrics_record(METRIC_HIST_SCROLL_BYTES, metrics_counter(METRIC_CNT_LCD_BYTES) - s_frame_start_bytes);
+    }
+}
+
+esp_err_t lcd_vscroll_init(lv_display_t *disp, esp_lcd_panel_io_handle_t io)
+{
+    if (!disp || !io) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    s_disp = disp;
+    s_io = io;
+    lv_display_add_event_cb(disp, invalidate_area_cb, LV_EVENT_INVALIDATE_AREA, NULL);
+    lv_display_add_event_cb(disp, render_event_cb, LV_EVENT_RENDER_START, NULL);
+    lv_display_add_event_cb(disp, render_event_cb, LV_EVENT_RENDER_READY, NULL);
+    return ESP_OK;
+}
+
+void lcd_vscroll_attach(lv_obj_t *body)
+{
+    if (s_body) {
+        while (lv_obj_remove_event_cb(s_body, body_event_cb)) {
+        }
+    }
+    /* Rows shifted by the old offset must be redrawn in place */
+    if (s_active && s_offset != 0) {
+        lv_obj_invalidate(lv_screen_active());
+    }
+    s_body = body;
+    s_active = false;
+    s_offset = 0;
+    s_shrink_next = false;
+    s_pending = false;
+
+    if (!body) {
+        return;
+    }
+    lv_obj_add_event_cb(body, body_event_cb, LV_EVENT_SCROLL, NULL);
+    lv_obj_add_event_cb(body, body_event_cb, LV_EVENT_SIZE_CHANGED, NULL);
+    lv_obj_add_event_cb(body, body_event_cb, LV_EVENT_DELETE, NULL);
+
+    if (!s_io || !s_enabled) {
+        return;
+    }
+    const char *blocker = hw_scroll_blocker();
+    if (blocker) {
+        ESP_LOGI(TAG, "No hardware scroll (%s), scrolling in software", blocker);
+        return;
+    }
+    define_area(body);
+    ESP_LOGI(TAG, "Scroll area rows %ld..%ld", (long)s_top, (long)(s_top + s_height - 1));
+}
+
+lv_obj_t *lcd_vscroll_get_body(void)
+{
+    return s_body;
+}
+
+bool lcd_vscroll_is_active(void)
+{
+    return s_active;
+}
+
+bool lcd_vscroll_set_enabled(bool enabled)
+{
+    bool previous = s_enabled;
+    s_enabled = enabled;
+    if (enabled != previous && s_body) {
+        lcd_vscroll_attach(s_body);
+    }
+    return previous;
+}
+
+int lcd_vscroll_map_area(const lv_area_t *area, lcd_vscroll_band_t *bands)
+{
+    int32_t bottom = s_top + s_height - 1;
+    if (!s_active || area->y2 < s_top || area->y1 > bottom) {
+        bands[0] = (lcd_vscroll_band_t){0, area->y1, area->y2 - area->y1 + 1};
+        return 1;
+    }
+
+    int count = 0;
+    int32_t y = area->y1;
+    if (y < s_top) {
+        bands[count++] = (lcd_vscroll_band_t){0, y, s_top - y};
+        y = s_top;
+    }
+    /* At most two runs inside the scroll area, split where it wraps */
+    int32_t end = LV_MIN(area->y2, bottom);
+    while (y <= end) {
+        int32_t row = (y - s_top + s_offset) % s_height;
+        int32_t rows = LV_MIN(end - y + 1, s_height - row);
+        bands[count++] = (lcd_vscroll_band_t){y - area->y1, s_top + row, rows};
+        y += rows;
+    }
+    if (y <= area->y2) {
+        bands[count++] = (lcd_vscroll_band_t){y - area->y1, y, area->y2 - y + 1};
+    }
+    return count;
+}
+
+esp_err_t lcd_vscroll_sync(void)
+{
+    if (!s_io) {
+        return ESP_OK;
+    }
+
+    esp_err_t ret = ESP_OK;
+    if (s_def_pending) {
+        uint16_t tfa = (uint16_t)s_top;
+        uint16_t vsa = (uint16_t)s_height;
+        uint16_t bfa = (uint16_t)(LCD_GRAM_LINES - s_top - s_height);
+        uint8_t def[6] = {tfa >> 8, tfa & 0xFF, vsa >> 8, vsa & 0xFF, bfa >> 8, bfa & 0xFF};
+        ret = esp_lcd_panel_io_tx_param(s_io, DCS_CMD_VSCRDEF, def, sizeof(def));
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to define scroll area: %s", esp_err_to_name(ret));
+            return ret;
+        }
+        metrics_inc(METRIC_CNT_LCD_BYTES, 1 + sizeof(def));
+        s_def_pending = false;
+        s_sent_offset = -1;
+    }
+
+    /* Detached leaves offset 0, which shows frame memory unscrolled */
+    if (s_offset != s_sent_offset) {
+        uint16_t vsp = (uint16_t)(s_top + s_offset);
+        uint8_t start[2] = {vsp >> 8, vsp & 0xFF};
+        ret = esp_lcd_panel_io_tx_param(s_io, DCS_CMD_VSCRSA, start, sizeof(start));
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to set scroll start: %s", esp_err_to_name(ret));
+            return ret;
+        }
+        metrics_inc(METRIC_CNT_LCD_BYTES, 1 + sizeof(start));
+        s_sent_offset = s_offset;
+    }
+    return ESP_OK;
+}
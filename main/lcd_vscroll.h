@@ -0,0 +1,105 @@
+#pragma once
+
+#include "esp_err.h"
+#include "esp_lcd_panel_io.h"
+#include "lvgl.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Panel hardware vertical scroll for one scrollable LVGL object (the body).
+ *
+ * The body's rows become the panel's vertical scroll area (VSCRDEF), the rows
+ * above and below it the fixed areas. When the body scrolls by d rows the
+ * scroll start (VSCRSA) moves by d and the whole-body invalidation LVGL makes
+ * is cut down to the d rows that were exposed. Flushes into the scroll area
+ * are translated to frame memory rows and split where they wrap, so LVGL
+ * keeps drawing in screen coordinates.
+ *
+ * The panel moves whole rows, so nothing may be drawn in the body's rows
+ * except the body's content over a background that does not change along y.
+ * Hardware scroll is used only where the panel's frame memory lines run
+ * along the screen's y axis, unmirrored, and span the screen height. That
+ * follows from the board profile (LCD_GRAM_LINES_ALONG_X) and the swap_xy
+ * and mirror state of the current rotation: the 3.5" portrait layout at
+ * rotation 0, the 2.8" board only in portrait, never in its landscape boot
+ * layout. The framebuffer mirror must be off, since it would miss the moved
+ * rows. Anywhere else the body scrolls in software as before, and the
+ * reason is logged when a body is attached.
+ *
+ * Areas invalidated between renders are followed across scroll steps, so
+ * content that changes mid-drag is redrawn where the panel now shows it.
+ * The SPI bytes of every frame that scrolled the body, in hardware or not,
+ * go into the scroll_bytes histogram.
+ */
+
+#define LCD_VSCROLL_MAX_BANDS 4
+
+/* A run of rows of a flushed area and where it lands in frame memory */
+typedef struct {
+    int32_t src_row;  /* First row, relative to the top of the area */
+    int32_t dst_y;    /* Frame memory row to write it to */
+    int32_t rows;
+} lcd_vscroll_band_t;
+
+/**
+ * @brief Hook hardware scroll into a display
+ *
+ * @param disp LVGL display driving the panel
+ * @param io Panel IO used for the scroll commands
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t lcd_vscroll_init(lv_display_t *disp, esp_lcd_panel_io_handle_t io);
+
+/**
+ * @brief Scroll a body in hardware, or stop doing so
+ *
+ * Matches ui_scroll_body_callback_t. Falls back to software scrolling when
+ * hardware scroll cannot be used. Must be called in LVGL context.
+ *
+ * @param body Scrollable object, NULL to detach
+ */
+void lcd_vscroll_attach(lv_obj_t *body);
+
+/**
+ * @brief Get the attached body
+ *
+ * @return Body, or NULL if none is attached
+ */
+lv_obj_t *lcd_vscroll_get_body(void);
+
+/**
+ * @brief Check whether the attached body is scrolled in hardware
+ *
+ * @return true if the scroll area is in use
+ */
+bool lcd_vscroll_is_active(void);
+
+/**
+ * @brief Allow or forbid hardware scroll, e.g. to compare both paths
+ *
+ * Re-attaches the current body. Must be called in LVGL context.
+ *
+ * @param enabled false to always scroll in software
+ * @return Previous setting
+ */
+bool lcd_vscroll_set_enabled(bool enabled);
+
+/**
+ * @brief Split a flushed area into bands in frame memory coordinates
+ *
+ * @param area Area LVGL is flushing, in screen coordinates
+ * @param[out] bands At least LCD_VSCROLL_MAX_BANDS entries
+ * @return Number of bands, at least 1
+ */
+int lcd_vscroll_map_area(const lv_area_t *area, lcd_vscroll_band_t *bands);
+
+/**
+ * @brief Send pending scroll area and scroll start commands to the panel
+ *
+ * Call from the flush callback before drawing, so the new scroll start
+ * takes effect together with the rows it exposes.
+ *
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t lcd_vscroll_sync(void);
@@ -6,6 +6,7 @@
 #include "esp_err.h"
 #include "esp_log.h"
 #include "esp_timer.h"
+#include "esp_heap_caps.h"
 
 #include "esp_lcd_panel_ops.h"
 #include "esp_lcd_touch.h"
@@ -13,21 +14,39 @@
 #include "lvgl.h"
 
 #include "cyd_config.h"
+#include "cyd_console.h"
 #include "cyd_hw.h"
+#include "fb_mirror.h"
+#include "gesture.h"
+#include "kinetic_scroll.h"
+#include "lcd_vscroll.h"
+#include "metrics.h"
+#include "power.h"
+#include "power_ui.h"
+#include "scan_log.h"
+#include "touch_sampler.h"
+#include "tuning.h"
 #include "ui.h"
 #include "wifi_scanner.h"
 
 static const char *TAG = "cyd_lvgl";
 
+#define LCD_DRAW_CMD_BYTES 11  /* CASET + RASET + RAMWR ahead of each bitmap */
+#define MIRROR_STALE_AREAS_MAX 16  /* Per resend pass; well below LVGL's 32 invalid areas */
+
 static lv_display_t *s_disp;
 static esp_lcd_touch_handle_t s_touch;
 static esp_lcd_panel_handle_t s_panel;
+static gesture_t s_gesture;
+static lv_obj_t *s_scroll_body;
+static bool s_hw_scroll;
+static volatile int64_t s_flush_start_us;
+static uint32_t s_flush_parts;  /* Panel transfers left in the current flush */
 
-/* LVGL tick callback - periodic timer for LVGL timekeeping */
-static void lv_tick_cb(void *arg)
+/* LVGL tick source - read the clock instead of waking every millisecond */
+static uint32_t lv_tick_get_cb(void)
 {
-    (void)arg;
-    lv_tick_inc(LVGL_TICK_PERIOD_MS);
+    return (uint32_t)(esp_timer_get_time() / 1000);
 }
 
 /* SPI transfer done callback - notify LVGL that flush is complete */
@@ -37,6 +56,10 @@ static bool on_color_trans_done(esp_lcd_panel_io_handle_t panel_io,
 {
     (void)panel_io; (void)edata;
     lv_display_t *disp = (lv_display_t *)user_ctx;
+    if (__atomic_sub_fetch(&s_flush_parts, 1, __ATOMIC_ACQ_REL) != 0) {
+        return false;
+    }
+    metrics_record(METRIC_HIST_FLUSH_US, (uint32_t)(esp_timer_get_time() - s_flush_start_us));
     lv_display_flush_ready(disp);
     return false;
 }
@@ -45,24 +68,86 @@ static bool on_color_trans_done(esp_lcd_panel_io_handle_t panel_io,
 static void lvgl_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
 {
     esp_lcd_panel_handle_t panel = (esp_lcd_panel_handle_t)lv_display_get_user_data(disp);
-    
-    /* Apply color correction if needed */
-    if (LCD_SWAP_COLOR_BYTES || LCD_SWAP_RB) {
-        uint16_t *buf = (uint16_t *)px_map;
-        size_t w = (size_t)(area->x2 - area->x1 + 1);
-        size_t h = (size_t)(area->y2 - area->y1 + 1);
-        size_t count = w * h;
-        cyd_hw_correct_color_buffer(buf, count);
+
+    /* Flush time runs from here to the end of the SPI transfer */
+    s_flush_start_us = esp_timer_get_time();
+    metrics_inc(METRIC_CNT_FLUSHES, 1);
+
+    /* Mirror the area as LVGL rendered it, before panel-specific corrections */
+    if (FB_MIRROR_ENABLE) {
+        fb_mirror_push(area->x1, area->y1, area->x2, area->y2, (const uint16_t *)px_map);
+    }
+
+    /* Apply the board's color correction. Both flags are profile constants,
+     * so only one branch is compiled in; a plain byte swap goes through
+     * LVGL's word-at-a-time routine instead of the per-pixel loop. */
+    if (LCD_SWAP_COLOR_BYTES && !LCD_SWAP_RB) {
+        lv_draw_sw_rgb565_swap(px_map, lv_area_get_size(area));
+    } else if (LCD_SWAP_RB) {
+        cyd_hw_correct_color_buffer((uint16_t *)px_map, lv_area_get_size(area));
     }
     
-    esp_lcd_panel_draw_bitmap(panel,
-                              area->x1, area->y1,
-                              area->x2 + 1, area->y2 + 1,
-                              px_map);
-    /* flush_ready will be called via on_color_trans_done callback */
+    /* Rows inside a hardware scroll area land elsewhere in frame memory */
+    lcd_vscroll_band_t bands[LCD_VSCROLL_MAX_BANDS];
+    int band_count = lcd_vscroll_map_area(area, bands);
+    lcd_vscroll_sync();
+
+    int32_t w = area->x2 - area->x1 + 1;
+    __atomic_store_n(&s_flush_parts, (uint32_t)band_count, __ATOMIC_RELEASE);
+    for (int i = 0; i < band_count; i++) {
+        esp_lcd_panel_draw_bitmap(panel,
+                                  area->x1, bands[i].dst_y,
+                                  area->x2 + 1, bands[i].dst_y + bands[i].rows,
+                                  (const uint16_t *)px_map + bands[i].src_row * w);
+        metrics_inc(METRIC_CNT_LCD_BYTES, LCD_DRAW_CMD_BYTES + (uint32_t)(w * bands[i].rows * 2));
+    }
+    /* flush_ready will be called via on_color_trans_done after the last band */
+}
+
+/* Display event callback - measures render time of each frame that draws something */
+static void lvgl_render_event_cb(lv_event_t *e)
+{
+    static int64_t render_start_us;
+
+    int64_t now = esp_timer_get_time();
+
+    if (lv_event_get_code(e) == LV_EVENT_RENDER_START) {
+        render_start_us = now;
+        return;
+    }
+
+    metrics_record(METRIC_HIST_FRAME_US, (uint32_t)(now - render_start_us));
+    metrics_inc(METRIC_CNT_FRAMES, 1);
+    power_add_time(POWER_STATE_RENDER, (uint32_t)(now - render_start_us));
 }
 
-/* LVGL touch read callback - handles touch input and updates UI debug elements */
+/* Runs in LVGL context for each recognized gesture */
+static void on_gesture(const gesture_event_t *event)
+{
+    metrics_record(METRIC_HIST_GESTURE_US, (uint32_t)(esp_timer_get_time() - event->time_us));
+    ESP_LOGD(TAG, "Gesture %s %s at %d,%d, %.0f,%.0f px/s", gesture_type_name(event->type),
+             gesture_dir_name(event->dir), event->x, event->y, event->vx, event->vy);
+
+    if (!KINETIC_SCROLL_ENABLE) {
+        return;
+    }
+    if (event->type == GESTURE_PRESS) {
+        /* Touching coasting content catches it */
+        kinetic_scroll_stop();
+    } else if (event->type == GESTURE_FLING && s_scroll_body) {
+        /* Only a fling that started on the body, which LVGL was dragging */
+        lv_area_t coords;
+        int32_t down_x = event->x - event->dx;
+        int32_t down_y = event->y - event->dy;
+        lv_obj_get_coords(s_scroll_body, &coords);
+        if (down_x >= coords.x1 && down_x <= coords.x2 && down_y >= coords.y1 && down_y <= coords.y2) {
+            kinetic_scroll_start(s_scroll_body, event->vy, (uint32_t)tuning_get(TUNING_REFR_PERIOD_MS));
+        }
+    }
+}
+
+/* LVGL touch read callback - runs the sampled touch points through the
+ * gesture recognizer and reports its debounced, filtered point */
 static void lvgl_touch_read_cb(lv_indev_t *indev, lv_indev_data_t *data)
 {
     (void)indev;
@@ -72,72 +157,150 @@ static void lvgl_touch_read_cb(lv_indev_t *indev, lv_indev_data_t *data)
         return;
     }
 
-    uint16_t x[1], y[1];
-    uint8_t cnt = 0;
-    static uint16_t last_x;
-    static uint16_t last_y;
+    static int16_t last_x;
+    static int16_t last_y;
     static bool last_pressed;
 
-    /* Some touch drivers require read_data() before get_coordinates() */
-    esp_lcd_touch_read_data(s_touch);
-
-    bool pressed = esp_lcd_touch_get_coordinates(s_touch, x, y, NULL, &cnt, 1);
-
-    if (pressed && cnt > 0) {
-        cyd_hw_map_touch_coords(&x[0], &y[0]);
+    bool was_pressed = gesture_get_point(&s_gesture, NULL, NULL);
+    gesture_sample_t sample;
+    while (touch_sampler_pop(&sample)) {
+        gesture_event_t events[GESTURE_MAX_EVENTS];
+        int count = gesture_feed(&s_gesture, &sample, events, GESTURE_MAX_EVENTS);
+        for (int i = 0; i < count; i++) {
+            on_gesture(&events[i]);
+        }
+        /* Hand LVGL every press and release, not just the newest state, so
+         * a tap shorter than the read period still clicks */
+        if (gesture_get_point(&s_gesture, NULL, NULL) != was_pressed) {
+            data->continue_reading = true;
+            break;
+        }
+    }
 
+    int16_t x = 0, y = 0;
+    bool pressed = gesture_get_point(&s_gesture, &x, &y);
+    if (pressed) {
         data->state = LV_INDEV_STATE_PRESSED;
-        data->point.x = x[0];
-        data->point.y = y[0];
+        data->point.x = x;
+        data->point.y = y;
 
-        if (pressed != last_pressed || x[0] != last_x || y[0] != last_y) {
+        if (pressed != last_pressed || x != last_x || y != last_y) {
             lv_obj_t *cursor = ui_get_cursor();
             if (cursor) {
-                lv_obj_set_pos(cursor, x[0] - CURSOR_OFFSET, y[0] - CURSOR_OFFSET);
+                lv_obj_set_pos(cursor, x - CURSOR_OFFSET, y - CURSOR_OFFSET);
             }
             lv_obj_t *label = ui_get_touch_label();
             if (label) {
                 char buf[TOUCH_LABEL_MAX_LEN];
-                snprintf(buf, sizeof(buf), "touch: %u, %u", x[0], y[0]);
+                snprintf(buf, sizeof(buf), "touch: %d, %d", x, y);
                 lv_label_set_text(label, buf);
             }
-            last_x = x[0];
-            last_y = y[0];
+            last_x = x;
+            last_y = y;
             last_pressed = pressed;
         }
     } else {
+        /* LVGL releases at the last point it was given */
         data->state = LV_INDEV_STATE_RELEASED;
+        data->point.x = x;
+        data->point.y = y;
         last_pressed = false;
     }
 }
 
+/* The active view's scroll body: scrolled in the panel where possible, and
+ * coasted by kinetic_scroll.h instead of LVGL's own momentum */
+static void on_scroll_body(lv_obj_t *body)
+{
+    /* Called before the old body is deleted */
+    kinetic_scroll_stop();
+    s_scroll_body = body;
+    if (body && KINETIC_SCROLL_ENABLE) {
+        lv_obj_remove_flag(body, LV_OBJ_FLAG_SCROLL_MOMENTUM);
+    }
+    if (s_hw_scroll) {
+        lcd_vscroll_attach(body);
+    }
+}
+
+/* Rotate the display in the panel's address mode and resize LVGL to match;
+ * no pixel is ever rotated in software */
+static esp_err_t display_set_rotation(cyd_rotation_t rotation)
+{
+    ui_lock();
+    esp_err_t ret = cyd_hw_set_rotation(s_panel, rotation);
+    if (ret == ESP_OK) {
+        uint16_t h_res, v_res;
+        cyd_hw_get_resolution(&h_res, &v_res);
+        lv_display_set_resolution(s_disp, h_res, v_res);
+        if (FB_MIRROR_ENABLE) {
+            fb_mirror_reset();
+        }
+        /* Layouts depend on the resolution, so rebuild the active view */
+        ui_reload_view();
+    }
+    ui_unlock();
+    return ret;
+}
+
+/* Callback for red button press - rotates the display by 90 degrees */
+static void on_red_button_pressed(void)
+{
+    cyd_rotation_t next = (cyd_rotation_t)((cyd_hw_get_rotation() + 1) % 4);
+    if (display_set_rotation(next) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to rotate display");
+    }
+}
+
 /* Callback for green button press - starts WiFi scanner */
 static void on_green_button_pressed(void)
 {
-    static bool wifi_initialized = false;
-    
-    /* Initialize WiFi only once */
-    if (!wifi_initialized) {
-        ESP_LOGI(TAG, "Green button pressed - initializing WiFi");
-        esp_err_t ret = wifi_scanner_init();
-        if (ret != ESP_OK) {
-            ESP_LOGE(TAG, "Failed to initialize WiFi scanner");
-            return;
-        }
-        wifi_initialized = true;
+    /* Initializes WiFi on first use, or again after wifi_scanner_stop() */
+    esp_err_t ret = wifi_scanner_init();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to initialize WiFi scanner");
+        return;
     }
     
     /* Always try to start/show the scanner */
     ESP_LOGI(TAG, "Showing WiFi scanner");
-    esp_err_t ret = wifi_scanner_start(ui_get_main_screen());
+    ret = wifi_scanner_start();
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to start WiFi scanner");
     }
 }
 
+/* Callback for yellow button press - shows the power page */
+static void on_yellow_button_pressed(void)
+{
+    ui_show_view(&power_ui_view);
+}
+
+/* Apply the live LVGL loop parameters from tuning.h */
+static void apply_lvgl_tuning(lv_indev_t *indev)
+{
+    vTaskPrioritySet(NULL, (UBaseType_t)tuning_get(TUNING_LVGL_PRIORITY));
+
+    /* Touch is polled more slowly while the backlight is dimmed */
+    uint32_t touch_period = power_is_idle() ? POWER_IDLE_TOUCH_PERIOD_MS : tuning_get(TUNING_TOUCH_PERIOD_MS);
+
+    ui_lock();
+    lv_timer_set_period(lv_display_get_refr_timer(s_disp), tuning_get(TUNING_REFR_PERIOD_MS));
+    lv_timer_set_period(lv_indev_get_read_timer(indev), touch_period);
+    /* One tile per draw thread lets both cores render each buffer */
+    lv_display_set_tile_cnt(s_disp, (uint32_t)tuning_get(TUNING_LVGL_TILES));
+    ui_unlock();
+}
+
 void app_main(void)
 {
     esp_err_t ret;
+
+    /* Load tuning first; the LCD clock and draw buffers depend on it */
+    ret = tuning_init();
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to load tuning, using defaults");
+    }
     
     /* Initialize backlight */
     ret = cyd_hw_init_backlight();
@@ -146,6 +309,13 @@ void app_main(void)
         return;
     }
 
+    if (POWER_MGMT_ENABLE) {
+        ret = power_init();
+        if (ret != ESP_OK) {
+            ESP_LOGW(TAG, "Failed to enable power management, running at full speed");
+        }
+    }
+
     /* Initialize LCD */
     esp_lcd_panel_io_handle_t lcd_io = NULL;
     ret = cyd_hw_init_lcd(&lcd_io, &s_panel);
@@ -157,36 +327,27 @@ void app_main(void)
     /* Initialize LVGL */
     lv_init();
 
-    /* Create LVGL tick timer (1ms) */
-    const esp_timer_create_args_t tick_args = {
-        .callback = lv_tick_cb,
-        .name = "lv_tick",
-    };
-    esp_timer_handle_t tick_timer;
-    ret = esp_timer_create(&tick_args, &tick_timer);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to create LVGL timer");
-        return;
-    }
-    ret = esp_timer_start_periodic(tick_timer, LVGL_TICK_PERIOD_MS * 1000);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to start LVGL timer");
-        return;
-    }
+    /* No periodic tick interrupt, so the chip can sleep between frames */
+    lv_tick_set_cb(lv_tick_get_cb);
 
-    /* Create LVGL display */
-    s_disp = lv_display_create(LCD_H_RES, LCD_V_RES);
+    /* Create LVGL display at the resolution of the boot rotation */
+    uint16_t h_res, v_res;
+    cyd_hw_get_resolution(&h_res, &v_res);
+    s_disp = lv_display_create(h_res, v_res);
     if (!s_disp) {
         ESP_LOGE(TAG, "Failed to create LVGL display");
         return;
     }
     lv_display_set_user_data(s_disp, s_panel);
     lv_display_set_flush_cb(s_disp, lvgl_flush_cb);
+    lv_display_add_event_cb(s_disp, lvgl_render_event_cb, LV_EVENT_RENDER_START, NULL);
+    lv_display_add_event_cb(s_disp, lvgl_render_event_cb, LV_EVENT_RENDER_READY, NULL);
 
-    /* Allocate LVGL draw buffers */
+    /* Allocate LVGL draw buffers; the tuned height may use less than all of them */
     static lv_color_t buf1[LCD_H_RES * LCD_BUFFER_LINES];
     static lv_color_t buf2[LCD_H_RES * LCD_BUFFER_LINES];
-    lv_display_set_buffers(s_disp, buf1, buf2, sizeof(buf1), LV_DISPLAY_RENDER_MODE_PARTIAL);
+    uint32_t buf_size = LCD_H_RES * tuning_get(TUNING_LCD_BUFFER_LINES) * sizeof(lv_color_t);
+    lv_display_set_buffers(s_disp, buf1, buf2, buf_size, LV_DISPLAY_RENDER_MODE_PARTIAL);
 
     /* Register flush done callback in LCD IO */
     esp_lcd_panel_io_callbacks_t cbs = {
@@ -198,11 +359,30 @@ void app_main(void)
         return;
     }
 
-    /* Initialize touch controller */
-    ret = cyd_hw_init_touch(&s_touch);
-    if (ret != ESP_OK) {
-        ESP_LOGW(TAG, "Failed to initialize touch, continuing without touch input");
+    /* Initialize the SD card logger, and touch unless the board has them on one bus */
+    if (SCAN_LOG_ENABLE) {
+        ret = cyd_hw_init_sdcard(SCAN_LOG_MOUNT_POINT);
+        if (ret == ESP_OK) {
+            ret = scan_log_init(SCAN_LOG_MOUNT_POINT);
+        }
+        if (ret != ESP_OK) {
+            ESP_LOGW(TAG, "Failed to initialize scan log, continuing without logging");
+        }
+    }
+    if (SCAN_LOG_ENABLE && TOUCH_SHARES_SD_BUS) {
+        ESP_LOGI(TAG, "Scan logging enabled, touch is disabled");
         s_touch = NULL;
+    } else {
+        ret = cyd_hw_init_touch(&s_touch);
+        if (ret == ESP_OK) {
+            gesture_config_t gesture_config = GESTURE_CONFIG_DEFAULT();
+            gesture_init(&s_gesture, &gesture_config);
+            ret = touch_sampler_init(s_touch);
+        }
+        if (ret != ESP_OK) {
+            ESP_LOGW(TAG, "Failed to initialize touch, continuing without touch input");
+            s_touch = NULL;
+        }
     }
 
     /* Create LVGL input device */
@@ -215,18 +395,94 @@ void app_main(void)
     lv_indev_set_display(indev, s_disp);
     lv_indev_set_read_cb(indev, lvgl_touch_read_cb);
 
+    /* Scroll list bodies in the panel where possible */
+    if (LCD_VSCROLL_ENABLE) {
+        ret = lcd_vscroll_init(s_disp, lcd_io);
+        if (ret == ESP_OK) {
+            s_hw_scroll = true;
+        } else {
+            ESP_LOGW(TAG, "Failed to set up hardware scroll, scrolling in software");
+        }
+    }
+    ui_set_scroll_body_callback(on_scroll_body);
+
     /* Initialize UI */
     ui_init();
 
+    if (FB_MIRROR_ENABLE) {
+        ret = fb_mirror_init();
+        if (ret != ESP_OK) {
+            ESP_LOGW(TAG, "Failed to initialize framebuffer mirror, continuing without it");
+        }
+    }
+
+    if (CONSOLE_ENABLE) {
+        ret = cyd_console_init();
+        if (ret != ESP_OK) {
+            ESP_LOGW(TAG, "Failed to start console, continuing without it");
+        }
+    }
+
     ESP_LOGI(TAG, "LVGL running");
 
     /* Main LVGL task loop */
-    /* Set green button callback */
-    ESP_LOGI(TAG, "Setting up green button callback");
-    ui_set_green_button_callback(on_green_button_pressed);
+    /* Set menu button callbacks */
+    ESP_LOGI(TAG, "Setting up menu button callbacks");
+    ui_set_button_callback(UI_BUTTON_GREEN, on_green_button_pressed);
+    ui_set_button_callback(UI_BUTTON_RED, on_red_button_pressed);
+    ui_set_button_callback(UI_BUTTON_YELLOW, on_yellow_button_pressed);
 
+    /* Headless logger: nobody can tap the menu, so start scanning right away */
+    if (SCAN_LOG_ENABLE && TOUCH_SHARES_SD_BUS) {
+        on_green_button_pressed();
+    }
+
+    int64_t last_mirror_refresh_us = 0;
+    int64_t last_metrics_dump_us = esp_timer_get_time();
+    uint32_t tuning_gen = tuning_generation() - 1;
     while (1) {
-        lv_timer_handler();
-        vTaskDelay(pdMS_TO_TICKS(LVGL_TASK_DELAY_MS));
+        /* Pick up live tuning changes from the console */
+        if (tuning_gen != tuning_generation()) {
+            tuning_gen = tuning_generation();
+            apply_lvgl_tuning(indev);
+        }
+
+        uint32_t wait_ms = lv_timer_handler();
+
+        /* Dim after a while without touch; the next touch restores it */
+        if (POWER_MGMT_ENABLE && power_update_idle(lv_display_get_inactive_time(s_disp))) {
+            apply_lvgl_tuning(indev);
+        }
+
+        if (METRICS_DUMP_INTERVAL_S > 0 &&
+            esp_timer_get_time() - last_metrics_dump_us >= METRICS_DUMP_INTERVAL_S * 1000000LL) {
+            metrics_set(METRIC_GAUGE_FREE_HEAP, (int32_t)heap_caps_get_free_size(MALLOC_CAP_8BIT));
+            metrics_set(METRIC_GAUGE_MIN_FREE_HEAP, (int32_t)heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT));
+            metrics_dump(stdout);
+            last_metrics_dump_us = esp_timer_get_time();
+        }
+
+        /* Redraw just the tiles the mirror dropped so they reach the host */
+        if (FB_MIRROR_ENABLE &&
+            esp_timer_get_time() - last_mirror_refresh_us >= FB_MIRROR_REFRESH_MS * 1000LL) {
+            fb_mirror_area_t stale[MIRROR_STALE_AREAS_MAX];
+            int count = fb_mirror_take_stale_areas(stale, MIRROR_STALE_AREAS_MAX);
+            if (count > 0) {
+                ui_lock();
+                for (int i = 0; i < count; i++) {
+                    lv_area_t area = {stale[i].x1, stale[i].y1, stale[i].x2, stale[i].y2};
+                    lv_obj_invalidate_area(lv_screen_active(), &area);
+                }
+                ui_unlock();
+                last_mirror_refresh_us = esp_timer_get_time();
+            }
+        }
+
+        /* Sleep until the next LVGL timer is due rather than polling */
+        uint32_t delay_ms = tuning_get(TUNING_LVGL_DELAY_MS);
+        if (POWER_MGMT_ENABLE && wait_ms > delay_ms) {
+            delay_ms = (wait_ms < POWER_LVGL_MAX_WAIT_MS) ? wait_ms : POWER_LVGL_MAX_WAIT_MS;
+        }
+        vTaskDelay(pdMS_TO_TICKS(delay_ms));
     }
 }
@@ -0,0 +1,167 @@
+#include "metrics.h"
+#include "cyd_board.h"
+
+#include "esp_timer.h"
+
+#include <stdbool.h>
+
+#define METRICS_LINEAR_MAX 16  /* Values below this get a bucket each */
+#define METRICS_SUB_BITS 2     /* 4 sub-buckets per power of two */
+
+typedef struct {
+    uint32_t max;
+    uint32_t buckets[METRICS_HIST_BUCKETS];
+} metrics_hist_data_t;
+
+static const char *const s_counter_names[METRIC_CNT_COUNT] = {
+    [METRIC_CNT_SCANS] = "scans",
+    [METRIC_CNT_SCAN_ERRORS] = "scan_errors",
+    [METRIC_CNT_FRAMES] = "frames",
+    [METRIC_CNT_FLUSHES] = "flushes",
+    [METRIC_CNT_TOUCH_READS] = "touch_reads",
+    [METRIC_CNT_LCD_BYTES] = "lcd_bytes",
+    [METRIC_CNT_HW_SCROLLS] = "hw_scrolls",
+    [METRIC_CNT_ROGUE_ALERTS] = "rogue_alerts",
+    [METRIC_CNT_TOUCH_DROPS] = "touch_drops",
+    [METRIC_CNT_TRACK_SCANS] = "track_scans",
+};
+
+static const char *const s_gauge_names[METRIC_GAUGE_COUNT] = {
+    [METRIC_GAUGE_SCAN_APS] = "scan_aps",
+    [METRIC_GAUGE_FREE_HEAP] = "free_heap",
+    [METRIC_GAUGE_MIN_FREE_HEAP] = "min_free_heap",
+};
+
+static const char *const s_hist_names[METRIC_HIST_COUNT] = {
+    [METRIC_HIST_SCAN_US] = "scan_us",
+    [METRIC_HIST_FRAME_US] = "frame_us",
+    [METRIC_HIST_FLUSH_US] = "flush_us",
+    [METRIC_HIST_TOUCH_US] = "touch_us",
+    [METRIC_HIST_LOCK_WAIT_US] = "lock_wait_us",
+    [METRIC_HIST_GESTURE_US] = "gesture_us",
+    [METRIC_HIST_SCROLL_BYTES] = "scroll_bytes",
+    [METRIC_HIST_TRACK_SCAN_US] = "track_scan_us",
+};
+
+static uint32_t s_counters[METRIC_CNT_COUNT];
+static int32_t s_gauges[METRIC_GAUGE_COUNT];
+static metrics_hist_data_t s_hists[METRIC_HIST_COUNT];
+
+static inline int bucket_index(uint32_t v)
+{
+    if (v < METRICS_LINEAR_MAX) {
+        return (int)v;
+    }
+    int exp = 31 - __builtin_clz(v);  /* >= 4 */
+    int sub = (int)(v >> (exp - METRICS_SUB_BITS)) & ((1 << METRICS_SUB_BITS) - 1);
+    return METRICS_LINEAR_MAX + ((exp - 4) << METRICS_SUB_BITS) + sub;
+}
+
+static inline uint32_t bucket_upper(int idx)
+{
+    if (idx < METRICS_LINEAR_MAX) {
+        return (uint32_t)idx;
+    }
+    int exp = 4 + ((idx - METRICS_LINEAR_MAX) >> METRICS_SUB_BITS);
+    uint32_t sub = (uint32_t)((idx - METRICS_LINEAR_MAX) & ((1 << METRICS_SUB_BITS) - 1));
+    uint64_t lower = (uint64_t)((1u << METRICS_SUB_BITS) + sub) << (exp - METRICS_SUB_BITS);
+    uint64_t upper = lower + (1ull << (exp - METRICS_SUB_BITS)) - 1;
+    return (upper > UINT32_MAX) ? UINT32_MAX : (uint32_t)upper;
+}
+
+void metrics_inc(metric_counter_t counter, uint32_t n)
+{
+    __atomic_fetch_add(&s_counters[counter], n, __ATOMIC_RELAXED);
+}
+
+void metrics_set(metric_gauge_t gauge, int32_t value)
+{
+    __atomic_store_n(&s_gauges[gauge], value, __ATOMIC_RELAXED);
+}
+
+void metrics_record(metric_hist_t hist, uint32_t value)
+{
+    metrics_hist_data_t *h = &s_hists[hist];
+    __atomic_fetch_add(&h->buckets[bucket_index(value)], 1, __ATOMIC_RELAXED);
+
+    uint32_t max = __atomic_load_n(&h->max, __ATOMIC_RELAXED);
+    while (value > max &&
+           !__atomic_compare_exchange_n(&h->max, &max, value, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+uint32_t metrics_counter(metric_counter_t counter)
+{
+    return __atomic_load_n(&s_counters[counter], __ATOMIC_RELAXED);
+}
+
+uint32_t metrics_percentile(metric_hist_t hist, uint32_t permille)
+{
+    const metrics_hist_data_t *h = &s_hists[hist];
+    uint32_t counts[METRICS_HIST_BUCKETS];
+    uint64_t total = 0;
+
+    for (int i = 0; i < METRICS_HIST_BUCKETS; i++) {
+        counts[i] = __atomic_load_n(&h->buckets[i], __ATOMIC_RELAXED);
+        total += counts[i];
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    /* Rank of the sample at the percentile, 1-based */
+    uint64_t rank = (total * permille + 999) / 1000;
+    if (rank == 0) {
+        rank = 1;
+    }
+    uint64_t seen = 0;
+    for (int i = 0; i < METRICS_HIST_BUCKETS; i++) {
+        seen += counts[i];
+        if (seen >= rank) {
+            uint32_t upper = bucket_upper(i);
+            uint32_t max = __atomic_load_n(&h->max, __ATOMIC_RELAXED);
+            return (upper < max) ? upper : max;
+        }
+    }
+    return __atomic_load_n(&h->max, __ATOMIC_RELAXED);
+}
+
+void metrics_dump(FILE *out)
+{
+    /* Frame and flush times only compare between builds of the same board */
+    fprintf(out, "# metrics board=%s res=%dx%d uptime_s=%lu\n", CYD_BOARD_NAME, LCD_H_RES, LCD_V_RES,
+            (unsigned long)(esp_timer_get_time() / 1000000));
+    for (int i = 0; i < METRIC_CNT_COUNT; i++) {
+        fprintf(out, "c %s %lu\n", s_counter_names[i],
+                (unsigned long)__atomic_load_n(&s_counters[i], __ATOMIC_RELAXED));
+    }
+    for (int i = 0; i < METRIC_GAUGE_COUNT; i++) {
+        fprintf(out, "g %s %ld\n", s_gauge_names[i],
+                (long)__atomic_load_n(&s_gauges[i], __ATOMIC_RELAXED));
+    }
+    for (int i = 0; i < METRIC_HIST_COUNT; i++) {
+        uint64_t n = 0;
+        for (int b = 0; b < METRICS_HIST_BUCKETS; b++) {
+            n += __atomic_load_n(&s_hists[i].buckets[b], __ATOMIC_RELAXED);
+        }
+        fprintf(out, "h %s n=%llu p50=%lu p90=%lu p99=%lu max=%lu\n", s_hist_names[i],
+                (unsigned long long)n,
+                (unsigned long)metrics_percentile((metric_hist_t)i, 500),
+                (unsigned long)metrics_percentile((metric_hist_t)i, 900),
+                (unsigned long)metrics_percentile((metric_hist_t)i, 990),
+                (unsigned long)__atomic_load_n(&s_hists[i].max, __ATOMIC_RELAXED));
+    }
+}
+
+void metrics_reset(void)
+{
+    for (int i = 0; i < METRIC_CNT_COUNT; i++) {
+        __atomic_store_n(&s_counters[i], 0, __ATOMIC_RELAXED);
+    }
+    for (int i = 0; i < METRIC_HIST_COUNT; i++) {
+        __atomic_store_n(&s_hists[i].max, 0, __ATOMIC_RELAXED);
+        for (int b = 0; b < METRICS_HIST_BUCKETS; b++) {
+            __atomic_store_n(&s_hists[i].buckets[b], 0, __ATOMIC_RELAXED);
+        }
+    }
+}
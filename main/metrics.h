@@ -0,0 +1,102 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/*
+ * Lightweight metrics registry: counters, gauges and latency histograms.
+ *
+ * All metrics are statically allocated and updated with atomic operations,
+ * so they can be touched from any task or ISR without locks. Histograms use
+ * log-linear buckets: exact below 16, then 4 buckets per power of two
+ * (bucket bounds within 25%) up to 2^32.
+ */
+
+typedef enum {
+    METRIC_CNT_SCANS = 0,
+    METRIC_CNT_SCAN_ERRORS,
+    METRIC_CNT_FRAMES,
+    METRIC_CNT_FLUSHES,
+    METRIC_CNT_TOUCH_READS,
+    METRIC_CNT_LCD_BYTES,   /* Bytes sent to the panel, commands included */
+    METRIC_CNT_HW_SCROLLS,  /* Scroll steps done by the panel (lcd_vscroll.h) */
+    METRIC_CNT_ROGUE_ALERTS, /* Alerts raised by rogue_detect.h */
+    METRIC_CNT_TOUCH_DROPS, /* Touch samples lost to a full ring (touch_sampler.h) */
+    METRIC_CNT_TRACK_SCANS, /* Scans locked to a tracked AP (wifi_track.h), not in SCANS */
+    METRIC_CNT_COUNT,
+} metric_counter_t;
+
+typedef enum {
+    METRIC_GAUGE_SCAN_APS = 0,
+    METRIC_GAUGE_FREE_HEAP,
+    METRIC_GAUGE_MIN_FREE_HEAP,
+    METRIC_GAUGE_COUNT,
+} metric_gauge_t;
+
+typedef enum {
+    METRIC_HIST_SCAN_US = 0,
+    METRIC_HIST_FRAME_US,
+    METRIC_HIST_FLUSH_US,
+    METRIC_HIST_TOUCH_US,
+    METRIC_HIST_LOCK_WAIT_US,
+    METRIC_HIST_GESTURE_US,  /* Deciding touch sample to gesture handled */
+    METRIC_HIST_SCROLL_BYTES, /* Panel bytes per frame that scrolled the list body (lcd_vscroll.h) */
+    METRIC_HIST_TRACK_SCAN_US, /* Scans locked to a tracked AP, not in SCAN_US */
+    METRIC_HIST_COUNT,
+} metric_hist_t;
+
+#define METRICS_HIST_BUCKETS 128
+
+/**
+ * @brief Add to a counter
+ *
+ * @param counter Counter to update
+ * @param n Amount to add
+ */
+void metrics_inc(metric_counter_t counter, uint32_t n);
+
+/**
+ * @brief Set a gauge
+ *
+ * @param gauge Gauge to update
+ * @param value New value
+ */
+void metrics_set(metric_gauge_t gauge, int32_t value);
+
+/**
+ * @brief Record one sample in a histogram
+ *
+ * @param hist Histogram to update
+ * @param value Sample, usually microseconds
+ */
+void metrics_record(metric_hist_t hist, uint32_t value);
+
+/**
+ * @brief Read a counter
+ *
+ * @param counter Counter to read
+ * @return Current value
+ */
+uint32_t metrics_counter(metric_counter_t counter);
+
+/**
+ * @brief Estimate a percentile from a histogram
+ *
+ * @param hist Histogram to read
+ * @param permille Percentile in 1/1000 (500 = p50, 990 = p99)
+ * @return Upper bound of the bucket holding the percentile, 0 if empty
+ */
+uint32_t metrics_percentile(metric_hist_t hist, uint32_t permille);
+
+/**
+ * @brief Print all metrics as compact text, one line per metric
+ *
+ * @param out Stream to print to
+ */
+void metrics_dump(FILE *out);
+
+/**
+ * @brief Clear all counters and histograms
+ */
+void metrics_reset(void);
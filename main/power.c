@@ -0,0 +1,180 @@
+#include "power.h"
+#include "cyd_config.h"
+#include "cyd_hw.h"
+#include "metrics.h"
+
+#include "freertos/FreeRTOS.h"
+
+#include "driver/uart.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_pm.h"
+#include "esp_sleep.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
+
+static const char *TAG = "power";
+
+static const char *const s_state_names[POWER_STATE_COUNT] = {
+    [POWER_STATE_SCAN] = "scan",
+    [POWER_STATE_TRACK] = "track",
+    [POWER_STATE_RENDER] = "render",
+    [POWER_STATE_IDLE] = "idle",
+    [POWER_STATE_SLEEP] = "sleep",
+};
+
+/* Everything below is guarded by s_lock; the sleep callback takes it too */
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static uint64_t s_state_us[POWER_STATE_COUNT];  /* IDLE is derived, not stored */
+static uint64_t s_dimmed_us;
+static int64_t s_dim_start_us;  /* When the backlight dimmed, 0 while bright */
+static int64_t s_reset_us;
+static uint32_t s_reset_scans;
+static uint32_t s_reset_frames;
+static bool s_light_sleep;
+static bool s_idle;
+
+#if CONFIG_PM_LIGHT_SLEEP_CALLBACKS
+static esp_err_t IRAM_ATTR on_light_sleep_exit(int64_t sleep_time_us, void *arg)
+{
+    (void)arg;
+    portENTER_CRITICAL_SAFE(&s_lock);
+    s_state_us[POWER_STATE_SLEEP] += (uint64_t)sleep_time_us;
+    portEXIT_CRITICAL_SAFE(&s_lock);
+    return ESP_OK;
+}
+#endif
+
+esp_err_t power_init(void)
+{
+    s_reset_us = esp_timer_get_time();
+
+    esp_pm_config_t pm_config = {
+        .max_freq_mhz = POWER_CPU_MAX_MHZ,
+        .min_freq_mhz = POWER_CPU_MIN_MHZ,
+        .light_sleep_enable = true,
+    };
+    esp_err_t ret = esp_pm_configure(&pm_config);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to configure power management: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    s_light_sleep = true;
+
+#if CONFIG_PM_LIGHT_SLEEP_CALLBACKS
+    esp_pm_sleep_cbs_register_config_t cbs = {
+        .exit_cb = on_light_sleep_exit,
+    };
+    ret = esp_pm_light_sleep_register_cbs(&cbs);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to register sleep callback, sleep time not measured: %s", esp_err_to_name(ret));
+    }
+#else
+    ESP_LOGW(TAG, "CONFIG_PM_LIGHT_SLEEP_CALLBACKS is off, sleep time not measured");
+#endif
+
+#ifdef CONFIG_ESP_CONSOLE_UART_NUM
+    /* A few edges on RX wake the chip; those characters are lost */
+    if (CONSOLE_ENABLE) {
+        uart_set_wakeup_threshold(CONFIG_ESP_CONSOLE_UART_NUM, 3);
+        esp_sleep_enable_uart_wakeup(CONFIG_ESP_CONSOLE_UART_NUM);
+    }
+#endif
+
+    ESP_LOGI(TAG, "DFS %d-%d MHz, automatic light sleep on", POWER_CPU_MIN_MHZ, POWER_CPU_MAX_MHZ);
+    return ESP_OK;
+}
+
+void power_add_time(power_state_t state, uint32_t us)
+{
+    if (state != POWER_STATE_SCAN && state != POWER_STATE_TRACK && state != POWER_STATE_RENDER) {
+        return;
+    }
+    portENTER_CRITICAL_SAFE(&s_lock);
+    s_state_us[state] += us;
+    portEXIT_CRITICAL_SAFE(&s_lock);
+}
+
+bool power_update_idle(uint32_t inactive_ms)
+{
+    bool idle = BACKLIGHT_DIM_AFTER_MS > 0 && inactive_ms >= BACKLIGHT_DIM_AFTER_MS;
+    if (idle == s_idle) {
+        return false;
+    }
+    s_idle = idle;
+    cyd_hw_set_backlight(idle ? BACKLIGHT_DIM_PCT : 100);
+
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL_SAFE(&s_lock);
+    if (idle) {
+        s_dim_start_us = now;
+    } else {
+        s_dimmed_us += (uint64_t)(now - s_dim_start_us);
+        s_dim_start_us = 0;
+    }
+    portEXIT_CRITICAL_SAFE(&s_lock);
+    return true;
+}
+
+bool power_is_idle(void)
+{
+    return s_idle;
+}
+
+void power_get_stats(power_stats_t *out)
+{
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL_SAFE(&s_lock);
+    out->uptime_us = (uint64_t)(now - s_reset_us);
+    for (int i = 0; i < POWER_STATE_COUNT; i++) {
+        out->state_us[i] = s_state_us[i];
+    }
+    out->dimmed_us = s_dimmed_us + (s_dim_start_us ? (uint64_t)(now - s_dim_start_us) : 0);
+    portEXIT_CRITICAL_SAFE(&s_lock);
+
+    out->scans = metrics_counter(METRIC_CNT_SCANS) - s_reset_scans;
+    out->frames = metrics_counter(METRIC_CNT_FRAMES) - s_reset_frames;
+    out->light_sleep = s_light_sleep;
+
+    /* Scan and render can overlap on the two cores; idle never goes negative */
+    uint64_t awake = out->uptime_us > out->state_us[POWER_STATE_SLEEP]
+                         ? out->uptime_us - out->state_us[POWER_STATE_SLEEP] : 0;
+    uint64_t busy = out->state_us[POWER_STATE_SCAN] + out->state_us[POWER_STATE_TRACK] +
+                    out->state_us[POWER_STATE_RENDER];
+    out->state_us[POWER_STATE_IDLE] = awake > busy ? awake - busy : 0;
+
+    /* mA x us, converted to mAh (3.6e9 mA us) and to the average */
+    float charge = (float)(out->state_us[POWER_STATE_SCAN] + out->state_us[POWER_STATE_TRACK]) * POWER_MA_SCAN +
+                   (float)out->state_us[POWER_STATE_RENDER] * POWER_MA_RENDER +
+                   (float)out->state_us[POWER_STATE_IDLE] * POWER_MA_IDLE +
+                   (float)out->state_us[POWER_STATE_SLEEP] * POWER_MA_SLEEP +
+                   (float)(out->uptime_us - out->dimmed_us) * POWER_MA_BACKLIGHT +
+                   (float)out->dimmed_us * (POWER_MA_BACKLIGHT * BACKLIGHT_DIM_PCT / 100.0f);
+    out->charge_mah = charge / 3.6e9f;
+    out->avg_ma = out->uptime_us ? charge / (float)out->uptime_us : 0.0f;
+}
+
+void power_reset_stats(void)
+{
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL_SAFE(&s_lock);
+    for (int i = 0; i < POWER_STATE_COUNT; i++) {
+        s_state_us[i] = 0;
+    }
+    s_dimmed_us = 0;
+    if (s_dim_start_us) {
+        s_dim_start_us = now;
+    }
+    s_reset_us = now;
+    portEXIT_CRITICAL_SAFE(&s_lock);
+
+    s_reset_scans = metrics_counter(METRIC_CNT_SCANS);
+    s_reset_frames = metrics_counter(METRIC_CNT_FRAMES);
+}
+
+const char *power_state_name(power_state_t state)
+{
+    return (state < POWER_STATE_COUNT) ? s_state_names[state] : "?";
+}
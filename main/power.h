@@ -0,0 +1,96 @@
+#pragma once
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Power management and duty-cycle accounting.
+ *
+ * power_init() turns on dynamic frequency scaling and automatic light sleep
+ * (esp_pm; needs CONFIG_PM_ENABLE and tickless idle, see sdkconfig.defaults)
+ * and lets the console UART wake the chip. The backlight dims after a period
+ * without touch input.
+ *
+ * Time is accounted per state: scanning (full sweeps and tracking scans
+ * apart) and rendering are reported by the scan task and the LVGL loop,
+ * light sleep comes from the esp_pm sleep callbacks and idle is what is
+ * left. The charge estimate multiplies those times by the POWER_MA_*
+ * currents in cyd_config.h, so it is only as good as those figures; measure
+ * the board once and set them.
+ */
+
+typedef enum {
+    POWER_STATE_SCAN = 0,  /* Radio sweeping */
+    POWER_STATE_TRACK,     /* Radio in scans locked to a tracked AP (wifi_track.h) */
+    POWER_STATE_RENDER,    /* LVGL rendering and flushing a frame */
+    POWER_STATE_IDLE,      /* Awake otherwise */
+    POWER_STATE_SLEEP,     /* Automatic light sleep */
+    POWER_STATE_COUNT,
+} power_state_t;
+
+typedef struct {
+    uint64_t uptime_us;                     /* Since the last reset */
+    uint64_t state_us[POWER_STATE_COUNT];
+    uint64_t dimmed_us;                     /* Backlight at BACKLIGHT_DIM_PCT */
+    uint32_t scans;                         /* Full sweeps since the last reset */
+    uint32_t frames;                        /* Rendered frames since the last reset */
+    float avg_ma;                           /* Estimated average current */
+    float charge_mah;                       /* Estimated charge used */
+    bool light_sleep;                       /* Light sleep is configured */
+} power_stats_t;
+
+/**
+ * @brief Configure DFS, light sleep and console wakeup
+ *
+ * The backlight must already be initialized. Without CONFIG_PM_ENABLE the
+ * CPU keeps its fixed frequency but accounting and dimming still work.
+ *
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t power_init(void);
+
+/**
+ * @brief Account time spent in a busy state
+ *
+ * @param state POWER_STATE_SCAN, POWER_STATE_TRACK or POWER_STATE_RENDER
+ * @param us Duration in microseconds
+ */
+void power_add_time(power_state_t state, uint32_t us);
+
+/**
+ * @brief Dim or restore the backlight from the input inactivity time
+ *
+ * Call periodically from the LVGL loop.
+ *
+ * @param inactive_ms Time since the last touch input
+ * @return true if the idle (dimmed) state changed
+ */
+bool power_update_idle(uint32_t inactive_ms);
+
+/**
+ * @brief Check whether the display is dimmed for inactivity
+ *
+ * @return true while idle
+ */
+bool power_is_idle(void);
+
+/**
+ * @brief Get time per state and the charge estimate since the last reset
+ *
+ * @param[out] out Stats to fill
+ */
+void power_get_stats(power_stats_t *out);
+
+/**
+ * @brief Restart accounting from now
+ */
+void power_reset_stats(void);
+
+/**
+ * @brief Get a state's display name
+ *
+ * @param state State
+ * @return Name
+ */
+const char *power_state_name(power_state_t state);
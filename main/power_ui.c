@@ -0,0 +1,123 @@
+#include "power_ui.h"
+#include "power.h"
+
+#include <stdio.h>
+
+#define POWER_UI_REFRESH_MS 1000
+
+static lv_obj_t *s_stats_label = NULL;
+static lv_timer_t *s_refresh_timer = NULL;
+
+static void create_power_ui(lv_obj_t *screen);
+static void destroy_power_ui(void);
+static void refresh_cb(lv_timer_t *timer);
+
+const ui_view_t power_ui_view = {
+    .name = "power",
+    .create = create_power_ui,
+    .destroy = destroy_power_ui,
+};
+
+static void exit_button_event_cb(lv_event_t *e)
+{
+    if (lv_event_get_code(e) == LV_EVENT_CLICKED) {
+        ui_show_home();
+    }
+}
+
+static void reset_button_event_cb(lv_event_t *e)
+{
+    if (lv_event_get_code(e) == LV_EVENT_CLICKED) {
+        power_reset_stats();
+        refresh_cb(NULL);
+    }
+}
+
+static lv_obj_t *create_header_button(lv_obj_t *parent, const char *text, lv_color_t color, lv_event_cb_t cb)
+{
+    lv_obj_t *button = lv_button_create(parent);
+    lv_obj_set_size(button, 60, 30);
+    lv_obj_set_style_bg_color(button, color, LV_PART_MAIN);
+    lv_obj_add_event_cb(button, cb, LV_EVENT_CLICKED, NULL);
+
+    lv_obj_t *label = lv_label_create(button);
+    lv_label_set_text(label, text);
+    lv_obj_center(label);
+    lv_obj_set_style_text_color(label, lv_color_white(), 0);
+    return button;
+}
+
+static void create_power_ui(lv_obj_t *screen)
+{
+    lv_obj_set_style_bg_color(screen, lv_color_make(20, 20, 40), 0);
+    lv_obj_set_style_pad_all(screen, 10, 0);
+    lv_obj_set_flex_flow(screen, LV_FLEX_FLOW_COLUMN);
+    lv_obj_set_style_pad_row(screen, 8, 0);
+
+    lv_obj_t *header = lv_obj_create(screen);
+    lv_obj_set_size(header, LV_PCT(100), LV_SIZE_CONTENT);
+    lv_obj_set_style_bg_opa(header, LV_OPA_TRANSP, 0);
+    lv_obj_set_style_border_width(header, 0, 0);
+    lv_obj_set_style_pad_all(header, 0, 0);
+    lv_obj_set_flex_flow(header, LV_FLEX_FLOW_ROW);
+    lv_obj_set_flex_align(header, LV_FLEX_ALIGN_SPACE_BETWEEN, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+
+    create_header_button(header, "Exit", lv_color_make(200, 0, 0), exit_button_event_cb);
+
+    lv_obj_t *title = lv_label_create(header);
+    lv_label_set_text(title, "Power");
+    lv_obj_set_style_text_color(title, lv_color_white(), 0);
+    lv_obj_set_style_text_font(title, &lv_font_montserrat_16, 0);
+
+    create_header_button(header, "Reset", lv_color_make(0, 120, 200), reset_button_event_cb);
+
+    s_stats_label = lv_label_create(screen);
+    lv_obj_set_style_text_color(s_stats_label, lv_color_white(), 0);
+    lv_obj_set_width(s_stats_label, LV_PCT(100));
+
+    s_refresh_timer = lv_timer_create(refresh_cb, POWER_UI_REFRESH_MS, NULL);
+    refresh_cb(NULL);
+}
+
+static void destroy_power_ui(void)
+{
+    if (s_refresh_timer) {
+        lv_timer_delete(s_refresh_timer);
+        s_refresh_timer = NULL;
+    }
+    s_stats_label = NULL;
+}
+
+/* Runs in LVGL context */
+static void refresh_cb(lv_timer_t *timer)
+{
+    (void)timer;
+    if (!s_stats_label) {
+        return;
+    }
+
+    power_stats_t stats;
+    power_get_stats(&stats);
+    float uptime_s = (float)stats.uptime_us / 1e6f;
+
+    char buf[384];
+    int len = snprintf(buf, sizeof(buf), "Over %.0f s, light sleep %s\n", uptime_s,
+                       stats.light_sleep ? "on" : "off");
+    for (int i = 0; i < POWER_STATE_COUNT && len < (int)sizeof(buf); i++) {
+        float s = (float)stats.state_us[i] / 1e6f;
+        len += snprintf(buf + len, sizeof(buf) - (size_t)len, "%s: %.1f s (%.1f%%)\n",
+                        power_state_name((power_state_t)i), s, uptime_s > 0 ? 100.0f * s / uptime_s : 0.0f);
+    }
+    if (len < (int)sizeof(buf)) {
+        float mah = stats.charge_mah;
+        len += snprintf(buf + len, sizeof(buf) - (size_t)len,
+                        "dimmed: %.1f s\n"
+                        "est. %.1f mA avg, %.2f mAh\n"
+                        "%lu sweeps, %.0f per mAh\n"
+                        "%lu frames, %.0f per mAh",
+                        (float)stats.dimmed_us / 1e6f, stats.avg_ma, mah,
+                        (unsigned long)stats.scans, mah > 0 ? stats.scans / mah : 0.0f,
+                        (unsigned long)stats.frames, mah > 0 ? stats.frames / mah : 0.0f);
+    }
+    lv_label_set_text(s_stats_label, buf);
+}
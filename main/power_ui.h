@@ -0,0 +1,7 @@
+#pragma once
+
+#include "ui.h"
+
+/* Power page: time per state, backlight and the charge estimate from
+ * power.h, refreshed every second. Shown with ui_show_view(&power_ui_view). */
+extern const ui_view_t power_ui_view;
@@ -0,0 +1,247 @@
+#include "rogue_detect.h"
+
+#include <string.h>
+
+#define FNV_OFFSET 2166136261u
+#define FNV_PRIME 16777619u
+
+typedef struct {
+    uint8_t bssid[6];
+    uint8_t channel;
+    int8_t rssi;
+    uint8_t alerts;      /* Sticky ROGUE_ALERT_BIT()s already raised */
+    uint8_t used;
+    uint16_t last_sweep; /* Sweep it was last seen in, low bits */
+} rogue_bssid_t;
+
+typedef struct {
+    uint32_t hash;       /* 0 marks a free slot */
+    uint32_t last_sweep;
+    uint8_t sweeps_seen; /* Saturates at ROGUE_TRUST_SWEEPS */
+    uint8_t max_rank;    /* Strongest security seen */
+    bool overflowed;     /* More BSSIDs than fit: new ones are not alerted */
+    char ssid[33];
+    rogue_bssid_t bssids[ROGUE_MAX_BSSIDS];
+} rogue_ssid_t;
+
+static const char *const s_alert_names[ROGUE_ALERT_COUNT] = {
+    [ROGUE_ALERT_WEAK_SECURITY] = "weak_security",
+    [ROGUE_ALERT_NEW_BSSID] = "new_bssid",
+    [ROGUE_ALERT_CHANNEL] = "channel",
+    [ROGUE_ALERT_RSSI_JUMP] = "rssi_jump",
+};
+
+/* Scan task only, except the stats read by the console */
+static rogue_ssid_t s_index[ROGUE_INDEX_SLOTS];
+static uint32_t s_sweep = 1;  /* 0 is never a sweep */
+static rogue_stats_t s_stats;
+static bool s_reset_requested;
+
+static rogue_alert_callback_t s_callback;
+static void *s_callback_arg;
+
+static uint32_t ssid_hash(const char *ssid)
+{
+    uint32_t hash = FNV_OFFSET;
+    for (const char *c = ssid; *c; c++) {
+        hash = (hash ^ (uint8_t)*c) * FNV_PRIME;
+    }
+    return hash ? hash : 1;
+}
+
+uint8_t rogue_security_rank(wifi_auth_mode_t authmode)
+{
+    /* Mixed modes rank as their weakest member, since that is what a client
+     * can be talked into */
+    switch (authmode) {
+        case WIFI_AUTH_OPEN: return 0;
+        case WIFI_AUTH_WEP: return 1;
+        case WIFI_AUTH_WPA_PSK: return 2;
+        case WIFI_AUTH_WPA_WPA2_PSK: return 2;
+        case WIFI_AUTH_WPA2_PSK: return 3;
+        case WIFI_AUTH_WPA2_WPA3_PSK: return 3;
+        case WIFI_AUTH_ENTERPRISE: return 4;
+        case WIFI_AUTH_WPA3_PSK: return 4;
+        default: return 3;
+    }
+}
+
+/* Find the SSID's slot, or claim one for it; NULL if none is free or stale */
+static rogue_ssid_t *lookup_ssid(const char *ssid, uint32_t hash)
+{
+    rogue_ssid_t *victim = NULL;
+    for (uint32_t i = 0; i < ROGUE_MAX_PROBE; i++) {
+        rogue_ssid_t *entry = &s_index[(hash + i) & (ROGUE_INDEX_SLOTS - 1)];
+        if (entry->hash == hash && strcmp(entry->ssid, ssid) == 0) {
+            return entry;
+        }
+        if (entry->hash == 0) {
+            /* Nothing is ever removed, so the SSID is not further on */
+            victim = entry;
+            break;
+        }
+        if (s_sweep - entry->last_sweep > ROGUE_EVICT_AFTER_SWEEPS &&
+            (!victim || entry->last_sweep < victim->last_sweep)) {
+            victim = entry;
+        }
+    }
+    if (!victim) {
+        return NULL;
+    }
+
+    memset(victim, 0, sizeof(*victim));
+    victim->hash = hash;
+    memcpy(victim->ssid, ssid, strnlen(ssid, sizeof(victim->ssid) - 1));
+    return victim;
+}
+
+static void raise_alert(rogue_alert_type_t type, const wifi_ap_info_t *ap, int before)
+{
+    s_stats.alerts[type]++;
+    if (!s_callback) {
+        return;
+    }
+    rogue_alert_t alert = {
+        .type = type,
+        .channel = ap->channel,
+        .rssi = ap->rssi,
+        .before = (int8_t)before,
+    };
+    memcpy(alert.ssid, ap->ssid, sizeof(alert.ssid));
+    memcpy(alert.bssid, ap->bssid, sizeof(alert.bssid));
+    s_callback(&alert, s_callback_arg);
+}
+
+/* Raise a once-per-BSSID alert unless it already was */
+static void raise_sticky(rogue_bssid_t *known, rogue_alert_type_t type, const wifi_ap_info_t *ap, int before)
+{
+    if (known->alerts & ROGUE_ALERT_BIT(type)) {
+        return;
+    }
+    known->alerts |= ROGUE_ALERT_BIT(type);
+    raise_alert(type, ap, before);
+}
+
+uint8_t rogue_detect_record(const wifi_ap_info_t *ap)
+{
+    if (ap->ssid[0] == '\0') {
+        return 0;
+    }
+    s_stats.records++;
+
+    rogue_ssid_t *entry = lookup_ssid(ap->ssid, ssid_hash(ap->ssid));
+    if (!entry) {
+        s_stats.unindexed++;
+        return 0;
+    }
+    if (entry->last_sweep != s_sweep) {
+        entry->last_sweep = s_sweep;
+        if (entry->sweeps_seen < ROGUE_TRUST_SWEEPS) {
+            entry->sweeps_seen++;
+        }
+    }
+    bool trusted = entry->sweeps_seen >= ROGUE_TRUST_SWEEPS;
+    uint16_t sweep = (uint16_t)s_sweep;
+
+    /* Known BSSID, else a free slot, else the one seen longest ago */
+    rogue_bssid_t *known = NULL;
+    rogue_bssid_t *slot = NULL;
+    for (int i = 0; i < ROGUE_MAX_BSSIDS; i++) {
+        rogue_bssid_t *b = &entry->bssids[i];
+        if (!b->used) {
+            if (!slot || slot->used) {
+                slot = b;
+            }
+        } else if (memcmp(b->bssid, ap->bssid, sizeof(b->bssid)) == 0) {
+            known = b;
+            break;
+        } else if (!slot || (slot->used && (uint16_t)(sweep - b->last_sweep) >
+                                           (uint16_t)(sweep - slot->last_sweep))) {
+            slot = b;
+        }
+    }
+
+    uint8_t jump = 0;
+    if (!known) {
+        bool alert = trusted && !entry->overflowed;
+        if (slot->used) {
+            entry->overflowed = true;
+        }
+        memset(slot, 0, sizeof(*slot));
+        memcpy(slot->bssid, ap->bssid, sizeof(slot->bssid));
+        slot->channel = ap->channel;
+        slot->rssi = ap->rssi;
+        slot->used = 1;
+        known = slot;
+        if (alert) {
+            raise_sticky(known, ROGUE_ALERT_NEW_BSSID, ap, 0);
+        }
+    } else if (trusted) {
+        if (known->channel != ap->channel) {
+            raise_sticky(known, ROGUE_ALERT_CHANNEL, ap, known->channel);
+        }
+        /* Only against the previous sweep; after a gap anything goes */
+        int delta = ap->rssi - known->rssi;
+        if ((uint16_t)(sweep - known->last_sweep) == 1 &&
+            (delta >= ROGUE_RSSI_JUMP_DB || -delta >= ROGUE_RSSI_JUMP_DB)) {
+            jump = ROGUE_ALERT_BIT(ROGUE_ALERT_RSSI_JUMP);
+            raise_alert(ROGUE_ALERT_RSSI_JUMP, ap, known->rssi);
+        }
+    }
+
+    uint8_t rank = rogue_security_rank(ap->authmode);
+    if (trusted && rank < entry->max_rank) {
+        raise_sticky(known, ROGUE_ALERT_WEAK_SECURITY, ap, entry->max_rank);
+    }
+    if (rank > entry->max_rank) {
+        entry->max_rank = rank;
+    }
+
+    known->channel = ap->channel;
+    known->rssi = ap->rssi;
+    known->last_sweep = sweep;
+    return known->alerts | jump;
+}
+
+void rogue_detect_end_sweep(void)
+{
+    if (__atomic_exchange_n(&s_reset_requested, false, __ATOMIC_ACQ_REL)) {
+        memset(s_index, 0, sizeof(s_index));
+        memset(&s_stats, 0, sizeof(s_stats));
+        s_sweep = 1;
+        return;
+    }
+    s_sweep++;
+    s_stats.sweeps++;
+}
+
+void rogue_detect_reset(void)
+{
+    __atomic_store_n(&s_reset_requested, true, __ATOMIC_RELEASE);
+}
+
+void rogue_detect_set_callback(rogue_alert_callback_t callback, void *arg)
+{
+    s_callback_arg = arg;
+    s_callback = callback;
+}
+
+void rogue_detect_get_stats(rogue_stats_t *out)
+{
+    *out = s_stats;
+    out->ssids = 0;
+    out->trusted = 0;
+    for (int i = 0; i < ROGUE_INDEX_SLOTS; i++) {
+        if (s_index[i].hash != 0) {
+            out->ssids++;
+            if (s_index[i].sweeps_seen >= ROGUE_TRUST_SWEEPS) {
+                out->trusted++;
+            }
+        }
+    }
+}
+
+const char *rogue_alert_name(rogue_alert_type_t type)
+{
+    return (type < ROGUE_ALERT_COUNT) ? s_alert_names[type] : "?";
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "wifi_scanner.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Rogue AP and evil-twin detection over the scan stream.
+ *
+ * A fixed-size hash index keyed by SSID remembers, per network, the best
+ * security mode it has been seen with and up to ROGUE_MAX_BSSIDS BSSIDs with
+ * their channel and last RSSI. Every scan record is checked against it as it
+ * arrives, with a bounded probe and a bounded BSSID list, so the cost per
+ * record is constant and the memory is the static table (about 6 KB).
+ *
+ * An SSID becomes trusted after it has been seen in ROGUE_TRUST_SWEEPS
+ * sweeps; only trusted SSIDs raise alerts, so the first sweeps after boot
+ * (or after moving somewhere new) are a learning phase. When the table is
+ * full, SSIDs not seen for ROGUE_EVICT_AFTER_SWEEPS are replaced; otherwise
+ * the new SSID is left unindexed and counted. No driver calls, so the
+ * detector also builds on the host.
+ */
+
+#define ROGUE_INDEX_SLOTS 64          /* SSID slots, a power of two */
+#define ROGUE_MAX_PROBE 8             /* Slots tried per lookup */
+#define ROGUE_MAX_BSSIDS 4            /* BSSIDs remembered per SSID */
+#define ROGUE_TRUST_SWEEPS 5          /* Sweeps an SSID is seen in before it is trusted */
+#define ROGUE_EVICT_AFTER_SWEEPS 30   /* Unseen this long, an SSID may be replaced */
+#define ROGUE_RSSI_JUMP_DB 20         /* RSSI change between consecutive sweeps that is suspicious */
+
+typedef enum {
+    ROGUE_ALERT_WEAK_SECURITY = 0,  /* Trusted SSID offered with weaker security than before */
+    ROGUE_ALERT_NEW_BSSID,          /* Unknown BSSID for a trusted SSID */
+    ROGUE_ALERT_CHANNEL,            /* Known BSSID moved to another channel */
+    ROGUE_ALERT_RSSI_JUMP,          /* Known BSSID jumped by ROGUE_RSSI_JUMP_DB or more */
+    ROGUE_ALERT_COUNT,
+} rogue_alert_type_t;
+
+#define ROGUE_ALERT_BIT(type) (1u << (type))
+
+typedef struct {
+    rogue_alert_type_t type;
+    char ssid[33];
+    uint8_t bssid[6];
+    uint8_t channel;
+    int8_t rssi;
+    int8_t before;  /* Security rank, channel or RSSI previously known, by type */
+} rogue_alert_t;
+
+/* Called in the scan task for each alert; must not block for long */
+typedef void (*rogue_alert_callback_t)(const rogue_alert_t *alert, void *arg);
+
+typedef struct {
+    uint32_t sweeps;
+    uint32_t records;
+    uint32_t ssids;      /* Indexed SSIDs */
+    uint32_t trusted;    /* Of which trusted */
+    uint32_t unindexed;  /* Records whose SSID found no slot */
+    uint32_t alerts[ROGUE_ALERT_COUNT];
+} rogue_stats_t;
+
+/**
+ * @brief Set the callback run for each alert
+ *
+ * @param callback Callback, NULL for none
+ * @param arg Passed to the callback
+ */
+void rogue_detect_set_callback(rogue_alert_callback_t callback, void *arg);
+
+/**
+ * @brief Check one scan record and learn from it (scan task only)
+ *
+ * Records with a hidden SSID are ignored.
+ *
+ * @param ap Record of the current sweep
+ * @return ROGUE_ALERT_BIT()s standing for this BSSID: the ones raised once
+ *         per BSSID plus an RSSI jump in this record
+ */
+uint8_t rogue_detect_record(const wifi_ap_info_t *ap);
+
+/**
+ * @brief Finish a sweep (scan task only)
+ */
+void rogue_detect_end_sweep(void);
+
+/**
+ * @brief Forget everything learned, at the end of the current sweep
+ *
+ * Safe to call from any task.
+ */
+void rogue_detect_reset(void);
+
+/**
+ * @brief Get counters and index occupancy
+ *
+ * @param[out] out Stats
+ */
+void rogue_detect_get_stats(rogue_stats_t *out);
+
+/**
+ * @brief Get an alert type's display name
+ *
+ * @param type Alert type
+ * @return Name
+ */
+const char *rogue_alert_name(rogue_alert_type_t type);
+
+/**
+ * @brief Rank an auth mode by strength, for comparisons and logs
+ *
+ * @param authmode Auth mode
+ * @return 0 (open) to 4 (WPA3 or enterprise)
+ */
+uint8_t rogue_security_rank(wifi_auth_mode_t authmode);
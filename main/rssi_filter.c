@@ -0,0 +1,154 @@
+#include "rssi_filter.h"
+
+#include <string.h>
+
+#define RSSI_FILTER_MAX_TRACKED 32   /* BSSIDs tracked across sweeps */
+#define RSSI_FILTER_MAX_MISSED 3     /* Sweeps a BSSID may be missing before it is dropped */
+#define RSSI_FILTER_FAST_SHIFT 2     /* Displayed estimate: alpha = 1/4 */
+#define RSSI_FILTER_SLOW_SHIFT 4     /* Trend baseline: alpha = 1/16 */
+#define RSSI_FILTER_STATE_Q 8        /* Estimates keep 4 more fraction bits than they report */
+#define RSSI_FILTER_EXTRA_Q (RSSI_FILTER_STATE_Q - RSSI_FILTER_Q)
+#define RSSI_TREND_ENTER_Q4 24       /* 1.5 dB between fast and slow estimate starts a trend */
+#define RSSI_TREND_EXIT_Q4 8         /* 0.5 dB ends it again */
+#define RSSI_RANK_NONE 0xFF
+
+typedef struct {
+    uint8_t bssid[6];
+    bool used;
+    bool seen;          /* Updated during the current sweep */
+    uint8_t missed;     /* Consecutive sweeps without a reading */
+    uint8_t rank;
+    int32_t fast_q8;
+    int32_t slow_q8;
+    rssi_trend_t trend;
+} rssi_track_t;
+
+static rssi_track_t s_tracks[RSSI_FILTER_MAX_TRACKED];
+
+static rssi_track_t *find_track(const uint8_t bssid[6])
+{
+    for (int i = 0; i < RSSI_FILTER_MAX_TRACKED; i++) {
+        if (s_tracks[i].used && memcmp(s_tracks[i].bssid, bssid, 6) == 0) {
+            return &s_tracks[i];
+        }
+    }
+    return NULL;
+}
+
+static rssi_track_t *alloc_track(void)
+{
+    rssi_track_t *victim = NULL;
+
+    for (int i = 0; i < RSSI_FILTER_MAX_TRACKED; i++) {
+        rssi_track_t *t = &s_tracks[i];
+        if (!t->used) {
+            return t;
+        }
+        /* Never evict a BSSID that was already seen in this sweep */
+        if (t->seen) {
+            continue;
+        }
+        if (!victim || t->missed > victim->missed ||
+            (t->missed == victim->missed && t->fast_q8 < victim->fast_q8)) {
+            victim = t;
+        }
+    }
+    return victim;
+}
+
+/* Shift right rounding half away from zero. A plain >> rounds toward -inf,
+ * which leaves an EWMA settled below a steady signal. */
+static int32_t shift_round(int32_t v, int shift)
+{
+    int32_t half = 1 << (shift - 1);
+    return (v >= 0) ? (v + half) >> shift : -((-v + half) >> shift);
+}
+
+static rssi_trend_t next_trend(rssi_trend_t trend, int32_t diff_q8)
+{
+    int32_t diff_q4 = shift_round(diff_q8, RSSI_FILTER_EXTRA_Q);
+
+    switch (trend) {
+        case RSSI_TREND_RISING:
+            return (diff_q4 < RSSI_TREND_EXIT_Q4) ? RSSI_TREND_FLAT : trend;
+        case RSSI_TREND_FALLING:
+            return (diff_q4 > -RSSI_TREND_EXIT_Q4) ? RSSI_TREND_FLAT : trend;
+        default:
+            if (diff_q4 >= RSSI_TREND_ENTER_Q4) return RSSI_TREND_RISING;
+            if (diff_q4 <= -RSSI_TREND_ENTER_Q4) return RSSI_TREND_FALLING;
+            return RSSI_TREND_FLAT;
+    }
+}
+
+void rssi_filter_reset(void)
+{
+    memset(s_tracks, 0, sizeof(s_tracks));
+}
+
+void rssi_filter_update(const uint8_t bssid[6], int8_t rssi, rssi_filter_state_t *out_state)
+{
+    int16_t sample_q4 = (int16_t)(rssi * (1 << RSSI_FILTER_Q));
+    int32_t sample_q8 = (int32_t)rssi * (1 << RSSI_FILTER_STATE_Q);
+    rssi_track_t *t = find_track(bssid);
+
+    if (!t) {
+        t = alloc_track();
+        if (!t) {
+            /* Table is full of BSSIDs from this sweep: pass the raw value through */
+            if (out_state) {
+                out_state->rssi_q4 = sample_q4;
+                out_state->trend = RSSI_TREND_FLAT;
+                out_state->rank = RSSI_RANK_NONE;
+            }
+            return;
+        }
+        memset(t, 0, sizeof(*t));
+        memcpy(t->bssid, bssid, 6);
+        t->used = true;
+        t->rank = RSSI_RANK_NONE;
+        t->fast_q8 = sample_q8;
+        t->slow_q8 = sample_q8;
+        t->trend = RSSI_TREND_FLAT;
+    } else {
+        /* EWMA in fixed point: est += (sample - est) * alpha, rounded
+         * symmetrically so a steady signal is approached from either side */
+        t->fast_q8 += shift_round(sample_q8 - t->fast_q8, RSSI_FILTER_FAST_SHIFT);
+        t->slow_q8 += shift_round(sample_q8 - t->slow_q8, RSSI_FILTER_SLOW_SHIFT);
+        t->trend = next_trend(t->trend, t->fast_q8 - t->slow_q8);
+    }
+
+    t->seen = true;
+    t->missed = 0;
+
+    if (out_state) {
+        out_state->rssi_q4 = (int16_t)shift_round(t->fast_q8, RSSI_FILTER_EXTRA_Q);
+        out_state->trend = t->trend;
+        out_state->rank = t->rank;
+    }
+}
+
+void rssi_filter_set_rank(const uint8_t bssid[6], uint8_t rank)
+{
+    rssi_track_t *t = find_track(bssid);
+    if (t) {
+        t->rank = rank;
+    }
+}
+
+void rssi_filter_end_sweep(void)
+{
+    for (int i = 0; i < RSSI_FILTER_MAX_TRACKED; i++) {
+        rssi_track_t *t = &s_tracks[i];
+        if (!t->used) {
+            continue;
+        }
+        if (t->seen) {
+            t->seen = false;
+            continue;
+        }
+        t->rank = RSSI_RANK_NONE;
+        if (++t->missed > RSSI_FILTER_MAX_MISSED) {
+            t->used = false;
+        }
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Smoothed RSSI is kept in Q4 fixed point (1/16 dBm) */
+#define RSSI_FILTER_Q 4
+
+/* Per-BSSID signal trend */
+typedef enum {
+    RSSI_TREND_FLAT = 0,
+    RSSI_TREND_RISING,
+    RSSI_TREND_FALLING,
+} rssi_trend_t;
+
+/* Filter state returned for one BSSID */
+typedef struct {
+    int16_t rssi_q4;   /* Smoothed RSSI in 1/16 dBm */
+    rssi_trend_t trend;
+    uint8_t rank;      /* Display rank from the previous sweep, 0xFF if unranked */
+} rssi_filter_state_t;
+
+/**
+ * @brief Clear all tracked BSSIDs
+ */
+void rssi_filter_reset(void);
+
+/**
+ * @brief Feed one raw RSSI reading for a BSSID
+ *
+ * The first reading seeds the estimate; later readings are blended in with
+ * a fixed-point EWMA. Unknown BSSIDs replace the stalest tracked entry when
+ * the table is full.
+ *
+ * @param[in] bssid 6-byte BSSID
+ * @param[in] rssi Raw RSSI in dBm from the current sweep
+ * @param[out] out_state Smoothed state after the update
+ */
+void rssi_filter_update(const uint8_t bssid[6], int8_t rssi, rssi_filter_state_t *out_state);
+
+/**
+ * @brief Store the display rank assigned to a BSSID in this sweep
+ *
+ * @param[in] bssid 6-byte BSSID
+ * @param[in] rank Row index the BSSID was placed at
+ */
+void rssi_filter_set_rank(const uint8_t bssid[6], uint8_t rank);
+
+/**
+ * @brief Finish a sweep: age out BSSIDs that were not seen
+ *
+ * BSSIDs missing for several consecutive sweeps are dropped, and the ranks
+ * of BSSIDs missing in this sweep are cleared.
+ */
+void rssi_filter_end_sweep(void);
+
+/**
+ * @brief Round a Q4 RSSI value to whole dBm
+ *
+ * @param[in] rssi_q4 RSSI in 1/16 dBm
+ * @return RSSI in dBm
+ */
+static inline int rssi_filter_to_dbm(int16_t rssi_q4)
+{
+    return (rssi_q4 >= 0) ? ((rssi_q4 + (1 << (RSSI_FILTER_Q - 1))) >> RSSI_FILTER_Q)
+                          : -((-rssi_q4 + (1 << (RSSI_FILTER_Q - 1))) >> RSSI_FILTER_Q);
+}
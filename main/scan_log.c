@@ -0,0 +1,95 @@
+#include "scan_log.h"
+#include "cyd_config.h"
+#include "scan_log_file.h"
+#include "scan_results.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "esp_log.h"
+#include "esp_timer.h"
+
+static const char *TAG = "scan_log";
+
+_Static_assert(SCAN_LOG_MAX_FILES < SCAN_LOG_INDEX_MAX / 2, "renumbering needs room below the kept files");
+
+static TaskHandle_t s_task;
+static scan_log_file_t s_log;  /* Writer-task state */
+
+/* Ticks until the partial block is due to be written, portMAX_DELAY if none */
+static TickType_t flush_wait_ticks(void)
+{
+    int64_t due_us = scan_log_file_flush_due_us(&s_log, esp_timer_get_time());
+    if (due_us < 0) {
+        return portMAX_DELAY;
+    }
+    return (due_us > 0) ? pdMS_TO_TICKS((due_us + 999) / 1000) : 0;
+}
+
+/* Runs in the scan task; only wakes the writer */
+static void on_sweep_published(void *arg)
+{
+    (void)arg;
+    xTaskNotifyGive(s_task);
+}
+
+static void scan_log_task(void *pvParameters)
+{
+    (void)pvParameters;
+    static uint8_t rec[SCAN_LOG_RECORD_MAX];
+    uint32_t last_version = 0;
+    uint32_t dropped = 0;
+
+    while (1) {
+        /* Sweeps keep arriving faster than the flush interval, so waiting
+         * for a quiet spell would never flush: bound the age of the last
+         * write instead, so at most SCAN_LOG_FLUSH_MS is lost on power loss */
+        if (ulTaskNotifyTake(pdTRUE, flush_wait_ticks()) == 0) {
+            scan_log_file_flush(&s_log, esp_timer_get_time());
+            continue;
+        }
+
+        const scan_snapshot_t *snap = scan_results_acquire();
+        if (!snap || snap->version == last_version) {
+            scan_results_release(snap);
+            continue;
+        }
+        /* Sweeps published while the writer was busy are skipped */
+        if (last_version != 0 && snap->version > last_version + 1) {
+            dropped += snap->version - last_version - 1;
+            ESP_LOGW(TAG, "%lu sweeps dropped (writer behind)", (unsigned long)dropped);
+        }
+        last_version = snap->version;
+        size_t len = scan_log_encode_sweep(rec, snap->aps, snap->ap_count, snap->version,
+                                           (uint32_t)(snap->time_us / 1000));
+        scan_results_release(snap);
+
+        /* Writes the block once full or due, rotates at the size limit */
+        scan_log_file_append(&s_log, rec, len, esp_timer_get_time());
+    }
+}
+
+esp_err_t scan_log_init(const char *dir)
+{
+    if (s_task) {
+        return ESP_OK;
+    }
+    const scan_log_file_config_t config = {
+        .max_file_size = SCAN_LOG_MAX_FILE_SIZE,
+        .max_files = SCAN_LOG_MAX_FILES,
+        .index_max = SCAN_LOG_INDEX_MAX,
+        .flush_us = SCAN_LOG_FLUSH_MS * 1000LL,
+    };
+    esp_err_t ret = scan_log_file_open(&s_log, dir, &config, esp_timer_get_time());
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to open a log file in %s: %s", dir ? dir : "-", esp_err_to_name(ret));
+        return ret;
+    }
+
+    /* Below the scan task so logging never competes with it */
+    if (xTaskCreate(scan_log_task, "scan_log", 4096, NULL, 3, &s_task) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create log writer task");
+        return ESP_FAIL;
+    }
+    return scan_results_subscribe(on_sweep_published, NULL);
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "esp_err.h"
+#include <stdint.h>
+
+/*
+ * Append-only binary scan log. The file format is in scan_log_format.h and
+ * the file handling in scan_log_file.h; this is the writer task.
+ */
+
+/**
+ * @brief Start the log writer task on a directory
+ *
+ * Opens a new log file in dir, rotating out the oldest files, and logs every
+ * sweep published through scan_results.h. The scan task only notifies the
+ * writer; sweeps published while it is busy are skipped and counted. Only
+ * stdio is used, so dir can be the SD card mount point or any other VFS path.
+ *
+ * @param[in] dir Directory to write log files to
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t scan_log_init(const char *dir);
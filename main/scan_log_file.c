@@ -0,0 +1,166 @@
+#include "scan_log_file.h"
+
+#include "esp_log.h"
+
+#include <dirent.h>
+#include <string.h>
+#include <unistd.h>
+
+static const char *TAG = "scan_log";
+
+void scan_log_file_path(const scan_log_file_t *log, char *buf, size_t size, uint32_t index)
+{
+    snprintf(buf, size, "%s/SCAN%04lu.BIN", log->dir, (unsigned long)index);
+}
+
+static void write_block(scan_log_file_t *log, int64_t now_us)
+{
+    if (log->block.used == 0 || !log->file) {
+        return;
+    }
+
+    scan_log_block_pad(&log->block);
+    if (fwrite(log->block.data, 1, SCAN_LOG_BLOCK_SIZE, log->file) != SCAN_LOG_BLOCK_SIZE) {
+        ESP_LOGE(TAG, "Block write failed");
+    }
+    /* Make the block durable before any later one can land */
+    fflush(log->file);
+    fsync(fileno(log->file));
+
+    log->file_size += SCAN_LOG_BLOCK_SIZE;
+    log->block.used = 0;
+    log->last_write_us = now_us;
+}
+
+static void append_record(scan_log_file_t *log, const uint8_t *rec, size_t len, int64_t now_us)
+{
+    if (!scan_log_block_add(&log->block, rec, len)) {
+        write_block(log, now_us);
+        scan_log_block_add(&log->block, rec, len);
+    }
+}
+
+/* Move the kept files down to SCAN0001.BIN and up, oldest first so no name
+ * is taken, and continue numbering after them. Keeps "highest number is
+ * newest", which both find_last_index() and sorted globs rely on. */
+static void renumber_files(scan_log_file_t *log)
+{
+    char from[SCAN_LOG_FILE_PATH_MAX];
+    char to[SCAN_LOG_FILE_PATH_MAX];
+    uint32_t max_files = log->config.max_files;
+    uint32_t first = (log->index > max_files) ? log->index - max_files + 1 : 1;
+
+    for (uint32_t index = first; index <= log->index; index++) {
+        scan_log_file_path(log, from, sizeof(from), index);
+        scan_log_file_path(log, to, sizeof(to), index - first + 1);
+        /* Anything still at the low numbers is older than the window. Files
+         * already rotated out or deleted by hand just fail to move. */
+        unlink(to);
+        rename(from, to);
+    }
+    ESP_LOGI(TAG, "Renumbered SCAN%04lu-%04lu.BIN from SCAN0001.BIN", (unsigned long)first,
+             (unsigned long)log->index);
+    log->index -= first - 1;
+}
+
+static esp_err_t open_next_file(scan_log_file_t *log, int64_t now_us)
+{
+    char path[SCAN_LOG_FILE_PATH_MAX];
+
+    scan_log_file_close(log, now_us);
+
+    if (log->index >= log->config.index_max) {
+        renumber_files(log);
+    }
+    log->index++;
+    scan_log_file_path(log, path, sizeof(path), log->index);
+    log->file = fopen(path, "wb");
+    if (!log->file) {
+        ESP_LOGE(TAG, "Failed to create %s", path);
+        return ESP_FAIL;
+    }
+    log->file_size = 0;
+    log->last_write_us = now_us;
+
+    /* Drop the oldest file once the rotation window is full */
+    if (log->index > log->config.max_files) {
+        char oldest[SCAN_LOG_FILE_PATH_MAX];
+        scan_log_file_path(log, oldest, sizeof(oldest), log->index - log->config.max_files);
+        unlink(oldest);
+    }
+
+    uint8_t rec[SCAN_LOG_RECORD_MAX];
+    append_record(log, rec, scan_log_encode_file_header(rec, (uint32_t)(now_us / 1000)), now_us);
+
+    ESP_LOGI(TAG, "Logging to %s", path);
+    return ESP_OK;
+}
+
+static uint32_t find_last_index(const scan_log_file_t *log)
+{
+    uint32_t last = 0;
+    DIR *dir = opendir(log->dir);
+    if (!dir) {
+        return 0;
+    }
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        unsigned long index;
+        if (sscanf(entry->d_name, "SCAN%4lu.BIN", &index) == 1 && index > last &&
+            index <= log->config.index_max) {
+            last = (uint32_t)index;
+        }
+    }
+    closedir(dir);
+    return last;
+}
+
+esp_err_t scan_log_file_open(scan_log_file_t *log, const char *dir, const scan_log_file_config_t *config,
+                             int64_t now_us)
+{
+    /* Renumbering needs room below the kept files */
+    if (!dir || strlen(dir) >= sizeof(log->dir) || config->max_files == 0 ||
+        config->index_max > SCAN_LOG_INDEX_MAX || config->max_files >= config->index_max / 2) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(log, 0, sizeof(*log));
+    log->config = *config;
+    strcpy(log->dir, dir);
+    log->index = find_last_index(log);
+    return open_next_file(log, now_us);
+}
+
+void scan_log_file_append(scan_log_file_t *log, const uint8_t *rec, size_t len, int64_t now_us)
+{
+    append_record(log, rec, len, now_us);
+    if (scan_log_file_flush_due_us(log, now_us) == 0) {
+        write_block(log, now_us);
+    }
+    if (log->file_size >= log->config.max_file_size) {
+        open_next_file(log, now_us);
+    }
+}
+
+void scan_log_file_flush(scan_log_file_t *log, int64_t now_us)
+{
+    write_block(log, now_us);
+}
+
+int64_t scan_log_file_flush_due_us(const scan_log_file_t *log, int64_t now_us)
+{
+    if (log->block.used == 0) {
+        return -1;
+    }
+    int64_t due_us = log->last_write_us + log->config.flush_us - now_us;
+    return (due_us > 0) ? due_us : 0;
+}
+
+void scan_log_file_close(scan_log_file_t *log, int64_t now_us)
+{
+    if (log->file) {
+        write_block(log, now_us);
+        fclose(log->file);
+        log->file = NULL;
+    }
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "esp_err.h"
+#include "scan_log_format.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/*
+ * Scan log files in a directory: blocking records into SCAN_LOG_BLOCK_SIZE
+ * writes, flushing partial blocks by age, rotating by size and renumbering
+ * after SCANnnnn.BIN runs out of numbers. Only stdio and a directory
+ * listing are used and the time is passed in, so the writer task
+ * (scan_log.c) and the host check (host_bench/) run the same code.
+ */
+
+#define SCAN_LOG_PATH_MAX 64
+#define SCAN_LOG_FILE_PATH_MAX (SCAN_LOG_PATH_MAX + 20)  /* Directory plus "/SCANnnnn.BIN" for any index */
+#define SCAN_LOG_INDEX_MAX 9999  /* SCANnnnn.BIN: 8.3 names need no long file name support */
+
+typedef struct {
+    uint32_t max_file_size;  /* Rotate to a new file at this size */
+    uint32_t max_files;      /* Oldest files beyond this are deleted */
+    uint32_t index_max;      /* Highest file number before renumbering, at most SCAN_LOG_INDEX_MAX */
+    int64_t flush_us;        /* Write out a partial block this long after the last write */
+} scan_log_file_config_t;
+
+/* One log directory and its open file */
+typedef struct {
+    scan_log_file_config_t config;
+    char dir[SCAN_LOG_PATH_MAX];
+    FILE *file;
+    uint32_t index;          /* Number of the open file */
+    uint32_t file_size;      /* Bytes written to it, whole blocks */
+    scan_log_block_t block;  /* Records not written yet */
+    int64_t last_write_us;   /* Last block write or file open */
+} scan_log_file_t;
+
+/**
+ * @brief Open a new file after the highest numbered one in a directory
+ *
+ * @param[out] log Log to set up
+ * @param[in] dir Directory, shorter than SCAN_LOG_PATH_MAX
+ * @param[in] config Limits; max_files must be below index_max / 2
+ * @param now_us Current time
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG on a bad dir or config,
+ *         ESP_FAIL if the file cannot be created
+ */
+esp_err_t scan_log_file_open(scan_log_file_t *log, const char *dir, const scan_log_file_config_t *config,
+                             int64_t now_us);
+
+/**
+ * @brief Append a record, writing blocks that are full or due and rotating
+ *
+ * @param log Log
+ * @param[in] rec Encoded record, at most SCAN_LOG_RECORD_MAX bytes
+ * @param len Record length
+ * @param now_us Current time
+ */
+void scan_log_file_append(scan_log_file_t *log, const uint8_t *rec, size_t len, int64_t now_us);
+
+/**
+ * @brief Write out the partial block, padded, and sync it
+ *
+ * @param log Log
+ * @param now_us Current time
+ */
+void scan_log_file_flush(scan_log_file_t *log, int64_t now_us);
+
+/**
+ * @brief Time until the partial block is due to be written
+ *
+ * @param[in] log Log
+ * @param now_us Current time
+ * @return Microseconds, 0 if due now, -1 if nothing is waiting
+ */
+int64_t scan_log_file_flush_due_us(const scan_log_file_t *log, int64_t now_us);
+
+/**
+ * @brief Flush and close the open file
+ *
+ * @param log Log
+ * @param now_us Current time
+ */
+void scan_log_file_close(scan_log_file_t *log, int64_t now_us);
+
+/**
+ * @brief Build the path of a log file
+ *
+ * @param[in] log Log
+ * @param[out] buf Path buffer, SCAN_LOG_FILE_PATH_MAX bytes is enough
+ * @param size Buffer size
+ * @param index File number
+ */
+void scan_log_file_path(const scan_log_file_t *log, char *buf, size_t size, uint32_t index);
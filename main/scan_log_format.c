@@ -0,0 +1,172 @@
+#include "scan_log_format.h"
+
+#include <string.h>
+
+#define FILE_HEADER_PAYLOAD 10
+
+uint32_t scan_log_crc32(uint32_t crc, const uint8_t *buf, size_t len)
+{
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= buf[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+    return ~crc;
+}
+
+static inline void put_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void put_u32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static inline uint16_t get_u16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t get_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/* Fill in header and crc around a payload already at rec + SCAN_LOG_HDR_SIZE */
+static size_t finish_record(uint8_t *rec, uint8_t type, uint8_t count, uint32_t seq, uint32_t time_ms,
+                            size_t payload_len)
+{
+    size_t len = SCAN_LOG_HDR_SIZE + payload_len + SCAN_LOG_CRC_SIZE;
+    put_u16(rec, (uint16_t)len);
+    rec[2] = type;
+    rec[3] = count;
+    put_u32(rec + 4, seq);
+    put_u32(rec + 8, time_ms);
+    put_u32(rec + len - SCAN_LOG_CRC_SIZE, scan_log_crc32(0, rec, len - SCAN_LOG_CRC_SIZE));
+    return len;
+}
+
+size_t scan_log_encode_file_header(uint8_t *rec, uint32_t time_ms)
+{
+    uint8_t *payload = rec + SCAN_LOG_HDR_SIZE;
+    memcpy(payload, "CYDSLOG", 7);
+    payload[7] = SCAN_LOG_VERSION;
+    put_u16(payload + 8, SCAN_LOG_BLOCK_SIZE);
+    return finish_record(rec, SCAN_LOG_TYPE_FILE_HEADER, 0, 0, time_ms, FILE_HEADER_PAYLOAD);
+}
+
+size_t scan_log_encode_sweep(uint8_t *rec, const wifi_ap_info_t *aps, uint16_t ap_count, uint32_t seq,
+                             uint32_t time_ms)
+{
+    uint8_t *p = rec + SCAN_LOG_HDR_SIZE;
+    uint8_t count = 0;
+
+    for (int i = 0; i < ap_count && count < SCAN_LOG_MAX_APS; i++) {
+        const wifi_ap_info_t *ap = &aps[i];
+        size_t ssid_len = strnlen(ap->ssid, 32);
+        memcpy(p, ap->bssid, 6);
+        p[6] = (uint8_t)ap->rssi;
+        p[7] = ap->channel;
+        p[8] = (uint8_t)ap->authmode;
+        p[9] = (uint8_t)ssid_len;
+        memcpy(p + 10, ap->ssid, ssid_len);
+        p += 10 + ssid_len;
+        count++;
+    }
+
+    return finish_record(rec, SCAN_LOG_TYPE_SWEEP, count, seq, time_ms, (size_t)(p - (rec + SCAN_LOG_HDR_SIZE)));
+}
+
+bool scan_log_block_add(scan_log_block_t *block, const uint8_t *rec, size_t len)
+{
+    if (block->used + len > SCAN_LOG_BLOCK_SIZE) {
+        return false;
+    }
+    memcpy(block->data + block->used, rec, len);
+    block->used += len;
+    return true;
+}
+
+void scan_log_block_pad(scan_log_block_t *block)
+{
+    /* Zero padding reads as a 0-length record: "skip to next block" */
+    memset(block->data + block->used, 0, SCAN_LOG_BLOCK_SIZE - block->used);
+}
+
+void scan_log_reader_init(scan_log_reader_t *reader, const uint8_t *buf, size_t len)
+{
+    memset(reader, 0, sizeof(*reader));
+    reader->buf = buf;
+    reader->len = len;
+    reader->block_size = SCAN_LOG_BLOCK_SIZE;
+}
+
+bool scan_log_reader_next(scan_log_reader_t *reader, scan_log_record_t *out)
+{
+    while (!reader->stopped && reader->block < reader->len) {
+        size_t end = reader->block + reader->block_size;
+        if (end > reader->len) {
+            end = reader->len;
+        }
+        size_t off = reader->offset;
+        uint16_t len = (off + SCAN_LOG_HDR_SIZE <= end) ? get_u16(reader->buf + off) : 0;
+        if (len == 0) {
+            /* Padding, or too little left for a header: next block */
+            reader->block += reader->block_size;
+            reader->offset = reader->block;
+            continue;
+        }
+
+        const uint8_t *rec = reader->buf + off;
+        if (len < SCAN_LOG_HDR_SIZE + SCAN_LOG_CRC_SIZE || off + len > end ||
+            scan_log_crc32(0, rec, len - SCAN_LOG_CRC_SIZE) != get_u32(rec + len - SCAN_LOG_CRC_SIZE)) {
+            /* Torn write: everything before is intact */
+            reader->stopped = true;
+            return false;
+        }
+
+        out->type = rec[2];
+        out->count = rec[3];
+        out->seq = get_u32(rec + 4);
+        out->time_ms = get_u32(rec + 8);
+        out->payload = rec + SCAN_LOG_HDR_SIZE;
+        out->payload_len = len - SCAN_LOG_HDR_SIZE - SCAN_LOG_CRC_SIZE;
+        out->offset = off;
+        reader->offset = off + len;
+
+        if (out->type == SCAN_LOG_TYPE_FILE_HEADER && out->payload_len >= FILE_HEADER_PAYLOAD &&
+            memcmp(out->payload, "CYDSLOG", 7) == 0) {
+            reader->block_size = get_u16(out->payload + 8);
+            if (reader->block_size < SCAN_LOG_HDR_SIZE + SCAN_LOG_CRC_SIZE) {
+                reader->stopped = true;
+                return false;
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+bool scan_log_decode_ap(const scan_log_record_t *rec, size_t *offset, wifi_ap_info_t *out)
+{
+    const uint8_t *p = rec->payload + *offset;
+    if (*offset + 10 > rec->payload_len || *offset + 10 + p[9] > rec->payload_len || p[9] > 32) {
+        return false;
+    }
+    memset(out, 0, sizeof(*out));
+    memcpy(out->bssid, p, 6);
+    out->rssi = (int8_t)p[6];
+    out->channel = p[7];
+    out->authmode = (wifi_auth_mode_t)p[8];
+    memcpy(out->ssid, p + 10, p[9]);
+    *offset += 10 + (size_t)p[9];
+    return true;
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "wifi_scanner.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Scan log file format: record encoding, blocking and CRC, without any I/O,
+ * so the writer (scan_log.c) and the host check (host_bench/) share it.
+ *
+ * Files are written in SCAN_LOG_BLOCK_SIZE blocks. Records never span a
+ * block; a record length of 0 pads the rest of the block. All fields are
+ * little-endian:
+ *
+ *   record  := len u16 | type u8 | count u8 | seq u32 | time_ms u32 | payload | crc32 u32
+ *   seq     := snapshot version for sweeps (gaps are skipped sweeps), 0 otherwise
+ *   len     := size of the whole record, header and crc included
+ *   crc32   := CRC-32 (zlib) over header and payload
+ *
+ *   type 0 (file header): payload = "CYDSLOG" | version u8 | block_size u16
+ *   type 1 (sweep):       payload = count x ap
+ *   ap      := bssid[6] | rssi i8 | channel u8 | authmode u8 | ssid_len u8 | ssid[ssid_len]
+ *
+ * A reader stops at the first record whose crc does not match; everything
+ * before it is intact. See tools/scan_log_reader.py.
+ */
+
+#define SCAN_LOG_BLOCK_SIZE 4096
+#define SCAN_LOG_VERSION 1
+
+#define SCAN_LOG_HDR_SIZE 12
+#define SCAN_LOG_CRC_SIZE 4
+#define SCAN_LOG_MAX_APS 20  /* Strongest APs kept per sweep record */
+#define SCAN_LOG_AP_MAX_SIZE (6 + 4 + 32)
+#define SCAN_LOG_RECORD_MAX (SCAN_LOG_HDR_SIZE + SCAN_LOG_MAX_APS * SCAN_LOG_AP_MAX_SIZE + SCAN_LOG_CRC_SIZE)
+
+#define SCAN_LOG_TYPE_FILE_HEADER 0
+#define SCAN_LOG_TYPE_SWEEP 1
+
+/* A block being filled with records */
+typedef struct {
+    uint8_t data[SCAN_LOG_BLOCK_SIZE];
+    size_t used;
+} scan_log_block_t;
+
+/* A record as decoded by scan_log_reader_next(); payload points into the buffer */
+typedef struct {
+    uint8_t type;
+    uint8_t count;
+    uint32_t seq;
+    uint32_t time_ms;
+    const uint8_t *payload;
+    size_t payload_len;
+    size_t offset;  /* Of the record in the buffer */
+} scan_log_record_t;
+
+/* Walks a log file held in memory, block by block */
+typedef struct {
+    const uint8_t *buf;
+    size_t len;
+    size_t block;       /* Start of the current block */
+    size_t offset;      /* Next record */
+    size_t block_size;  /* From the file header, SCAN_LOG_BLOCK_SIZE until then */
+    bool stopped;       /* Hit a torn or corrupt record */
+} scan_log_reader_t;
+
+/**
+ * @brief Update a CRC-32 (zlib polynomial)
+ *
+ * @param crc CRC so far, 0 to start
+ * @param[in] buf Data
+ * @param len Data length
+ * @return Updated CRC
+ */
+uint32_t scan_log_crc32(uint32_t crc, const uint8_t *buf, size_t len);
+
+/**
+ * @brief Encode the record that starts every file
+ *
+ * @param[out] rec Buffer of at least SCAN_LOG_RECORD_MAX bytes
+ * @param time_ms Time since boot
+ * @return Record length
+ */
+size_t scan_log_encode_file_header(uint8_t *rec, uint32_t time_ms);
+
+/**
+ * @brief Encode a sweep record of the first SCAN_LOG_MAX_APS APs
+ *
+ * @param[out] rec Buffer of at least SCAN_LOG_RECORD_MAX bytes
+ * @param[in] aps Ranked sweep
+ * @param ap_count Number of APs
+ * @param seq Snapshot version
+ * @param time_ms Time of the sweep since boot
+ * @return Record length
+ */
+size_t scan_log_encode_sweep(uint8_t *rec, const wifi_ap_info_t *aps, uint16_t ap_count, uint32_t seq,
+                             uint32_t time_ms);
+
+/**
+ * @brief Append a record to a block
+ *
+ * @param block Block
+ * @param[in] rec Encoded record
+ * @param len Record length
+ * @return false if it does not fit; write the block out and start a new one
+ */
+bool scan_log_block_add(scan_log_block_t *block, const uint8_t *rec, size_t len);
+
+/**
+ * @brief Zero the unused rest of a block, which reads as padding
+ *
+ * @param block Block, ready to be written as SCAN_LOG_BLOCK_SIZE bytes
+ */
+void scan_log_block_pad(scan_log_block_t *block);
+
+/**
+ * @brief Start reading a log file held in memory
+ *
+ * @param[out] reader Reader
+ * @param[in] buf File contents
+ * @param len File length
+ */
+void scan_log_reader_init(scan_log_reader_t *reader, const uint8_t *buf, size_t len);
+
+/**
+ * @brief Get the next intact record
+ *
+ * @param reader Reader
+ * @param[out] out Record
+ * @return false at the end of the file or at the first torn record
+ */
+bool scan_log_reader_next(scan_log_reader_t *reader, scan_log_record_t *out);
+
+/**
+ * @brief Decode the next AP of a sweep record
+ *
+ * @param[in] rec Sweep record
+ * @param offset Position in the payload, 0 for the first AP; advanced
+ * @param[out] out AP; fields the log does not keep are zeroed
+ * @return false if the payload ends before the AP
+ */
+bool scan_log_decode_ap(const scan_log_record_t *rec, size_t *offset, wifi_ap_info_t *out);
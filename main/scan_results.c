@@ -0,0 +1,107 @@
+#include "scan_results.h"
+
+#include "esp_timer.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct {
+    scan_snapshot_t snap;  /* First, so a snapshot pointer is its slot's */
+    uint32_t refs;         /* Readers, plus one while published or being written */
+} scan_slot_t;
+
+typedef struct {
+    scan_results_notify_t notify;
+    void *arg;
+} scan_subscriber_t;
+
+static scan_slot_t s_pool[SCAN_RESULTS_POOL_SIZE];
+static scan_slot_t *s_current;
+static uint32_t s_version;  /* Producer only */
+static uint32_t s_published_version;
+
+static scan_subscriber_t s_subscribers[SCAN_RESULTS_MAX_SUBSCRIBERS];
+static uint32_t s_subscriber_count;
+
+static void slot_unref(scan_slot_t *slot)
+{
+    __atomic_fetch_sub(&slot->refs, 1, __ATOMIC_ACQ_REL);
+}
+
+scan_snapshot_t *scan_results_begin(void)
+{
+    /* A free slot has no references; the published one always has one */
+    for (int i = 0; i < SCAN_RESULTS_POOL_SIZE; i++) {
+        uint32_t expected = 0;
+        if (__atomic_compare_exchange_n(&s_pool[i].refs, &expected, 1, false,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            return &s_pool[i].snap;
+        }
+    }
+    return NULL;
+}
+
+void scan_results_publish(scan_snapshot_t *snap)
+{
+    scan_slot_t *slot = (scan_slot_t *)snap;
+    snap->version = ++s_version;
+    snap->time_us = esp_timer_get_time();
+
+    /* The writer's reference becomes the published reference */
+    scan_slot_t *old = __atomic_exchange_n(&s_current, slot, __ATOMIC_ACQ_REL);
+    if (old) {
+        slot_unref(old);
+    }
+    __atomic_store_n(&s_published_version, snap->version, __ATOMIC_RELEASE);
+
+    uint32_t count = __atomic_load_n(&s_subscriber_count, __ATOMIC_ACQUIRE);
+    for (uint32_t i = 0; i < count; i++) {
+        s_subscribers[i].notify(s_subscribers[i].arg);
+    }
+}
+
+const scan_snapshot_t *scan_results_acquire(void)
+{
+    while (1) {
+        scan_slot_t *slot = __atomic_load_n(&s_current, __ATOMIC_ACQUIRE);
+        if (!slot) {
+            return NULL;
+        }
+        __atomic_fetch_add(&slot->refs, 1, __ATOMIC_ACQ_REL);
+
+        /* Still published after taking the reference, so the producer
+         * cannot have reclaimed it in between; otherwise try again */
+        if (__atomic_load_n(&s_current, __ATOMIC_ACQUIRE) == slot) {
+            return &slot->snap;
+        }
+        slot_unref(slot);
+    }
+}
+
+void scan_results_release(const scan_snapshot_t *snap)
+{
+    if (snap) {
+        slot_unref((scan_slot_t *)snap);
+    }
+}
+
+uint32_t scan_results_version(void)
+{
+    return __atomic_load_n(&s_published_version, __ATOMIC_ACQUIRE);
+}
+
+esp_err_t scan_results_subscribe(scan_results_notify_t notify, void *arg)
+{
+    if (!notify) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    uint32_t index = __atomic_load_n(&s_subscriber_count, __ATOMIC_RELAXED);
+    if (index >= SCAN_RESULTS_MAX_SUBSCRIBERS) {
+        return ESP_ERR_NO_MEM;
+    }
+    s_subscribers[index].notify = notify;
+    s_subscribers[index].arg = arg;
+    /* Publish the entry before the producer can see it */
+    __atomic_store_n(&s_subscriber_count, index + 1, __ATOMIC_RELEASE);
+    return ESP_OK;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "esp_err.h"
+#include "wifi_scanner.h"
+#include <stdint.h>
+
+/*
+ * Publication of scan results to any number of consumers.
+ *
+ * The scan task fills a snapshot from a small preallocated pool and
+ * publishes it with an atomic pointer swap. Published snapshots are
+ * immutable and versioned. Readers take a reference to the latest one
+ * without locks and without ever blocking the producer; a slot is reused
+ * only once every reference to it has been released. If readers hold every
+ * free slot the producer skips publishing that sweep rather than wait.
+ */
+
+#define SCAN_RESULTS_POOL_SIZE 4
+#define SCAN_RESULTS_MAX_SUBSCRIBERS 4
+
+typedef struct {
+    uint32_t version;   /* Publication number, starts at 1 */
+    int64_t time_us;    /* esp_timer time of publication */
+    uint16_t ap_count;
+    wifi_ap_info_t aps[MAX_AP_COUNT];  /* Ranked, strongest first */
+} scan_snapshot_t;
+
+/* Called in the producer's context after each publication; must not block
+ * (e.g. notify a task and return) */
+typedef void (*scan_results_notify_t)(void *arg);
+
+/**
+ * @brief Get a free snapshot to fill (producer only)
+ *
+ * @return Writable snapshot, or NULL if readers hold every free slot
+ */
+scan_snapshot_t *scan_results_begin(void);
+
+/**
+ * @brief Publish a snapshot from scan_results_begin() and notify subscribers
+ *
+ * Sets version and time_us; the snapshot must not be written afterwards.
+ *
+ * @param snap Snapshot to publish
+ */
+void scan_results_publish(scan_snapshot_t *snap);
+
+/**
+ * @brief Take a reference to the latest snapshot
+ *
+ * Every non-NULL result must be passed to scan_results_release().
+ *
+ * @return Latest snapshot, or NULL if nothing has been published yet
+ */
+const scan_snapshot_t *scan_results_acquire(void);
+
+/**
+ * @brief Drop a reference taken with scan_results_acquire()
+ *
+ * @param snap Snapshot to release
+ */
+void scan_results_release(const scan_snapshot_t *snap);
+
+/**
+ * @brief Version of the latest snapshot, 0 if none
+ *
+ * Cheap enough to poll, e.g. from an LVGL timer.
+ *
+ * @return Latest version
+ */
+uint32_t scan_results_version(void);
+
+/**
+ * @brief Register a callback run after every publication
+ *
+ * Subscribers are expected to register during init; concurrent calls to
+ * this function are not supported.
+ *
+ * @param notify Callback
+ * @param arg Passed to the callback
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if all subscriber slots are used
+ */
+esp_err_t scan_results_subscribe(scan_results_notify_t notify, void *arg);
@@ -0,0 +1,127 @@
+#include "touch_sampler.h"
+#include "cyd_config.h"
+#include "cyd_hw.h"
+#include "metrics.h"
+#include "power.h"
+#include "tuning.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "esp_log.h"
+#include "esp_timer.h"
+
+static const char *TAG = "touch_sampler";
+
+static esp_lcd_touch_handle_t s_touch;
+static TaskHandle_t s_task;
+static esp_timer_handle_t s_timer;
+
+/* Written by the sampler task (head) and the LVGL loop (tail) only */
+static gesture_sample_t s_ring[TOUCH_SAMPLER_RING_SIZE];
+static uint32_t s_head;
+static uint32_t s_tail;
+
+static void push(const gesture_sample_t *sample)
+{
+    uint32_t head = __atomic_load_n(&s_head, __ATOMIC_RELAXED);
+    if (head - __atomic_load_n(&s_tail, __ATOMIC_ACQUIRE) == TOUCH_SAMPLER_RING_SIZE) {
+        metrics_inc(METRIC_CNT_TOUCH_DROPS, 1);
+        return;
+    }
+    s_ring[head & (TOUCH_SAMPLER_RING_SIZE - 1)] = *sample;
+    __atomic_store_n(&s_head, head + 1, __ATOMIC_RELEASE);
+}
+
+bool touch_sampler_pop(gesture_sample_t *out)
+{
+    uint32_t tail = __atomic_load_n(&s_tail, __ATOMIC_RELAXED);
+    if (tail == __atomic_load_n(&s_head, __ATOMIC_ACQUIRE)) {
+        return false;
+    }
+    *out = s_ring[tail & (TOUCH_SAMPLER_RING_SIZE - 1)];
+    __atomic_store_n(&s_tail, tail + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+/* esp_timer task context: hand the read to the sampler task */
+static void sample_timer_cb(void *arg)
+{
+    (void)arg;
+    xTaskNotifyGive(s_task);
+}
+
+static void touch_sampler_task(void *arg)
+{
+    (void)arg;
+    int64_t last_contact_us = 0;
+    bool contact_seen = false;
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        /* Some touch drivers require read_data() before get_coordinates() */
+        int64_t now = esp_timer_get_time();
+        uint16_t x[1], y[1];
+        uint8_t cnt = 0;
+        esp_lcd_touch_read_data(s_touch);
+        bool pressed = esp_lcd_touch_get_coordinates(s_touch, x, y, NULL, &cnt, 1) && cnt > 0;
+        metrics_record(METRIC_HIST_TOUCH_US, (uint32_t)(esp_timer_get_time() - now));
+        metrics_inc(METRIC_CNT_TOUCH_READS, 1);
+
+        if (pressed) {
+            cyd_hw_map_touch_coords(&x[0], &y[0]);
+            last_contact_us = now;
+            contact_seen = true;
+        }
+        bool fast = contact_seen && now - last_contact_us < TOUCH_SAMPLE_TAIL_MS * 1000LL;
+
+        /* Idle samples carry nothing; only the release debounce needs the
+         * ones right after contact */
+        if (fast) {
+            gesture_sample_t sample = {
+                .time_us = now,
+                .x = pressed ? (int16_t)x[0] : 0,
+                .y = pressed ? (int16_t)y[0] : 0,
+                .pressed = pressed,
+            };
+            push(&sample);
+        }
+
+        uint32_t period_ms = TOUCH_SAMPLE_PERIOD_MS;
+        if (!fast) {
+            period_ms = power_is_idle() ? POWER_IDLE_TOUCH_PERIOD_MS : (uint32_t)tuning_get(TUNING_TOUCH_PERIOD_MS);
+        }
+        esp_timer_start_once(s_timer, (uint64_t)period_ms * 1000);
+    }
+}
+
+esp_err_t touch_sampler_init(esp_lcd_touch_handle_t touch)
+{
+    if (!touch) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    s_touch = touch;
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = sample_timer_cb,
+        .name = "touch_sample",
+    };
+    esp_err_t ret = esp_timer_create(&timer_args, &s_timer);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create sample timer: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    /* Above the LVGL loop so samples keep their spacing while it renders */
+    if (xTaskCreate(touch_sampler_task, "touch_sampler", 3072, NULL, TOUCH_SAMPLER_PRIORITY, &s_task) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create sampler task");
+        esp_timer_delete(s_timer);
+        s_timer = NULL;
+        return ESP_FAIL;
+    }
+    xTaskNotifyGive(s_task);
+
+    ESP_LOGI(TAG, "Sampling touch every %d ms in contact", TOUCH_SAMPLE_PERIOD_MS);
+    return ESP_OK;
+}
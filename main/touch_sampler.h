@@ -0,0 +1,38 @@
+#pragma once
+
+#include "esp_err.h"
+#include "esp_lcd_touch.h"
+#include "gesture.h"
+#include <stdbool.h>
+
+/*
+ * Touch sampling at a steady rate, independent of the LVGL loop.
+ *
+ * A task reads the controller every TOUCH_SAMPLE_PERIOD_MS while in contact
+ * and for TOUCH_SAMPLE_TAIL_MS after, and at the touch_period tuning (or
+ * POWER_IDLE_TOUCH_PERIOD_MS while the backlight is dimmed) otherwise, so
+ * the fast rate costs nothing while nobody touches the screen. Timestamped
+ * samples in screen coordinates go through a lock-free single-producer,
+ * single-consumer ring to the LVGL read callback, which feeds them to the
+ * gesture recognizer. A full ring drops the new sample and counts it.
+ */
+
+#define TOUCH_SAMPLER_RING_SIZE 64  /* A power of two; 320 ms at the fast rate */
+
+/**
+ * @brief Start sampling a touch controller
+ *
+ * The sampler task owns the controller from then on.
+ *
+ * @param touch Initialized controller
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t touch_sampler_init(esp_lcd_touch_handle_t touch);
+
+/**
+ * @brief Take the oldest sample (single consumer)
+ *
+ * @param[out] out Sample
+ * @return true if there was one
+ */
+bool touch_sampler_pop(gesture_sample_t *out);
@@ -0,0 +1,171 @@
+#include "tuning.h"
+#include "cyd_config.h"
+
+#include "freertos/FreeRTOS.h"
+
+#include "esp_log.h"
+#include "nvs.h"
+#include "nvs_flash.h"
+#include "lvgl.h"
+
+#include <string.h>
+
+static const char *TAG = "tuning";
+
+#define TUNING_NVS_NAMESPACE "tuning"
+
+typedef struct {
+    const char *name;  /* Also the NVS key, at most 15 characters */
+    int32_t def;
+    int32_t min;
+    int32_t max;
+    bool boot_only;
+} tuning_param_t;
+
+static const tuning_param_t s_params[TUNING_COUNT] = {
+    [TUNING_SCAN_INTERVAL_MS] = {"scan_interval", WIFI_SCAN_INTERVAL_MS, 0, 60000, false},
+    [TUNING_SCAN_DWELL_MS] = {"scan_dwell", 0, 0, 1500, false},
+    [TUNING_SCAN_PASSIVE] = {"scan_passive", 0, 0, 1, false},
+    [TUNING_SCAN_PRIORITY] = {"scan_prio", WIFI_SCAN_TASK_PRIORITY, 1, configMAX_PRIORITIES - 1, false},
+    [TUNING_LVGL_DELAY_MS] = {"lvgl_delay", LVGL_TASK_DELAY_MS, 1, 100, false},
+    [TUNING_LVGL_PRIORITY] = {"lvgl_prio", LVGL_TASK_PRIORITY, 1, configMAX_PRIORITIES - 1, false},
+    [TUNING_REFR_PERIOD_MS] = {"refr_period", LV_DEF_REFR_PERIOD, 5, 1000, false},
+    [TUNING_TOUCH_PERIOD_MS] = {"touch_period", LV_DEF_REFR_PERIOD, 5, 1000, false},
+    [TUNING_LVGL_TILES] = {"lvgl_tiles", LV_DRAW_SW_DRAW_UNIT_CNT, 1, 8, false},
+    [TUNING_LCD_PCLK_HZ] = {"lcd_pclk_hz", LCD_PCLK_HZ, 1000000, 80000000, true},
+    [TUNING_LCD_BUFFER_LINES] = {"lcd_buf_lines", LCD_BUFFER_LINES, 1, LCD_BUFFER_LINES, true},
+};
+
+static int32_t s_values[TUNING_COUNT];
+static uint32_t s_generation;
+
+static void load_defaults(void)
+{
+    for (int i = 0; i < TUNING_COUNT; i++) {
+        s_values[i] = s_params[i].def;
+    }
+}
+
+esp_err_t tuning_init(void)
+{
+    load_defaults();
+
+    esp_err_t ret = nvs_flash_init();
+    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        ESP_ERROR_CHECK(nvs_flash_erase());
+        ret = nvs_flash_init();
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to initialize NVS: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    nvs_handle_t nvs;
+    ret = nvs_open(TUNING_NVS_NAMESPACE, NVS_READONLY, &nvs);
+    if (ret == ESP_ERR_NVS_NOT_FOUND) {
+        return ESP_OK;  /* Nothing saved yet */
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to open NVS: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    for (int i = 0; i < TUNING_COUNT; i++) {
+        int32_t value;
+        if (nvs_get_i32(nvs, s_params[i].name, &value) != ESP_OK) {
+            continue;
+        }
+        if (value < s_params[i].min || value > s_params[i].max) {
+            ESP_LOGW(TAG, "Ignoring saved %s=%ld (out of range)", s_params[i].name, (long)value);
+            continue;
+        }
+        if (value != s_params[i].def) {
+            ESP_LOGI(TAG, "%s=%ld", s_params[i].name, (long)value);
+        }
+        s_values[i] = value;
+    }
+    nvs_close(nvs);
+    return ESP_OK;
+}
+
+int32_t tuning_get(tuning_id_t id)
+{
+    return s_values[id];
+}
+
+esp_err_t tuning_set(tuning_id_t id, int32_t value)
+{
+    if (id >= TUNING_COUNT || value < s_params[id].min || value > s_params[id].max) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    s_values[id] = value;
+    s_generation++;
+    return ESP_OK;
+}
+
+tuning_id_t tuning_find(const char *name)
+{
+    for (int i = 0; i < TUNING_COUNT; i++) {
+        if (strcmp(s_params[i].name, name) == 0) {
+            return (tuning_id_t)i;
+        }
+    }
+    return TUNING_COUNT;
+}
+
+uint32_t tuning_generation(void)
+{
+    return s_generation;
+}
+
+esp_err_t tuning_save(void)
+{
+    nvs_handle_t nvs;
+    esp_err_t ret = nvs_open(TUNING_NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to open NVS: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    for (int i = 0; i < TUNING_COUNT && ret == ESP_OK; i++) {
+        ret = nvs_set_i32(nvs, s_params[i].name, s_values[i]);
+    }
+    if (ret == ESP_OK) {
+        ret = nvs_commit(nvs);
+    }
+    nvs_close(nvs);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to save parameters: %s", esp_err_to_name(ret));
+    }
+    return ret;
+}
+
+esp_err_t tuning_reset(void)
+{
+    load_defaults();
+    s_generation++;
+
+    nvs_handle_t nvs;
+    esp_err_t ret = nvs_open(TUNING_NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to open NVS: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    ret = nvs_erase_all(nvs);
+    if (ret == ESP_OK) {
+        ret = nvs_commit(nvs);
+    }
+    nvs_close(nvs);
+    return ret;
+}
+
+void tuning_print(FILE *out, tuning_id_t id)
+{
+    for (int i = 0; i < TUNING_COUNT; i++) {
+        if (id != TUNING_COUNT && id != (tuning_id_t)i) {
+            continue;
+        }
+        fprintf(out, "%-14s %9ld  [%ld..%ld] default %ld%s\n", s_params[i].name, (long)s_values[i],
+                (long)s_params[i].min, (long)s_params[i].max, (long)s_params[i].def,
+                s_params[i].boot_only ? " (boot)" : "");
+    }
+}
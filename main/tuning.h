@@ -0,0 +1,93 @@
+#pragma once
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdio.h>
+
+/*
+ * Runtime-tunable performance parameters, persisted in NVS.
+ *
+ * Defaults come from the compile-time settings. Most parameters are read
+ * by their owner on every use and take effect immediately; the ones marked
+ * boot-only (panel clock, draw buffer size) are applied at the next restart.
+ */
+
+typedef enum {
+    TUNING_SCAN_INTERVAL_MS = 0,  /* Delay between sweeps */
+    TUNING_SCAN_DWELL_MS,         /* Per-channel dwell time, 0 = driver default */
+    TUNING_SCAN_PASSIVE,          /* 0 = active scan, 1 = passive scan */
+    TUNING_SCAN_PRIORITY,         /* Scan task priority */
+    TUNING_LVGL_DELAY_MS,         /* Sleep between lv_timer_handler() calls */
+    TUNING_LVGL_PRIORITY,         /* LVGL loop task priority */
+    TUNING_REFR_PERIOD_MS,        /* LVGL display refresh period */
+    TUNING_TOUCH_PERIOD_MS,       /* LVGL touch read period */
+    TUNING_LVGL_TILES,            /* Tiles each draw buffer is split into for the draw threads */
+    TUNING_LCD_PCLK_HZ,           /* Panel SPI clock (boot-only) */
+    TUNING_LCD_BUFFER_LINES,      /* Draw buffer height (boot-only) */
+    TUNING_COUNT,
+} tuning_id_t;
+
+/**
+ * @brief Initialize NVS and load saved parameters
+ *
+ * Parameters that are missing or out of range keep their defaults.
+ *
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t tuning_init(void);
+
+/**
+ * @brief Get a parameter's current value
+ *
+ * @param id Parameter
+ * @return Current value
+ */
+int32_t tuning_get(tuning_id_t id);
+
+/**
+ * @brief Change a parameter (not persisted until tuning_save())
+ *
+ * @param id Parameter
+ * @param value New value
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if out of range
+ */
+esp_err_t tuning_set(tuning_id_t id, int32_t value);
+
+/**
+ * @brief Look up a parameter by name
+ *
+ * @param name Parameter name as printed by tuning_print()
+ * @return Parameter id, or TUNING_COUNT if unknown
+ */
+tuning_id_t tuning_find(const char *name);
+
+/**
+ * @brief Change counter, bumped by every successful tuning_set()
+ *
+ * Lets owners of live parameters notice changes without polling each value.
+ *
+ * @return Current change count
+ */
+uint32_t tuning_generation(void);
+
+/**
+ * @brief Persist all parameters to NVS
+ *
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t tuning_save(void);
+
+/**
+ * @brief Restore defaults and erase the saved parameters
+ *
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t tuning_reset(void);
+
+/**
+ * @brief Print parameters with their range
+ *
+ * @param out Stream to print to
+ * @param id Parameter to print, or TUNING_COUNT for all
+ */
+void tuning_print(FILE *out, tuning_id_t id);
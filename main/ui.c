@@ -1,27 +1,39 @@
 #include "ui.h"
 #include "cyd_config.h"
+#include "metrics.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 
 static const char *TAG = "ui";
 
 static lv_obj_t *s_touch_label;
 static lv_obj_t *s_cursor;
-static lv_obj_t *s_main_screen;
-static ui_button_callback_t s_green_button_callback = NULL;
+static lv_obj_t *s_buttons[UI_BUTTON_COUNT];
+static ui_button_callback_t s_button_callbacks[UI_BUTTON_COUNT];
+static ui_scroll_body_callback_t s_scroll_body_callback;
+static const ui_view_t *s_active_view = NULL;
+
+static void menu_view_create(lv_obj_t *screen);
+static void menu_view_destroy(void);
+
+static const ui_view_t s_menu_view = {
+    .name = "menu",
+    .create = menu_view_create,
+    .destroy = menu_view_destroy,
+};
 
 static void button_event_cb(lv_event_t *e)
 {
     int *btn_id = (int *)lv_event_get_user_data(e);
     
-    if (btn_id && *btn_id == 0 && s_green_button_callback) {
-        /* Green button pressed */
-        s_green_button_callback();
+    if (btn_id && *btn_id >= 0 && *btn_id < UI_BUTTON_COUNT && s_button_callbacks[*btn_id]) {
+        s_button_callbacks[*btn_id]();
     }
 }
 
 static lv_obj_t *create_color_button(lv_obj_t *parent, lv_color_t color, int x_pos, int y_pos, int btn_id, int size)
 {
-    static int btn_ids[6];
+    static int btn_ids[UI_BUTTON_COUNT];
     btn_ids[btn_id] = btn_id;
     
     lv_obj_t *btn = lv_button_create(parent);
@@ -43,53 +55,151 @@ static lv_obj_t *create_color_button(lv_obj_t *parent, lv_color_t color, int x_p
     return btn;
 }
 
-void ui_init(void)
+static void menu_view_create(lv_obj_t *screen)
 {
-    s_main_screen = lv_screen_active();
-    lv_obj_set_style_bg_color(s_main_screen, lv_color_make(0, 0, 0), 0);
-    lv_obj_set_style_bg_opa(s_main_screen, LV_OPA_COVER, 0);
+    lv_obj_set_style_bg_color(screen, lv_color_make(0, 0, 0), 0);
+
+    const lv_color_t button_colors[UI_BUTTON_COUNT] = {
+        lv_color_make(35, 255, 0),    /* Green */
+        lv_color_make(255, 0, 0),     /* Red */
+        lv_color_make(230, 200, 0),   /* Yellow */
+        lv_color_make(200, 0, 200),   /* Magenta */
+        lv_color_make(128, 128, 128), /* Grey */
+        lv_color_make(255, 165, 0),   /* Orange */
+    };
 
-    /* Calculate button positions - centered grid */
-    int btn_size = 85;
+    /* Calculate button positions - centered grid, 3x2 in landscape, 2x3 in portrait */
+    int32_t width = lv_display_get_horizontal_resolution(NULL);
+    int32_t height = lv_display_get_vertical_resolution(NULL);
+    bool portrait = height > width;
+    int cols = portrait ? 2 : 3;
+    int btn_size = portrait ? 70 : 85;
     int gap = 10;
-    int row_width = 3 * btn_size + 2 * gap;
-    int start_x = (LCD_H_RES - row_width) / 2;
-    int start_y = 25;
+    int row_width = cols * btn_size + (cols - 1) * gap;
+    int start_x = (width - row_width) / 2;
+    int start_y = portrait ? 35 : 25;
     int row_gap = 20;
 
-    /* Row 1: Green, Red, Yellow */
-    create_color_button(s_main_screen, lv_color_make(35, 255, 0), start_x, start_y, 0, btn_size); /* Green */
-    create_color_button(s_main_screen, lv_color_make(255, 0, 0), start_x + btn_size + gap, start_y, 1, btn_size); /* Red */
-    create_color_button(s_main_screen, lv_color_make(230, 200, 0), start_x + 2 * (btn_size + gap), start_y, 2, btn_size); /* Yellow */
-
-    /* Row 2: Magenta, Grey, Orange */
-    create_color_button(s_main_screen, lv_color_make(200, 0, 200), start_x, start_y + btn_size + row_gap, 3, btn_size); /* Magenta */
-    create_color_button(s_main_screen, lv_color_make(128, 128, 128), start_x + btn_size + gap, start_y + btn_size + row_gap, 4, btn_size); /* Grey */
-    create_color_button(s_main_screen, lv_color_make(255, 165, 0), start_x + 2 * (btn_size + gap), start_y + btn_size + row_gap, 5, btn_size); /* Orange */
+    for (int i = 0; i < UI_BUTTON_COUNT; i++) {
+        int col = i % cols;
+        int row = i / cols;
+        s_buttons[i] = create_color_button(screen, button_colors[i], start_x + col * (btn_size + gap),
+                                           start_y + row * (btn_size + row_gap), i, btn_size);
+    }
 
     /* Touch label at bottom */
-    s_touch_label = lv_label_create(s_main_screen);
+    s_touch_label = lv_label_create(screen);
     lv_obj_align(s_touch_label, LV_ALIGN_BOTTOM_MID, 0, -5);
     lv_label_set_text(s_touch_label, "touch: -");
     lv_obj_set_style_text_color(s_touch_label, lv_color_white(), 0);
 
     /* Touch cursor */
-    s_cursor = lv_obj_create(s_main_screen);
+    s_cursor = lv_obj_create(screen);
     lv_obj_set_size(s_cursor, 12, 12);
     lv_obj_set_style_radius(s_cursor, LV_RADIUS_CIRCLE, 0);
     lv_obj_set_style_bg_opa(s_cursor, LV_OPA_COVER, 0);
 
     /* Title at top */
-    lv_obj_t *label = lv_label_create(s_main_screen);
+    lv_obj_t *label = lv_label_create(screen);
     lv_label_set_text(label, "CYD Menu");
     lv_obj_align(label, LV_ALIGN_TOP_MID, 0, 5);
     lv_obj_set_style_text_font(label, &lv_font_montserrat_16, 0);
     lv_obj_set_style_text_color(label, lv_color_white(), 0);
 }
 
-void ui_set_green_button_callback(ui_button_callback_t callback)
+static void menu_view_destroy(void)
+{
+    s_touch_label = NULL;
+    s_cursor = NULL;
+    for (int i = 0; i < UI_BUTTON_COUNT; i++) {
+        s_buttons[i] = NULL;
+    }
+}
+
+void ui_lock(void)
 {
-    s_green_button_callback = callback;
+    int64_t start = esp_timer_get_time();
+    lv_lock();
+    metrics_record(METRIC_HIST_LOCK_WAIT_US, (uint32_t)(esp_timer_get_time() - start));
+}
+
+void ui_unlock(void)
+{
+    lv_unlock();
+}
+
+void ui_init(void)
+{
+    ui_show_home();
+}
+
+static void load_view(const ui_view_t *view)
+{
+    ui_lock();
+
+    /* Tear down first: on a reload the same view's state is rebuilt below */
+    ui_set_scroll_body(NULL);
+    if (s_active_view && s_active_view->destroy) {
+        s_active_view->destroy();
+    }
+
+    /* Every view gets its own opaque screen so nothing underneath is rendered */
+    lv_obj_t *old_screen = lv_screen_active();
+    lv_obj_t *screen = lv_obj_create(NULL);
+    lv_obj_set_style_bg_opa(screen, LV_OPA_COVER, 0);
+    lv_obj_remove_flag(screen, LV_OBJ_FLAG_SCROLLABLE);
+    view->create(screen);
+    lv_screen_load(screen);
+
+    /* May be called from an event of a widget on the old screen */
+    if (old_screen) {
+        lv_obj_delete_async(old_screen);
+    }
+
+    ESP_LOGI(TAG, "View: %s -> %s", s_active_view ? s_active_view->name : "-", view->name);
+    s_active_view = view;
+
+    ui_unlock();
+}
+
+void ui_show_view(const ui_view_t *view)
+{
+    if (!view || view == s_active_view) {
+        return;
+    }
+    load_view(view);
+}
+
+void ui_show_home(void)
+{
+    ui_show_view(&s_menu_view);
+}
+
+void ui_reload_view(void)
+{
+    /* Rebuild the active view, e.g. after the display resolution changed */
+    if (s_active_view) {
+        load_view(s_active_view);
+    }
+}
+
+void ui_set_button_callback(ui_button_id_t button, ui_button_callback_t callback)
+{
+    if (button >= 0 && button < UI_BUTTON_COUNT) {
+        s_button_callbacks[button] = callback;
+    }
+}
+
+void ui_set_scroll_body_callback(ui_scroll_body_callback_t callback)
+{
+    s_scroll_body_callback = callback;
+}
+
+void ui_set_scroll_body(lv_obj_t *body)
+{
+    if (s_scroll_body_callback) {
+        s_scroll_body_callback(body);
+    }
 }
 
 lv_obj_t *ui_get_touch_label(void)
@@ -97,12 +207,12 @@ lv_obj_t *ui_get_touch_label(void)
     return s_touch_label;
 }
 
-lv_obj_t *ui_get_cursor(void)
+lv_obj_t *ui_get_button(ui_button_id_t button)
 {
-    return s_cursor;
+    return ((unsigned)button < UI_BUTTON_COUNT) ? s_buttons[button] : NULL;
 }
 
-lv_obj_t *ui_get_main_screen(void)
+lv_obj_t *ui_get_cursor(void)
 {
-    return s_main_screen;
+    return s_cursor;
 }
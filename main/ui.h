@@ -3,9 +3,45 @@
 #include "lvgl.h"
 
 typedef void (*ui_button_callback_t)(void);
+typedef void (*ui_scroll_body_callback_t)(lv_obj_t *body);
+
+/* Menu buttons, in grid order */
+typedef enum {
+    UI_BUTTON_GREEN = 0,
+    UI_BUTTON_RED,
+    UI_BUTTON_YELLOW,
+    UI_BUTTON_MAGENTA,
+    UI_BUTTON_GREY,
+    UI_BUTTON_ORANGE,
+    UI_BUTTON_COUNT,
+} ui_button_id_t;
+
+/* An app view. Each view is built on its own opaque screen when it is shown
+ * and torn down when another view replaces it. */
+typedef struct {
+    const char *name;
+    void (*create)(lv_obj_t *screen);  /* Build widgets on a fresh screen */
+    void (*destroy)(void);             /* Drop references; the screen is deleted afterwards */
+} ui_view_t;
 
 void ui_init(void);
-void ui_set_green_button_callback(ui_button_callback_t callback);
+void ui_set_button_callback(ui_button_id_t button, ui_button_callback_t callback);
+void ui_show_view(const ui_view_t *view);
+void ui_show_home(void);
+void ui_reload_view(void);
 lv_obj_t *ui_get_touch_label(void);
+/* A menu button while the menu is shown, NULL otherwise */
+lv_obj_t *ui_get_button(ui_button_id_t button);
+
+/* A view's main scrollable area, set by the view in create() and cleared
+ * when it is replaced. The callback (installed by main.c, none on the host)
+ * may accelerate scrolling of that area in the panel. */
+void ui_set_scroll_body_callback(ui_scroll_body_callback_t callback);
+void ui_set_scroll_body(lv_obj_t *body);
+
 lv_obj_t *ui_get_cursor(void);
-lv_obj_t *ui_get_main_screen(void);
+
+/* lv_lock()/lv_unlock() for tasks other than the LVGL loop; the time spent
+ * waiting for the lock is recorded in the lock-wait histogram */
+void ui_lock(void);
+void ui_unlock(void);
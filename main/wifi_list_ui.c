@@ -0,0 +1,291 @@
+#include "wifi_list_ui.h"
+
+#include "scan_results.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define LIST_POLL_PERIOD_MS 100  /* How often the view checks for a new sweep */
+
+/* LVGL side of the WiFi scanner. Kept free of WiFi driver calls so it can
+ * also be built for the host UI bench (host_bench/). */
+
+static lv_obj_t *s_list_container = NULL;
+static lv_obj_t *s_list_body = NULL;
+static lv_obj_t *s_list_labels[MAX_AP_COUNT] = {0};
+static wifi_ap_info_t s_row_aps[MAX_AP_COUNT];  /* What each visible row shows */
+static lv_obj_t *s_exit_button = NULL;
+static lv_obj_t *s_location_label = NULL;
+static lv_timer_t *s_poll_timer = NULL;
+static uint32_t s_shown_version = 0;
+static wifi_list_record_request_t s_record_request = WIFI_LIST_RECORD_NONE;  /* Set by LVGL, taken by the scan task */
+static wifi_list_ui_visibility_callback_t s_visibility_cb = NULL;
+static wifi_list_ui_select_callback_t s_select_cb = NULL;
+
+/* Forward declarations */
+static void exit_button_event_cb(lv_event_t *e);
+static void record_button_event_cb(lv_event_t *e);
+static void row_event_cb(lv_event_t *e);
+static void create_wifi_list_ui(lv_obj_t *screen);
+static void destroy_wifi_list_ui(void);
+static void poll_results_cb(lv_timer_t *timer);
+
+const ui_view_t wifi_list_ui_view = {
+    .name = "wifi_scanner",
+    .create = create_wifi_list_ui,
+    .destroy = destroy_wifi_list_ui,
+};
+
+/* Called by ui_show_view() in LVGL context; the screen is already opaque */
+static void create_wifi_list_ui(lv_obj_t *screen)
+{
+    /* The screen itself is the list container, so nothing is drawn beneath it */
+    s_list_container = screen;
+    lv_obj_set_style_bg_color(s_list_container, lv_color_make(20, 20, 40), 0);
+    lv_obj_set_style_border_color(s_list_container, lv_color_make(100, 100, 150), 0);
+    lv_obj_set_style_border_width(s_list_container, 2, 0);
+    lv_obj_set_style_pad_all(s_list_container, 10, 0);
+    lv_obj_set_flex_flow(s_list_container, LV_FLEX_FLOW_COLUMN);
+    lv_obj_set_flex_align(s_list_container, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_START);
+    lv_obj_set_style_pad_row(s_list_container, 5, 0);
+    lv_obj_set_scrollbar_mode(s_list_container, LV_SCROLLBAR_MODE_OFF);
+
+    /* Create title label and exit button container */
+    lv_obj_t *header_container = lv_obj_create(s_list_container);
+    lv_obj_set_size(header_container, LV_PCT(100), LV_SIZE_CONTENT);
+    lv_obj_set_style_bg_opa(header_container, LV_OPA_TRANSP, 0);
+    lv_obj_set_style_border_width(header_container, 0, 0);
+    lv_obj_set_style_pad_all(header_container, 0, 0);
+    lv_obj_set_flex_flow(header_container, LV_FLEX_FLOW_ROW);
+    lv_obj_set_flex_align(header_container, LV_FLEX_ALIGN_SPACE_BETWEEN, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+
+    /* Add exit button on the left */
+    s_exit_button = lv_button_create(header_container);
+    lv_obj_set_size(s_exit_button, 60, 30);
+    lv_obj_set_style_bg_color(s_exit_button, lv_color_make(200, 0, 0), LV_PART_MAIN);
+    lv_obj_add_event_cb(s_exit_button, exit_button_event_cb, LV_EVENT_CLICKED, NULL);
+    
+    lv_obj_t *exit_label = lv_label_create(s_exit_button);
+    lv_label_set_text(exit_label, "Exit");
+    lv_obj_center(exit_label);
+    lv_obj_set_style_text_color(exit_label, lv_color_white(), 0);
+
+    /* Create title label */
+    lv_obj_t *title = lv_label_create(header_container);
+    lv_label_set_text(title, "WiFi Networks");
+    lv_obj_set_style_text_color(title, lv_color_white(), 0);
+    lv_obj_set_style_text_font(title, &lv_font_montserrat_16, 0);
+    lv_obj_set_flex_grow(title, 1);
+
+    /* Add fingerprint record button on the right */
+    lv_obj_t *record_button = lv_button_create(header_container);
+    lv_obj_set_size(record_button, 50, 30);
+    lv_obj_set_style_bg_color(record_button, lv_color_make(0, 120, 200), LV_PART_MAIN);
+    lv_obj_add_event_cb(record_button, record_button_event_cb, LV_EVENT_SHORT_CLICKED, NULL);
+    lv_obj_add_event_cb(record_button, record_button_event_cb, LV_EVENT_LONG_PRESSED, NULL);
+
+    lv_obj_t *record_label = lv_label_create(record_button);
+    lv_label_set_text(record_label, "Rec");
+    lv_obj_center(record_label);
+    lv_obj_set_style_text_color(record_label, lv_color_white(), 0);
+
+    /* Location matched from stored fingerprints */
+    s_location_label = lv_label_create(s_list_container);
+    lv_label_set_text(s_location_label, "Location: -");
+    lv_obj_set_style_text_color(s_location_label, lv_color_make(150, 200, 255), 0);
+
+    /* Create a separator */
+    lv_obj_t *separator = lv_obj_create(s_list_container);
+    lv_obj_set_size(separator, LV_PCT(100), 2);
+    lv_obj_set_style_bg_color(separator, lv_color_make(100, 100, 150), 0);
+    lv_obj_set_style_bg_opa(separator, LV_OPA_COVER, 0);
+    lv_obj_set_style_border_width(separator, 0, 0);
+
+    /* Only the rows scroll; header and location stay put. A transparent,
+     * full-height body over a plain background lets the panel scroll it in
+     * hardware (see ui_set_scroll_body()). */
+    s_list_body = lv_obj_create(s_list_container);
+    lv_obj_set_width(s_list_body, LV_PCT(100));
+    lv_obj_set_flex_grow(s_list_body, 1);
+    lv_obj_set_style_bg_opa(s_list_body, LV_OPA_TRANSP, 0);
+    lv_obj_set_style_border_width(s_list_body, 0, 0);
+    lv_obj_set_style_radius(s_list_body, 0, 0);
+    lv_obj_set_style_pad_all(s_list_body, 0, 0);
+    lv_obj_set_style_pad_row(s_list_body, 5, 0);
+    lv_obj_set_flex_flow(s_list_body, LV_FLEX_FLOW_COLUMN);
+    lv_obj_set_scrollbar_mode(s_list_body, LV_SCROLLBAR_MODE_OFF);
+
+    /* Pre-create labels for WiFi networks */
+    for (int i = 0; i < MAX_AP_COUNT; i++) {
+        s_list_labels[i] = lv_label_create(s_list_body);
+        lv_label_set_text(s_list_labels[i], "");
+        lv_obj_set_style_text_color(s_list_labels[i], lv_color_white(), 0);
+        lv_obj_set_width(s_list_labels[i], LV_PCT(100));
+        lv_label_set_long_mode(s_list_labels[i], LV_LABEL_LONG_DOT);
+        lv_obj_add_flag(s_list_labels[i], LV_OBJ_FLAG_HIDDEN);
+        /* Taps select the row; drags still scroll the body */
+        lv_obj_add_flag(s_list_labels[i], LV_OBJ_FLAG_CLICKABLE);
+        lv_obj_add_event_cb(s_list_labels[i], row_event_cb, LV_EVENT_CLICKED, (void *)(intptr_t)i);
+    }
+
+    /* Add scanning indicator */
+    lv_obj_t *scan_label = lv_label_create(s_list_body);
+    lv_label_set_text(scan_label, "Scanning...");
+    lv_obj_set_style_text_color(scan_label, lv_color_make(150, 150, 150), 0);
+
+    ui_set_scroll_body(s_list_body);
+
+    /* Pull sweeps as they are published; show the latest one right away */
+    s_shown_version = 0;
+    s_poll_timer = lv_timer_create(poll_results_cb, LIST_POLL_PERIOD_MS, NULL);
+    poll_results_cb(NULL);
+
+    if (s_visibility_cb) {
+        s_visibility_cb(true);
+    }
+}
+
+/* Called by ui_show_view() before the screen and its children are deleted */
+static void destroy_wifi_list_ui(void)
+{
+    if (s_visibility_cb) {
+        s_visibility_cb(false);
+    }
+    if (s_poll_timer) {
+        lv_timer_delete(s_poll_timer);
+        s_poll_timer = NULL;
+    }
+    s_list_container = NULL;
+    s_list_body = NULL;
+    s_exit_button = NULL;
+    s_location_label = NULL;
+    memset(s_list_labels, 0, sizeof(s_list_labels));
+}
+
+static const char *get_auth_mode_name(wifi_auth_mode_t authmode)
+{
+    switch (authmode) {
+        case WIFI_AUTH_OPEN: return "OPEN";
+        case WIFI_AUTH_WEP: return "WEP";
+        case WIFI_AUTH_WPA_PSK: return "WPA";
+        case WIFI_AUTH_WPA2_PSK: return "WPA2";
+        case WIFI_AUTH_WPA_WPA2_PSK: return "WPA/WPA2";
+        case WIFI_AUTH_WPA3_PSK: return "WPA3";
+        case WIFI_AUTH_WPA2_WPA3_PSK: return "WPA2/WPA3";
+        default: return "?";
+    }
+}
+
+static const char *get_trend_symbol(rssi_trend_t trend)
+{
+    switch (trend) {
+        case RSSI_TREND_RISING: return " " LV_SYMBOL_UP;
+        case RSSI_TREND_FALLING: return " " LV_SYMBOL_DOWN;
+        default: return "";
+    }
+}
+
+static void exit_button_event_cb(lv_event_t *e)
+{
+    lv_event_code_t code = lv_event_get_code(e);
+    if (code == LV_EVENT_CLICKED) {
+        /* Leave the scanner view; its screen is freed once the menu is loaded */
+        ui_show_home();
+    }
+}
+
+static void record_button_event_cb(lv_event_t *e)
+{
+    /* Picked up by the scan task after the next sweep */
+    lv_event_code_t code = lv_event_get_code(e);
+    if (code == LV_EVENT_SHORT_CLICKED) {
+        __atomic_store_n(&s_record_request, WIFI_LIST_RECORD_SAMPLE, __ATOMIC_RELEASE);
+    } else if (code == LV_EVENT_LONG_PRESSED) {
+        __atomic_store_n(&s_record_request, WIFI_LIST_RECORD_NEW_LOCATION, __ATOMIC_RELEASE);
+    }
+}
+
+static void row_event_cb(lv_event_t *e)
+{
+    int row = (int)(intptr_t)lv_event_get_user_data(e);
+    if (lv_event_get_code(e) == LV_EVENT_CLICKED && s_select_cb) {
+        s_select_cb(&s_row_aps[row]);
+    }
+}
+
+void wifi_list_ui_set_select_callback(wifi_list_ui_select_callback_t callback)
+{
+    s_select_cb = callback;
+}
+
+void wifi_list_ui_set_visibility_callback(wifi_list_ui_visibility_callback_t callback)
+{
+    s_visibility_cb = callback;
+}
+
+void wifi_list_ui_set_location(const char *text)
+{
+    /* Not shown: skip the lock rather than contend with the LVGL loop */
+    if (!s_location_label) {
+        return;
+    }
+    ui_lock();
+    if (s_location_label && strcmp(lv_label_get_text(s_location_label), text) != 0) {
+        lv_label_set_text(s_location_label, text);
+    }
+    ui_unlock();
+}
+
+/* Runs in LVGL context: show the latest published sweep if it is new */
+static void poll_results_cb(lv_timer_t *timer)
+{
+    (void)timer;
+    if (!s_list_container || scan_results_version() == s_shown_version) {
+        return;
+    }
+
+    const scan_snapshot_t *snap = scan_results_acquire();
+    if (!snap) {
+        return;
+    }
+    s_shown_version = snap->version;
+
+    /* Update labels; rows whose text and visibility are unchanged are left
+     * alone so they are not invalidated and redrawn */
+    for (int i = 0; i < MAX_AP_COUNT; i++) {
+        if (i < snap->ap_count) {
+            const wifi_ap_info_t *ap = &snap->aps[i];
+            s_row_aps[i] = *ap;
+            char buf[100];
+            /* Flagged by the rogue detector: marked until the BSSID is forgotten */
+            snprintf(buf, sizeof(buf), "%s%s (%ddBm%s) [%s]",
+                    ap->alerts ? LV_SYMBOL_WARNING " " : "",
+                    ap->ssid,
+                    rssi_filter_to_dbm(ap->rssi_q4),
+                    get_trend_symbol(ap->trend),
+                    get_auth_mode_name(ap->authmode));
+            if (strcmp(lv_label_get_text(s_list_labels[i]), buf) != 0) {
+                lv_label_set_text(s_list_labels[i], buf);
+            }
+            if (lv_obj_has_flag(s_list_labels[i], LV_OBJ_FLAG_HIDDEN)) {
+                lv_obj_remove_flag(s_list_labels[i], LV_OBJ_FLAG_HIDDEN);
+            }
+        } else if (!lv_obj_has_flag(s_list_labels[i], LV_OBJ_FLAG_HIDDEN)) {
+            lv_obj_add_flag(s_list_labels[i], LV_OBJ_FLAG_HIDDEN);
+        }
+    }
+
+    scan_results_release(snap);
+}
+
+wifi_list_record_request_t wifi_list_ui_take_record_request(void)
+{
+    /* One step, so a press landing between a read and a clear is not lost */
+    return __atomic_exchange_n(&s_record_request, WIFI_LIST_RECORD_NONE, __ATOMIC_ACQ_REL);
+}
+
+lv_obj_t *wifi_list_ui_get_container(void)
+{
+    return s_list_container;
+}
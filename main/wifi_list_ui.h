@@ -0,0 +1,61 @@
+#pragma once
+
+#include "ui.h"
+#include "wifi_scanner.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/* The scanner view: header with Exit/Rec buttons, location line and one
+ * row per network; tapping a row selects that network. Shown with ui_show_view(&wifi_list_ui_view); while shown
+ * it pulls each sweep published through scan_results.h. */
+extern const ui_view_t wifi_list_ui_view;
+
+/* Told when the view is built (true) and torn down (false) */
+typedef void (*wifi_list_ui_visibility_callback_t)(bool visible);
+
+/**
+ * @brief Set the callback run when the view is shown or hidden
+ *
+ * Lets the scanner pause while nobody looks at the list; none on the host.
+ *
+ * @param callback Callback, NULL for none
+ */
+void wifi_list_ui_set_visibility_callback(wifi_list_ui_visibility_callback_t callback);
+
+/* Told which AP the user tapped */
+typedef void (*wifi_list_ui_select_callback_t)(const wifi_ap_info_t *ap);
+
+/**
+ * @brief Set the callback run in LVGL context when a row is tapped
+ *
+ * @param callback Callback, NULL to make rows inert
+ */
+void wifi_list_ui_set_select_callback(wifi_list_ui_select_callback_t callback);
+
+/**
+ * @brief Set the location line
+ *
+ * @param[in] text Text to show
+ */
+void wifi_list_ui_set_location(const char *text);
+
+/* What the Rec button asked for */
+typedef enum {
+    WIFI_LIST_RECORD_NONE = 0,
+    WIFI_LIST_RECORD_SAMPLE,        /* Tap: another sample of the selected location */
+    WIFI_LIST_RECORD_NEW_LOCATION,  /* Long press: first sample of a new location */
+} wifi_list_record_request_t;
+
+/**
+ * @brief Take a pending fingerprint record request from the Rec button
+ *
+ * @return The request, once per button press; WIFI_LIST_RECORD_NONE if none
+ */
+wifi_list_record_request_t wifi_list_ui_take_record_request(void);
+
+/**
+ * @brief Get the list container (the view's screen)
+ *
+ * @return Container, or NULL if the view is not shown
+ */
+lv_obj_t *wifi_list_ui_get_container(void);
@@ -1,253 +1,434 @@
 #include "wifi_scanner.h"
-#include "cyd_display_config.h"
+#include "cyd_config.h"
+#include "fingerprint.h"
+#include "metrics.h"
+#include "power.h"
+#include "rogue_detect.h"
+#include "rssi_filter.h"
+#include "scan_results.h"
+#include "tuning.h"
+#include "ui.h"
+#include "wifi_list_ui.h"
+#include "wifi_track.h"
+#include "wifi_track_ui.h"
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/event_groups.h"
+#include "freertos/semphr.h"
 
 #include "esp_wifi.h"
 #include "esp_event.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "nvs_flash.h"
 
+#include <stdlib.h>
 #include <string.h>
 
 static const char *TAG = "wifi_scanner";
 
-#define WIFI_SCAN_INTERVAL_MS 2000
-#define MAX_AP_COUNT 20
+#define RSSI_RANK_HYSTERESIS_DB 3  /* Smoothed gap needed before two rows swap */
+
+static const char *const s_state_names[] = {
+    [WIFI_SCANNER_STOPPED] = "stopped",
+    [WIFI_SCANNER_RUNNING] = "running",
+    [WIFI_SCANNER_PAUSED] = "paused",
+};
 
 static TaskHandle_t s_scan_task_handle = NULL;
-static lv_obj_t *s_list_container = NULL;
-static lv_obj_t *s_list_labels[MAX_AP_COUNT] = {0};
-static lv_obj_t *s_exit_button = NULL;
+static SemaphoreHandle_t s_scan_mutex = NULL;
+static SemaphoreHandle_t s_task_exited = NULL;  /* Given by the scan task as it returns */
+static esp_netif_t *s_sta_netif = NULL;
 static bool s_wifi_initialized = false;
+static wifi_scanner_state_t s_state = WIFI_SCANNER_STOPPED;  /* __atomic access only */
+static volatile bool s_view_visible = false;
+
+static int compare_prev_rank(const void *a, const void *b)
+{
+    const wifi_ap_info_t *ap_a = (const wifi_ap_info_t *)a;
+    const wifi_ap_info_t *ap_b = (const wifi_ap_info_t *)b;
+    if (ap_a->prev_rank != ap_b->prev_rank) {
+        return ap_a->prev_rank - ap_b->prev_rank; /* Previous order first, new APs last */
+    }
+    return ap_b->rssi_q4 - ap_a->rssi_q4; /* New APs by smoothed signal, descending */
+}
+
+/* Order APs by smoothed RSSI, but only let a row overtake the one above it
+ * when it is stronger by more than RSSI_RANK_HYSTERESIS_DB. Starting from the
+ * previous order keeps rows in place while their estimates are close. */
+static void rank_ap_list(wifi_ap_info_t *ap_list, uint16_t ap_count)
+{
+    const int hysteresis_q4 = RSSI_RANK_HYSTERESIS_DB << RSSI_FILTER_Q;
 
-/* WiFi scan result structure */
-typedef struct {
-    char ssid[33];
-    int8_t rssi;
-    wifi_auth_mode_t authmode;
-} wifi_ap_info_t;
+    qsort(ap_list, ap_count, sizeof(wifi_ap_info_t), compare_prev_rank);
 
-/* Forward declarations */
-static void exit_button_event_cb(lv_event_t *e);
+    for (int i = 1; i < ap_count; i++) {
+        wifi_ap_info_t ap = ap_list[i];
+        int j = i;
+        while (j > 0 && ap.rssi_q4 > ap_list[j - 1].rssi_q4 + hysteresis_q4) {
+            ap_list[j] = ap_list[j - 1];
+            j--;
+        }
+        ap_list[j] = ap;
+    }
+
+    for (int i = 0; i < ap_count; i++) {
+        rssi_filter_set_rank(ap_list[i].bssid, (uint8_t)i);
+    }
+    rssi_filter_end_sweep();
+}
 
-static void create_wifi_list_ui(lv_obj_t *parent_screen)
+/* Record the sweep if requested, then locate it against stored fingerprints */
+static void process_fingerprints(const wifi_ap_info_t *ap_list, uint16_t ap_count)
 {
-    /* Lock LVGL before making UI updates from another task */
-    lv_lock();
-
-    /* Create main container for WiFi list */
-    s_list_container = lv_obj_create(parent_screen);
-    lv_obj_set_size(s_list_container, LCD_H_RES - 20, LCD_V_RES - 40);
-    lv_obj_align(s_list_container, LV_ALIGN_CENTER, 0, 10);
-    lv_obj_set_style_bg_color(s_list_container, lv_color_make(20, 20, 40), 0);
-    lv_obj_set_style_bg_opa(s_list_container, LV_OPA_90, 0);
-    lv_obj_set_style_border_color(s_list_container, lv_color_make(100, 100, 150), 0);
-    lv_obj_set_style_border_width(s_list_container, 2, 0);
-    lv_obj_set_style_pad_all(s_list_container, 10, 0);
-    lv_obj_set_flex_flow(s_list_container, LV_FLEX_FLOW_COLUMN);
-    lv_obj_set_flex_align(s_list_container, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_START);
-    lv_obj_set_style_pad_row(s_list_container, 5, 0);
-    lv_obj_set_scrollbar_mode(s_list_container, LV_SCROLLBAR_MODE_OFF);
-
-    /* Create title label and exit button container */
-    lv_obj_t *header_container = lv_obj_create(s_list_container);
-    lv_obj_set_size(header_container, LV_PCT(100), LV_SIZE_CONTENT);
-    lv_obj_set_style_bg_opa(header_container, LV_OPA_TRANSP, 0);
-    lv_obj_set_style_border_width(header_container, 0, 0);
-    lv_obj_set_style_pad_all(header_container, 0, 0);
-    lv_obj_set_flex_flow(header_container, LV_FLEX_FLOW_ROW);
-    lv_obj_set_flex_align(header_container, LV_FLEX_ALIGN_SPACE_BETWEEN, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
-
-    /* Add exit button on the left */
-    s_exit_button = lv_button_create(header_container);
-    lv_obj_set_size(s_exit_button, 60, 30);
-    lv_obj_set_style_bg_color(s_exit_button, lv_color_make(200, 0, 0), LV_PART_MAIN);
-    lv_obj_add_event_cb(s_exit_button, exit_button_event_cb, LV_EVENT_CLICKED, NULL);
-    
-    lv_obj_t *exit_label = lv_label_create(s_exit_button);
-    lv_label_set_text(exit_label, "Exit");
-    lv_obj_center(exit_label);
-    lv_obj_set_style_text_color(exit_label, lv_color_white(), 0);
-
-    /* Create title label */
-    lv_obj_t *title = lv_label_create(header_container);
-    lv_label_set_text(title, "WiFi Networks");
-    lv_obj_set_style_text_color(title, lv_color_white(), 0);
-    lv_obj_set_style_text_font(title, &lv_font_montserrat_16, 0);
-    lv_obj_set_flex_grow(title, 1);
-
-    /* Create a separator */
-    lv_obj_t *separator = lv_obj_create(s_list_container);
-    lv_obj_set_size(separator, LV_PCT(100), 2);
-    lv_obj_set_style_bg_color(separator, lv_color_make(100, 100, 150), 0);
-    lv_obj_set_style_bg_opa(separator, LV_OPA_COVER, 0);
-    lv_obj_set_style_border_width(separator, 0, 0);
-
-    /* Pre-create labels for WiFi networks */
-    for (int i = 0; i < MAX_AP_COUNT; i++) {
-        s_list_labels[i] = lv_label_create(s_list_container);
-        lv_label_set_text(s_list_labels[i], "");
-        lv_obj_set_style_text_color(s_list_labels[i], lv_color_white(), 0);
-        lv_obj_set_width(s_list_labels[i], LV_PCT(100));
-        lv_label_set_long_mode(s_list_labels[i], LV_LABEL_LONG_DOT);
-        lv_obj_add_flag(s_list_labels[i], LV_OBJ_FLAG_HIDDEN);
-    }
-
-    /* Add scanning indicator */
-    lv_obj_t *scan_label = lv_label_create(s_list_container);
-    lv_label_set_text(scan_label, "Scanning...");
-    lv_obj_set_style_text_color(scan_label, lv_color_make(150, 150, 150), 0);
-
-    /* Unlock LVGL */
-    lv_unlock();
+    wifi_list_record_request_t request = wifi_list_ui_take_record_request();
+    if (request != WIFI_LIST_RECORD_NONE) {
+        /* Samples go to the selected location until a long press or the
+         * console picks another; the first one starts a new location */
+        char label[FINGERPRINT_LABEL_LEN];
+        fingerprint_get_location(label);
+        if (request == WIFI_LIST_RECORD_NEW_LOCATION || label[0] == '\0') {
+            fingerprint_set_location(NULL);
+            fingerprint_get_location(label);
+        }
+        fingerprint_record(label, ap_list, ap_count);
+    }
+
+    /* Nobody would see the location */
+    if (fingerprint_count() == 0 || !s_view_visible) {
+        return;
+    }
+
+    fingerprint_match_t match;
+    char buf[64];
+    if (fingerprint_match(ap_list, ap_count, &match) == ESP_OK) {
+        ESP_LOGI(TAG, "Location '%s' (%u/%d votes, d=%lu) in %lu us over %lu fingerprints",
+                 match.label, match.votes, FINGERPRINT_K, (unsigned long)match.distance,
+                 (unsigned long)match.elapsed_us, (unsigned long)fingerprint_count());
+        snprintf(buf, sizeof(buf), "Location: %s (%u/%d)", match.label, match.votes, FINGERPRINT_K);
+    } else {
+        snprintf(buf, sizeof(buf), "Location: -");
+    }
+    wifi_list_ui_set_location(buf);
 }
 
-static const char *get_auth_mode_name(wifi_auth_mode_t authmode)
+static void publish_sweep(const wifi_ap_info_t *ap_list, uint16_t ap_count)
 {
-    switch (authmode) {
-        case WIFI_AUTH_OPEN: return "OPEN";
-        case WIFI_AUTH_WEP: return "WEP";
-        case WIFI_AUTH_WPA_PSK: return "WPA";
-        case WIFI_AUTH_WPA2_PSK: return "WPA2";
-        case WIFI_AUTH_WPA_WPA2_PSK: return "WPA/WPA2";
-        case WIFI_AUTH_WPA3_PSK: return "WPA3";
-        case WIFI_AUTH_WPA2_WPA3_PSK: return "WPA2/WPA3";
-        default: return "?";
+    scan_snapshot_t *snap = scan_results_begin();
+    if (!snap) {
+        /* Every free slot is held by a reader; never wait for them */
+        ESP_LOGW(TAG, "No free snapshot, sweep not published");
+        return;
     }
+    memcpy(snap->aps, ap_list, ap_count * sizeof(wifi_ap_info_t));
+    snap->ap_count = ap_count;
+    scan_results_publish(snap);
 }
 
-static int compare_rssi(const void *a, const void *b)
+/* Tracking scans are accounted apart so they do not skew sweep times,
+ * sweep counts or sweeps per mAh */
+static esp_err_t scan_sweep_locked(const wifi_scan_config_t *scan_config, bool track, wifi_ap_record_t *ap_records,
+                                   uint16_t *ap_count, uint32_t *elapsed_us)
 {
-    const wifi_ap_info_t *ap_a = (const wifi_ap_info_t *)a;
-    const wifi_ap_info_t *ap_b = (const wifi_ap_info_t *)b;
-    return ap_b->rssi - ap_a->rssi; /* Sort descending */
+    int64_t scan_start_us = esp_timer_get_time();
+    esp_err_t ret = esp_wifi_scan_start(scan_config, true);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "WiFi scan start failed: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    uint32_t scan_us = (uint32_t)(esp_timer_get_time() - scan_start_us);
+    metrics_record(track ? METRIC_HIST_TRACK_SCAN_US : METRIC_HIST_SCAN_US, scan_us);
+    metrics_inc(track ? METRIC_CNT_TRACK_SCANS : METRIC_CNT_SCANS, 1);
+    power_add_time(track ? POWER_STATE_TRACK : POWER_STATE_SCAN, scan_us);
+    if (elapsed_us) {
+        *elapsed_us = scan_us;
+    }
+
+    uint16_t found = 0;
+    ret = esp_wifi_scan_get_ap_num(&found);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to get AP count: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    if (!track) {
+        metrics_set(METRIC_GAUGE_SCAN_APS, found);
+    }
+
+    if (!ap_records || found == 0) {
+        /* Free the driver's copy of the results */
+        esp_wifi_clear_ap_list();
+        *ap_count = ap_records ? 0 : found;
+        return ESP_OK;
+    }
+
+    if (found < *ap_count) {
+        *ap_count = found;
+    }
+    ret = esp_wifi_scan_get_ap_records(ap_count, ap_records);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to get AP records: %s", esp_err_to_name(ret));
+    }
+    return ret;
 }
 
-static void exit_button_event_cb(lv_event_t *e)
+/* Run a scan under the scan mutex; track marks a scan locked to a tracked AP */
+static esp_err_t run_sweep(const wifi_scan_config_t *scan_config, bool track, wifi_ap_record_t *ap_records,
+                           uint16_t *ap_count, uint32_t *elapsed_us)
 {
-    lv_event_code_t code = lv_event_get_code(e);
-    if (code == LV_EVENT_CLICKED) {
-        /* Hide the WiFi scanner container */
-        if (s_list_container) {
-            lv_obj_add_flag(s_list_container, LV_OBJ_FLAG_HIDDEN);
-        }
+    /* WiFi may have been released by wifi_scanner_stop() meanwhile */
+    xSemaphoreTake(s_scan_mutex, portMAX_DELAY);
+    esp_err_t ret = s_wifi_initialized ? scan_sweep_locked(scan_config, track, ap_records, ap_count, elapsed_us)
+                                       : ESP_ERR_INVALID_STATE;
+    xSemaphoreGive(s_scan_mutex);
+
+    if (ret != ESP_OK) {
+        metrics_inc(METRIC_CNT_SCAN_ERRORS, 1);
     }
+    return ret;
 }
 
-static void update_wifi_list_ui(wifi_ap_info_t *ap_list, uint16_t ap_count)
+/* One blocking sweep with the current tuning. Sweeps from the scan task and
+ * the console are serialized so neither sees the other's results. Up to
+ * *ap_count records are copied to ap_records (or dropped if it is NULL);
+ * *ap_count is set to the number copied, or found if dropped. */
+static esp_err_t scan_sweep(wifi_ap_record_t *ap_records, uint16_t *ap_count, uint32_t *elapsed_us)
 {
-    if (!s_list_container) {
-        return;
+    uint16_t dwell_ms = (uint16_t)tuning_get(TUNING_SCAN_DWELL_MS);
+    wifi_scan_config_t scan_config = {
+        .ssid = NULL,
+        .bssid = NULL,
+        .channel = 0,
+        .show_hidden = false,
+    };
+    if (tuning_get(TUNING_SCAN_PASSIVE)) {
+        scan_config.scan_type = WIFI_SCAN_TYPE_PASSIVE;
+        scan_config.scan_time.passive = dwell_ms;
+    } else {
+        scan_config.scan_type = WIFI_SCAN_TYPE_ACTIVE;
+        scan_config.scan_time.active.min = 0;
+        scan_config.scan_time.active.max = dwell_ms;
     }
 
-    /* Lock LVGL before making UI updates from another task */
-    lv_lock();
+    return run_sweep(&scan_config, false, ap_records, ap_count, elapsed_us);
+}
 
-    /* Sort by signal strength */
-    qsort(ap_list, ap_count, sizeof(wifi_ap_info_t), compare_rssi);
+/* One scan locked to the tracked AP's channel and BSSID. A full sweep dwells
+ * on every channel; this one only waits for the target's probe response, or
+ * in passive mode for one of its beacons. */
+static void track_sweep(const wifi_track_target_t *target, uint32_t gen)
+{
+    wifi_scan_config_t scan_config = {
+        .ssid = NULL,
+        .bssid = (uint8_t *)target->bssid,
+        .channel = target->channel,
+        .show_hidden = true,
+    };
+    if (tuning_get(TUNING_SCAN_PASSIVE)) {
+        scan_config.scan_type = WIFI_SCAN_TYPE_PASSIVE;
+        scan_config.scan_time.passive = WIFI_TRACK_BEACON_DWELL_MS;
+    } else {
+        scan_config.scan_type = WIFI_SCAN_TYPE_ACTIVE;
+        scan_config.scan_time.active.min = WIFI_TRACK_DWELL_MS;
+        scan_config.scan_time.active.max = WIFI_TRACK_DWELL_MS;
+    }
 
-    /* Update labels */
-    for (int i = 0; i < MAX_AP_COUNT; i++) {
-        if (i < ap_count) {
-            char buf[100];
-            snprintf(buf, sizeof(buf), "%s (%ddBm) [%s]",
-                    ap_list[i].ssid,
-                    ap_list[i].rssi,
-                    get_auth_mode_name(ap_list[i].authmode));
-            lv_label_set_text(s_list_labels[i], buf);
-            lv_obj_remove_flag(s_list_labels[i], LV_OBJ_FLAG_HIDDEN);
-        } else {
-            lv_obj_add_flag(s_list_labels[i], LV_OBJ_FLAG_HIDDEN);
-        }
+    wifi_ap_record_t record;
+    uint16_t found = 1;
+    if (run_sweep(&scan_config, true, &record, &found, NULL) == ESP_OK) {
+        wifi_track_push(gen, found > 0, record.rssi, esp_timer_get_time());
     }
+}
 
-    /* Unlock LVGL */
-    lv_unlock();
+static wifi_scanner_state_t get_state(void)
+{
+    return __atomic_load_n(&s_state, __ATOMIC_ACQUIRE);
+}
+
+/* Move from one state to another; false if the scanner was not in `from` */
+static bool change_state(wifi_scanner_state_t from, wifi_scanner_state_t to)
+{
+    if (!__atomic_compare_exchange_n(&s_state, &from, to, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        return false;
+    }
+    /* Wake the task so it sees the new state now rather than next interval */
+    if (s_scan_task_handle) {
+        xTaskNotifyGive(s_scan_task_handle);
+    }
+    return true;
+}
+
+/* Block until the next sweep is due: scan_interval after the last one, or
+ * WIFI_TRACK_INTERVAL_MS while tracking, and not paused. Pausing and
+ * resuming do not shift the schedule, so hiding and showing the view quickly
+ * costs no extra sweep. Returns false once the scanner is stopping; otherwise
+ * *track_gen is the tracked target's generation, 0 for a full sweep. */
+static bool wait_next_sweep(TickType_t last_sweep, wifi_track_target_t *target, uint32_t *track_gen)
+{
+    while (1) {
+        wifi_scanner_state_t state = get_state();
+        if (state == WIFI_SCANNER_STOPPED) {
+            return false;
+        }
+        *track_gen = wifi_track_get_target(target);
+        TickType_t interval = pdMS_TO_TICKS(*track_gen ? WIFI_TRACK_INTERVAL_MS
+                                                       : tuning_get(TUNING_SCAN_INTERVAL_MS));
+        TickType_t elapsed = xTaskGetTickCount() - last_sweep;
+        if (state == WIFI_SCANNER_RUNNING && elapsed >= interval) {
+            return true;
+        }
+        ulTaskNotifyTake(pdTRUE, state == WIFI_SCANNER_PAUSED ? portMAX_DELAY : interval - elapsed);
+    }
 }
 
 static void wifi_scan_task(void *pvParameters)
 {
     (void)pvParameters;
     wifi_ap_info_t ap_list[MAX_AP_COUNT];
+    wifi_ap_record_t ap_records[MAX_AP_COUNT];
+    wifi_track_target_t target;
+    uint32_t track_gen;
     
     ESP_LOGI(TAG, "WiFi scan task started");
 
-    while (1) {
-        /* Start WiFi scan */
-        wifi_scan_config_t scan_config = {
-            .ssid = NULL,
-            .bssid = NULL,
-            .channel = 0,
-            .show_hidden = false,
-            .scan_type = WIFI_SCAN_TYPE_ACTIVE,
-            .scan_time.active.min = 0,
-            .scan_time.active.max = 0,
-        };
-
-        esp_err_t ret = esp_wifi_scan_start(&scan_config, true);
-        if (ret != ESP_OK) {
-            ESP_LOGE(TAG, "WiFi scan start failed: %s", esp_err_to_name(ret));
-            vTaskDelay(pdMS_TO_TICKS(WIFI_SCAN_INTERVAL_MS));
-            continue;
+    /* First sweep right away */
+    TickType_t last_sweep = xTaskGetTickCount() - pdMS_TO_TICKS(tuning_get(TUNING_SCAN_INTERVAL_MS));
+    while (wait_next_sweep(last_sweep, &target, &track_gen)) {
+        /* Priority is tunable at runtime */
+        UBaseType_t priority = (UBaseType_t)tuning_get(TUNING_SCAN_PRIORITY);
+        if (uxTaskPriorityGet(NULL) != priority) {
+            vTaskPrioritySet(NULL, priority);
         }
 
-        /* Yield to allow watchdog reset */
-        vTaskDelay(1);
-
-        /* Get scan results */
-        uint16_t ap_count = 0;
-        ret = esp_wifi_scan_get_ap_num(&ap_count);
-        if (ret != ESP_OK) {
-            ESP_LOGE(TAG, "Failed to get AP count: %s", esp_err_to_name(ret));
-            vTaskDelay(pdMS_TO_TICKS(WIFI_SCAN_INTERVAL_MS));
+        /* Tracking one AP: no sweep processing, only its RSSI */
+        if (track_gen) {
+            track_sweep(&target, track_gen);
+            last_sweep = xTaskGetTickCount();
             continue;
         }
 
-        if (ap_count > MAX_AP_COUNT) {
-            ap_count = MAX_AP_COUNT;
+        uint16_t ap_count = MAX_AP_COUNT;
+        esp_err_t ret = scan_sweep(ap_records, &ap_count, NULL);
+        last_sweep = xTaskGetTickCount();
+        /* A sweep cut short by wifi_scanner_stop() is incomplete */
+        if (ret != ESP_OK || get_state() == WIFI_SCANNER_STOPPED) {
+            continue;
         }
 
-        if (ap_count > 0) {
-            wifi_ap_record_t ap_records[MAX_AP_COUNT];
-            ret = esp_wifi_scan_get_ap_records(&ap_count, ap_records);
-            if (ret != ESP_OK) {
-                ESP_LOGE(TAG, "Failed to get AP records: %s", esp_err_to_name(ret));
-                vTaskDelay(pdMS_TO_TICKS(WIFI_SCAN_INTERVAL_MS));
-                continue;
-            }
+        /* Yield to allow watchdog reset */
+        vTaskDelay(1);
 
-            /* Copy to our simplified structure */
+        if (ap_count > 0) {
+            /* Copy to our simplified structure and smooth RSSI per BSSID */
             for (int i = 0; i < ap_count; i++) {
+                rssi_filter_state_t state;
                 strncpy(ap_list[i].ssid, (char *)ap_records[i].ssid, sizeof(ap_list[i].ssid) - 1);
                 ap_list[i].ssid[sizeof(ap_list[i].ssid) - 1] = '\0';
+                memcpy(ap_list[i].bssid, ap_records[i].bssid, sizeof(ap_list[i].bssid));
+                ap_list[i].channel = ap_records[i].primary;
                 ap_list[i].rssi = ap_records[i].rssi;
                 ap_list[i].authmode = ap_records[i].authmode;
+
+                rssi_filter_update(ap_records[i].bssid, ap_records[i].rssi, &state);
+                ap_list[i].rssi_q4 = state.rssi_q4;
+                ap_list[i].trend = state.trend;
+                ap_list[i].prev_rank = state.rank;
+
+                /* Checked as each record arrives, before the list is reordered */
+                ap_list[i].alerts = ROGUE_DETECT_ENABLE ? rogue_detect_record(&ap_list[i]) : 0;
             }
 
             ESP_LOGI(TAG, "Found %d WiFi networks", ap_count);
 
-            /* Update UI in LVGL context */
-            update_wifi_list_ui(ap_list, ap_count);
+            rank_ap_list(ap_list, ap_count);
+            process_fingerprints(ap_list, ap_count);
         } else {
             ESP_LOGI(TAG, "No WiFi networks found");
-            update_wifi_list_ui(NULL, 0);
+            rssi_filter_end_sweep();
+        }
+        if (ROGUE_DETECT_ENABLE) {
+            rogue_detect_end_sweep();
         }
 
-        /* Wait before next scan */
-        vTaskDelay(pdMS_TO_TICKS(WIFI_SCAN_INTERVAL_MS));
+        /* Hand the sweep to the list view, logger and console */
+        publish_sweep(ap_list, ap_count);
+    }
+
+    ESP_LOGI(TAG, "WiFi scan task exiting");
+    xSemaphoreGive(s_task_exited);
+    vTaskDelete(NULL);
+}
+
+/* Runs in the scan task for each rogue detector alert */
+static void on_rogue_alert(const rogue_alert_t *alert, void *arg)
+{
+    (void)arg;
+    ESP_LOGW(TAG, "Rogue AP alert %s: \"%s\" %02x:%02x:%02x:%02x:%02x:%02x ch%u %d dBm (was %d)",
+             rogue_alert_name(alert->type), alert->ssid,
+             alert->bssid[0], alert->bssid[1], alert->bssid[2],
+             alert->bssid[3], alert->bssid[4], alert->bssid[5],
+             alert->channel, alert->rssi, alert->before);
+    metrics_inc(METRIC_CNT_ROGUE_ALERTS, 1);
+}
+
+/* Runs in LVGL context when the list or tracking view is built or torn down */
+static void on_view_visibility(bool visible)
+{
+    s_view_visible = visible;
+    if (!WIFI_SCAN_PAUSE_HIDDEN) {
+        return;
+    }
+    if (visible) {
+        if (change_state(WIFI_SCANNER_PAUSED, WIFI_SCANNER_RUNNING)) {
+            ESP_LOGI(TAG, "Scanner view shown, scanning resumed");
+        }
+    } else if (change_state(WIFI_SCANNER_RUNNING, WIFI_SCANNER_PAUSED)) {
+        ESP_LOGI(TAG, "Scanner view hidden, scanning paused");
+    }
+}
+
+/* The list is back: full sweeps again */
+static void on_list_visibility(bool visible)
+{
+    if (visible) {
+        wifi_track_end();
+    }
+    on_view_visibility(visible);
+}
+
+/* Runs in LVGL context when a list row is tapped */
+static void on_ap_selected(const wifi_ap_info_t *ap)
+{
+    ESP_LOGI(TAG, "Tracking %s on channel %u", ap->ssid, ap->channel);
+    wifi_track_begin(ap);
+    ui_show_view(&wifi_track_ui_view);
+    /* Also if the scanner was not paused: cut the wait for the next full sweep */
+    if (s_scan_task_handle) {
+        xTaskNotifyGive(s_scan_task_handle);
     }
 }
 
 esp_err_t wifi_scanner_init(void)
 {
     if (s_wifi_initialized) {
-        ESP_LOGW(TAG, "WiFi already initialized");
         return ESP_OK;
     }
 
+    if (!s_scan_mutex) {
+        s_scan_mutex = xSemaphoreCreateMutex();
+        if (!s_scan_mutex) {
+            ESP_LOGE(TAG, "Failed to create scan mutex");
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    if (!s_task_exited) {
+        s_task_exited = xSemaphoreCreateBinary();
+        if (!s_task_exited) {
+            ESP_LOGE(TAG, "Failed to create task exit semaphore");
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
     /* Initialize NVS (required by WiFi) */
     esp_err_t ret = nvs_flash_init();
     if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
@@ -274,8 +455,8 @@ esp_err_t wifi_scanner_init(void)
     }
 
     /* Create WiFi station interface */
-    esp_netif_t *sta_netif = esp_netif_create_default_wifi_sta();
-    if (!sta_netif) {
+    s_sta_netif = esp_netif_create_default_wifi_sta();
+    if (!s_sta_netif) {
         ESP_LOGE(TAG, "Failed to create WiFi STA interface");
         return ESP_FAIL;
     }
@@ -288,6 +469,12 @@ esp_err_t wifi_scanner_init(void)
         return ret;
     }
 
+    /* Fingerprint database is optional; scanning works without it */
+    ret = fingerprint_init();
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Fingerprint database unavailable: %s", esp_err_to_name(ret));
+    }
+
     /* Set WiFi mode to station */
     ret = esp_wifi_set_mode(WIFI_MODE_STA);
     if (ret != ESP_OK) {
@@ -307,7 +494,7 @@ esp_err_t wifi_scanner_init(void)
     return ESP_OK;
 }
 
-esp_err_t wifi_scanner_start(lv_obj_t *parent_screen)
+esp_err_t wifi_scanner_start(void)
 {
     if (!s_wifi_initialized) {
         ESP_LOGE(TAG, "WiFi not initialized. Call wifi_scanner_init() first");
@@ -316,48 +503,125 @@ esp_err_t wifi_scanner_start(lv_obj_t *parent_screen)
 
     if (s_scan_task_handle != NULL) {
         ESP_LOGW(TAG, "Scan task already running");
-        /* Make sure container is visible */
-        if (s_list_container) {
-            lv_lock();
-            lv_obj_remove_flag(s_list_container, LV_OBJ_FLAG_HIDDEN);
-            lv_unlock();
+    } else {
+        if (ROGUE_DETECT_ENABLE) {
+            rogue_detect_set_callback(on_rogue_alert, NULL);
         }
-        return ESP_OK;
-    }
 
-    /* Create UI */
-    create_wifi_list_ui(parent_screen);
+        /* Create scan task */
+        __atomic_store_n(&s_state, WIFI_SCANNER_RUNNING, __ATOMIC_RELEASE);
+        BaseType_t ret = xTaskCreate(
+            wifi_scan_task,
+            "wifi_scan",
+            8192,
+            NULL,
+            tuning_get(TUNING_SCAN_PRIORITY),
+            &s_scan_task_handle
+        );
+
+        if (ret != pdPASS) {
+            __atomic_store_n(&s_state, WIFI_SCANNER_STOPPED, __ATOMIC_RELEASE);
+            ESP_LOGE(TAG, "Failed to create WiFi scan task");
+            return ESP_FAIL;
+        }
+        ESP_LOGI(TAG, "WiFi scanner started");
+    }
 
-    /* Create scan task */
-    BaseType_t ret = xTaskCreate(
-        wifi_scan_task,
-        "wifi_scan",
-        8192,
-        NULL,
-        5,
-        &s_scan_task_handle
-    );
+    /* Build (or rebuild) the scanner view; it is created lazily on each
+     * entry and resumes a paused scanner */
+    wifi_list_ui_set_visibility_callback(on_list_visibility);
+    wifi_list_ui_set_select_callback(on_ap_selected);
+    wifi_track_ui_set_visibility_callback(on_view_visibility);
+    ui_lock();
+    ui_show_view(&wifi_list_ui_view);
+    ui_unlock();
+    return ESP_OK;
+}
 
-    if (ret != pdPASS) {
-        ESP_LOGE(TAG, "Failed to create WiFi scan task");
-        return ESP_FAIL;
+esp_err_t wifi_scanner_pause(void)
+{
+    if (change_state(WIFI_SCANNER_RUNNING, WIFI_SCANNER_PAUSED)) {
+        ESP_LOGI(TAG, "WiFi scanner paused");
+        return ESP_OK;
     }
+    return get_state() == WIFI_SCANNER_PAUSED ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
 
-    ESP_LOGI(TAG, "WiFi scanner started");
-    return ESP_OK;
+esp_err_t wifi_scanner_resume(void)
+{
+    if (change_state(WIFI_SCANNER_PAUSED, WIFI_SCANNER_RUNNING)) {
+        ESP_LOGI(TAG, "WiFi scanner resumed");
+        return ESP_OK;
+    }
+    return get_state() == WIFI_SCANNER_RUNNING ? ESP_OK : ESP_ERR_INVALID_STATE;
 }
 
 esp_err_t wifi_scanner_stop(void)
 {
+    /* Free the view's LVGL objects; there is nothing left to show */
+    ui_lock();
+    if (wifi_list_ui_get_container() || wifi_track_ui_get_container()) {
+        ui_show_home();
+    }
+    wifi_list_ui_set_visibility_callback(NULL);
+    wifi_list_ui_set_select_callback(NULL);
+    wifi_track_ui_set_visibility_callback(NULL);
+    wifi_track_end();
+    ui_unlock();
+    s_view_visible = false;
+
     if (s_scan_task_handle != NULL) {
-        vTaskDelete(s_scan_task_handle);
+        /* Let the task leave on its own, never while it holds the scan
+         * mutex or the driver is mid-sweep */
+        __atomic_store_n(&s_state, WIFI_SCANNER_STOPPED, __ATOMIC_RELEASE);
+        xTaskNotifyGive(s_scan_task_handle);
+        esp_wifi_scan_stop();
+        xSemaphoreTake(s_task_exited, portMAX_DELAY);
         s_scan_task_handle = NULL;
         ESP_LOGI(TAG, "WiFi scan task stopped");
     }
+
+    if (!s_wifi_initialized) {
+        return ESP_OK;
+    }
+
+    /* NVS, netif and the event loop stay; they are shared and cheap */
+    xSemaphoreTake(s_scan_mutex, portMAX_DELAY);
+    s_wifi_initialized = false;
+    esp_err_t ret = esp_wifi_stop();
+    if (ret == ESP_OK) {
+        ret = esp_wifi_deinit();
+    }
+    xSemaphoreGive(s_scan_mutex);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to release WiFi: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    esp_netif_destroy_default_wifi(s_sta_netif);
+    s_sta_netif = NULL;
+    ESP_LOGI(TAG, "WiFi released");
     return ESP_OK;
 }
 
+wifi_scanner_state_t wifi_scanner_get_state(void)
+{
+    return get_state();
+}
+
+const char *wifi_scanner_state_name(wifi_scanner_state_t state)
+{
+    return (state <= WIFI_SCANNER_PAUSED) ? s_state_names[state] : "?";
+}
+
+esp_err_t wifi_scanner_scan_once(uint16_t *ap_count, uint32_t *elapsed_us)
+{
+    if (!s_scan_mutex) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return scan_sweep(NULL, ap_count, elapsed_us);
+}
+
 lv_obj_t *wifi_scanner_get_list_container(void)
 {
-    return s_list_container;
+    return wifi_list_ui_get_container();
 }
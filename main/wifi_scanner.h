@@ -1,36 +1,118 @@
 #pragma once
 
 #include "esp_err.h"
+#include "esp_wifi_types.h"
 #include "lvgl.h"
+#include "rssi_filter.h"
+
+/* Rows in the list view and results kept per sweep; the host UI bench can
+ * raise it to try longer lists */
+#ifndef MAX_AP_COUNT
+#define MAX_AP_COUNT 20
+#endif
+
+/* WiFi scan result structure */
+typedef struct {
+    char ssid[33];
+    uint8_t bssid[6];
+    uint8_t channel;        /* Primary channel */
+    int8_t rssi;            /* Raw RSSI from the last sweep */
+    int16_t rssi_q4;        /* Smoothed RSSI (see rssi_filter.h) */
+    rssi_trend_t trend;
+    uint8_t prev_rank;      /* Row from the previous sweep, 0xFF if new */
+    uint8_t alerts;         /* ROGUE_ALERT_BIT()s standing for this BSSID (rogue_detect.h) */
+    wifi_auth_mode_t authmode;
+} wifi_ap_info_t;
+
+/* Scanner lifecycle. Paused keeps the task, the WiFi driver and every
+ * cache (RSSI filter, published snapshot) but does no sweeps; stopped has
+ * released all of them. */
+typedef enum {
+    WIFI_SCANNER_STOPPED = 0,
+    WIFI_SCANNER_RUNNING,
+    WIFI_SCANNER_PAUSED,
+} wifi_scanner_state_t;
 
 /**
  * @brief Initialize WiFi in station mode for scanning
  * 
+ * Does nothing if WiFi is already initialized.
+ * 
  * @return ESP_OK on success, error code otherwise
  */
 esp_err_t wifi_scanner_init(void);
 
 /**
- * @brief Start WiFi scanning task
+ * @brief Show the WiFi scanner view and start the scanning task
  * 
- * Creates a task that scans for WiFi networks every 2 seconds
- * and updates the UI with the results
+ * Loads the scanner as its own screen and creates a task that scans
+ * for WiFi networks every scan_interval (see tuning.h) and updates the UI with the results.
+ * With WIFI_SCAN_PAUSE_HIDDEN the scanner pauses whenever another view
+ * replaces the list and resumes when the list is shown again.
  * 
- * @param parent_screen Parent LVGL screen to create UI on
  * @return ESP_OK on success, error code otherwise
  */
-esp_err_t wifi_scanner_start(lv_obj_t *parent_screen);
+esp_err_t wifi_scanner_start(void);
 
 /**
- * @brief Stop WiFi scanning task
+ * @brief Stop sweeping but keep the task, driver and results
+ * 
+ * A sweep in progress finishes first. Cheap; resume with wifi_scanner_resume().
+ * 
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if the scanner is stopped
+ */
+esp_err_t wifi_scanner_pause(void);
+
+/**
+ * @brief Continue sweeping after wifi_scanner_pause()
+ * 
+ * Sweeps right away if the scan interval has passed while paused.
+ * 
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if the scanner is stopped
+ */
+esp_err_t wifi_scanner_resume(void);
+
+/**
+ * @brief Stop scanning and release the task, the scanner view and WiFi
+ * 
+ * Aborts a sweep in progress and waits for the task to exit, so it must
+ * not be called from the scan task or with the UI lock held. Call
+ * wifi_scanner_init() again before the next start.
  * 
  * @return ESP_OK on success, error code otherwise
  */
 esp_err_t wifi_scanner_stop(void);
 
+/**
+ * @brief Get the lifecycle state
+ * 
+ * @return Current state
+ */
+wifi_scanner_state_t wifi_scanner_get_state(void);
+
+/**
+ * @brief Get a lifecycle state's display name
+ * 
+ * @param state State
+ * @return Name
+ */
+const char *wifi_scanner_state_name(wifi_scanner_state_t state);
+
+/**
+ * @brief Run one blocking sweep and discard the results
+ * 
+ * Uses the current scan tuning and waits for any sweep of the scan task to
+ * finish first. Meant for benchmarking.
+ * 
+ * @param[out] ap_count Number of networks found
+ * @param[out] elapsed_us Optional, receives the sweep duration
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t wifi_scanner_scan_once(uint16_t *ap_count, uint32_t *elapsed_us);
+
 /**
  * @brief Get the LVGL container object for the WiFi list
  * 
- * @return Pointer to the WiFi list container or NULL if not initialized
+ * @return Pointer to the WiFi list container or NULL if the view is not shown
  */
 lv_obj_t *wifi_scanner_get_list_container(void);
@@ -0,0 +1,147 @@
+#include "wifi_track.h"
+
+#include <string.h>
+
+#define TARGET_READ_TRIES 4  /* Give up rather than spin on a preempted writer */
+
+/* Written in LVGL context only */
+static wifi_track_target_t s_target;
+static uint32_t s_gen;       /* 0 while not tracking */
+static uint32_t s_last_gen;
+static uint32_t s_seq;       /* Odd while s_target and s_gen are written */
+
+/* Written by the scan task only */
+static wifi_track_sample_t s_ring[WIFI_TRACK_RING_SIZE];
+static uint32_t s_head;      /* Samples ever pushed */
+
+static void write_begin(void)
+{
+    __atomic_store_n(&s_seq, s_seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static void write_end(void)
+{
+    __atomic_store_n(&s_seq, s_seq + 1, __ATOMIC_RELEASE);
+}
+
+uint32_t wifi_track_begin(const wifi_ap_info_t *ap)
+{
+    uint32_t gen = ++s_last_gen;
+    if (gen == 0) {
+        gen = ++s_last_gen;
+    }
+
+    write_begin();
+    memcpy(s_target.bssid, ap->bssid, sizeof(s_target.bssid));
+    s_target.channel = ap->channel;
+    memcpy(s_target.ssid, ap->ssid, sizeof(s_target.ssid));
+    s_target.ssid[sizeof(s_target.ssid) - 1] = '\0';
+    __atomic_store_n(&s_gen, gen, __ATOMIC_RELAXED);
+    write_end();
+    return gen;
+}
+
+void wifi_track_end(void)
+{
+    write_begin();
+    __atomic_store_n(&s_gen, 0, __ATOMIC_RELAXED);
+    write_end();
+}
+
+uint32_t wifi_track_get_target(wifi_track_target_t *out)
+{
+    /* Only fails while the target is being changed; the scanner is woken
+     * once the change is complete */
+    for (int i = 0; i < TARGET_READ_TRIES; i++) {
+        uint32_t seq = __atomic_load_n(&s_seq, __ATOMIC_ACQUIRE);
+        if (seq & 1) {
+            continue;
+        }
+        uint32_t gen = __atomic_load_n(&s_gen, __ATOMIC_RELAXED);
+        memcpy(out, &s_target, sizeof(*out));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&s_seq, __ATOMIC_RELAXED) == seq) {
+            return gen;
+        }
+    }
+    return 0;
+}
+
+void wifi_track_push(uint32_t gen, bool heard, int8_t rssi, int64_t time_us)
+{
+    uint32_t head = __atomic_load_n(&s_head, __ATOMIC_RELAXED);
+    wifi_track_sample_t *sample = &s_ring[head & (WIFI_TRACK_RING_SIZE - 1)];
+    sample->time_us = time_us;
+    sample->gen = gen;
+    sample->rssi = heard ? rssi : 0;
+    sample->heard = heard;
+    __atomic_store_n(&s_head, head + 1, __ATOMIC_RELEASE);
+}
+
+uint32_t wifi_track_head(void)
+{
+    return __atomic_load_n(&s_head, __ATOMIC_ACQUIRE);
+}
+
+uint32_t wifi_track_read(uint32_t gen, uint32_t *cursor, wifi_track_sample_t *out, uint32_t max)
+{
+    uint32_t head = __atomic_load_n(&s_head, __ATOMIC_ACQUIRE);
+
+    /* Keep half the ring between the oldest slot read and the writer, so
+     * nothing is overwritten while it is copied */
+    if (head - *cursor > WIFI_TRACK_RING_SIZE / 2) {
+        *cursor = head - WIFI_TRACK_RING_SIZE / 2;
+    }
+
+    uint32_t count = 0;
+    while (*cursor != head && count < max) {
+        const wifi_track_sample_t *sample = &s_ring[*cursor & (WIFI_TRACK_RING_SIZE - 1)];
+        if (sample->gen == gen) {
+            out[count++] = *sample;
+        }
+        (*cursor)++;
+    }
+    return count;
+}
+
+void wifi_track_get_stats(uint32_t gen, wifi_track_stats_t *out)
+{
+    memset(out, 0, sizeof(*out));
+
+    uint32_t head = __atomic_load_n(&s_head, __ATOMIC_ACQUIRE);
+    uint32_t window = head < WIFI_TRACK_STATS_SAMPLES ? head : WIFI_TRACK_STATS_SAMPLES;
+    int64_t newest_us = 0;
+    int64_t oldest_us = 0;
+    uint32_t heard = 0;
+
+    for (uint32_t i = 1; i <= window; i++) {
+        const wifi_track_sample_t *sample = &s_ring[(head - i) & (WIFI_TRACK_RING_SIZE - 1)];
+        if (sample->gen != gen) {
+            break;
+        }
+        if (out->samples == 0) {
+            newest_us = sample->time_us;
+        }
+        oldest_us = sample->time_us;
+        out->samples++;
+
+        if (!sample->heard) {
+            continue;
+        }
+        if (heard == 0 || sample->rssi < out->min_rssi) {
+            out->min_rssi = sample->rssi;
+        }
+        if (heard == 0 || sample->rssi > out->max_rssi) {
+            out->max_rssi = sample->rssi;
+        }
+        heard++;
+    }
+
+    if (out->samples > 0) {
+        out->heard_pct = (uint8_t)(heard * 100 / out->samples);
+    }
+    if (out->samples > 1 && newest_us > oldest_us) {
+        out->rate_hz = (float)(out->samples - 1) * 1e6f / (float)(newest_us - oldest_us);
+    }
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "wifi_scanner.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Single-BSSID tracking: the target picked in the list view and the RSSI
+ * samples the scan task takes of it.
+ *
+ * The target is set and cleared in LVGL context and read by the scan task
+ * under a sequence lock. Every wifi_track_begin() starts a new generation;
+ * samples carry the generation they were taken for, so a reader never mixes
+ * readings of two targets. Samples go into a ring written only by the scan
+ * task and read without locks; a reader that falls a whole ring behind skips
+ * ahead. No WiFi driver calls, so it builds on the host too.
+ */
+
+#define WIFI_TRACK_RING_SIZE 64     /* Samples kept, a power of two */
+#define WIFI_TRACK_STATS_SAMPLES 16 /* Newest samples the rate is measured over */
+
+typedef struct {
+    uint8_t bssid[6];
+    uint8_t channel;
+    char ssid[33];
+} wifi_track_target_t;
+
+typedef struct {
+    int64_t time_us;  /* esp_timer time the scan finished */
+    uint32_t gen;     /* Generation of the target it was taken for */
+    int8_t rssi;      /* dBm, valid if heard */
+    bool heard;       /* false if the target did not answer that scan */
+} wifi_track_sample_t;
+
+typedef struct {
+    float rate_hz;      /* Samples per second */
+    uint8_t heard_pct;  /* Share of scans that heard the target */
+    int8_t min_rssi;    /* Over the heard samples; 0 if none */
+    int8_t max_rssi;
+    uint32_t samples;   /* Samples the figures are based on */
+} wifi_track_stats_t;
+
+/**
+ * @brief Start tracking an AP (LVGL context)
+ *
+ * @param ap AP to track, e.g. a row of the latest snapshot
+ * @return Generation of the new target
+ */
+uint32_t wifi_track_begin(const wifi_ap_info_t *ap);
+
+/**
+ * @brief Stop tracking (LVGL context)
+ */
+void wifi_track_end(void);
+
+/**
+ * @brief Get the current target
+ *
+ * @param[out] out Target, valid if the result is not 0
+ * @return Generation of the target, 0 if not tracking
+ */
+uint32_t wifi_track_get_target(wifi_track_target_t *out);
+
+/**
+ * @brief Add a sample (scan task only)
+ *
+ * @param gen Generation returned by wifi_track_get_target() for the scan
+ * @param heard Whether the target answered
+ * @param rssi RSSI in dBm if heard
+ * @param time_us esp_timer time of the sample
+ */
+void wifi_track_push(uint32_t gen, bool heard, int8_t rssi, int64_t time_us);
+
+/**
+ * @brief Position of the next sample to be pushed, a start for wifi_track_read()
+ *
+ * @return Ring position
+ */
+uint32_t wifi_track_head(void);
+
+/**
+ * @brief Read samples of one generation pushed since the last call
+ *
+ * @param gen Generation to read
+ * @param[in,out] cursor Ring position, advanced past what was read or skipped
+ * @param[out] out Samples, oldest first
+ * @param max Capacity of out
+ * @return Number of samples stored in out
+ */
+uint32_t wifi_track_read(uint32_t gen, uint32_t *cursor, wifi_track_sample_t *out, uint32_t max);
+
+/**
+ * @brief Measure the newest samples of one generation
+ *
+ * @param gen Generation
+ * @param[out] out Sample rate, hit rate and RSSI range
+ */
+void wifi_track_get_stats(uint32_t gen, wifi_track_stats_t *out);
@@ -0,0 +1,211 @@
+#include "wifi_track_ui.h"
+#include "wifi_list_ui.h"
+#include "wifi_track.h"
+
+#include <stdio.h>
+
+#define TRACK_POLL_PERIOD_MS 100  /* How often the view picks up new samples */
+#define TRACK_CHART_POINTS 60     /* History shown, in samples */
+#define TRACK_RSSI_MIN -100       /* Gauge and chart range, dBm */
+#define TRACK_RSSI_MAX -20
+#define TRACK_GAUGE_SIZE 110
+
+/* LVGL side of tracking; like the list view it makes no WiFi driver calls */
+
+static lv_obj_t *s_screen = NULL;
+static lv_obj_t *s_gauge = NULL;
+static lv_obj_t *s_value_label = NULL;
+static lv_obj_t *s_stats_label = NULL;
+static lv_obj_t *s_chart = NULL;
+static lv_chart_series_t *s_series = NULL;
+static lv_timer_t *s_poll_timer = NULL;
+static uint32_t s_gen = 0;
+static uint32_t s_cursor = 0;
+static wifi_track_ui_visibility_callback_t s_visibility_cb = NULL;
+
+static void create_wifi_track_ui(lv_obj_t *screen);
+static void destroy_wifi_track_ui(void);
+static void poll_samples_cb(lv_timer_t *timer);
+
+const ui_view_t wifi_track_ui_view = {
+    .name = "wifi_track",
+    .create = create_wifi_track_ui,
+    .destroy = destroy_wifi_track_ui,
+};
+
+static void back_button_event_cb(lv_event_t *e)
+{
+    if (lv_event_get_code(e) == LV_EVENT_CLICKED) {
+        /* Back to the full sweep; showing the list ends tracking */
+        ui_show_view(&wifi_list_ui_view);
+    }
+}
+
+static void create_wifi_track_ui(lv_obj_t *screen)
+{
+    s_screen = screen;
+    lv_obj_set_style_bg_color(screen, lv_color_make(20, 20, 40), 0);
+    lv_obj_set_style_pad_all(screen, 10, 0);
+    lv_obj_set_flex_flow(screen, LV_FLEX_FLOW_COLUMN);
+    lv_obj_set_style_pad_row(screen, 6, 0);
+    lv_obj_set_scrollbar_mode(screen, LV_SCROLLBAR_MODE_OFF);
+
+    wifi_track_target_t target;
+    s_gen = wifi_track_get_target(&target);
+
+    lv_obj_t *header = lv_obj_create(screen);
+    lv_obj_set_size(header, LV_PCT(100), LV_SIZE_CONTENT);
+    lv_obj_set_style_bg_opa(header, LV_OPA_TRANSP, 0);
+    lv_obj_set_style_border_width(header, 0, 0);
+    lv_obj_set_style_pad_all(header, 0, 0);
+    lv_obj_set_style_pad_column(header, 10, 0);
+    lv_obj_set_flex_flow(header, LV_FLEX_FLOW_ROW);
+    lv_obj_set_flex_align(header, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+
+    lv_obj_t *back_button = lv_button_create(header);
+    lv_obj_set_size(back_button, 60, 30);
+    lv_obj_set_style_bg_color(back_button, lv_color_make(200, 0, 0), LV_PART_MAIN);
+    lv_obj_add_event_cb(back_button, back_button_event_cb, LV_EVENT_CLICKED, NULL);
+
+    lv_obj_t *back_label = lv_label_create(back_button);
+    lv_label_set_text(back_label, "Back");
+    lv_obj_center(back_label);
+    lv_obj_set_style_text_color(back_label, lv_color_white(), 0);
+
+    lv_obj_t *title = lv_label_create(header);
+    lv_obj_set_flex_grow(title, 1);
+    lv_label_set_long_mode(title, LV_LABEL_LONG_DOT);
+    lv_obj_set_style_text_color(title, lv_color_white(), 0);
+    if (s_gen) {
+        lv_label_set_text_fmt(title, "%s\n%02x:%02x:%02x:%02x:%02x:%02x ch%u",
+                              target.ssid[0] ? target.ssid : "(hidden)",
+                              target.bssid[0], target.bssid[1], target.bssid[2],
+                              target.bssid[3], target.bssid[4], target.bssid[5], target.channel);
+    } else {
+        lv_label_set_text(title, "No network selected");
+    }
+
+    /* Gauge with the latest reading next to the rate figures */
+    lv_obj_t *row = lv_obj_create(screen);
+    lv_obj_set_size(row, LV_PCT(100), LV_SIZE_CONTENT);
+    lv_obj_set_style_bg_opa(row, LV_OPA_TRANSP, 0);
+    lv_obj_set_style_border_width(row, 0, 0);
+    lv_obj_set_style_pad_all(row, 0, 0);
+    lv_obj_set_style_pad_column(row, 12, 0);
+    lv_obj_set_flex_flow(row, LV_FLEX_FLOW_ROW);
+    lv_obj_set_flex_align(row, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+
+    s_gauge = lv_arc_create(row);
+    lv_obj_set_size(s_gauge, TRACK_GAUGE_SIZE, TRACK_GAUGE_SIZE);
+    lv_arc_set_range(s_gauge, TRACK_RSSI_MIN, TRACK_RSSI_MAX);
+    lv_arc_set_value(s_gauge, TRACK_RSSI_MIN);
+    lv_obj_remove_style(s_gauge, NULL, LV_PART_KNOB);
+    lv_obj_remove_flag(s_gauge, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_set_style_arc_width(s_gauge, 12, LV_PART_MAIN);
+    lv_obj_set_style_arc_width(s_gauge, 12, LV_PART_INDICATOR);
+    lv_obj_set_style_arc_color(s_gauge, lv_color_make(60, 60, 90), LV_PART_MAIN);
+    lv_obj_set_style_arc_color(s_gauge, lv_color_make(0, 200, 120), LV_PART_INDICATOR);
+
+    s_value_label = lv_label_create(s_gauge);
+    lv_label_set_text(s_value_label, "--");
+    lv_obj_set_style_text_color(s_value_label, lv_color_white(), 0);
+    lv_obj_set_style_text_font(s_value_label, &lv_font_montserrat_32, 0);
+    lv_obj_center(s_value_label);
+
+    s_stats_label = lv_label_create(row);
+    lv_obj_set_flex_grow(s_stats_label, 1);
+    lv_obj_set_style_text_color(s_stats_label, lv_color_make(150, 200, 255), 0);
+    lv_label_set_text(s_stats_label, "Waiting for samples");
+
+    s_chart = lv_chart_create(screen);
+    lv_obj_set_width(s_chart, LV_PCT(100));
+    lv_obj_set_flex_grow(s_chart, 1);
+    lv_chart_set_type(s_chart, LV_CHART_TYPE_LINE);
+    lv_chart_set_update_mode(s_chart, LV_CHART_UPDATE_MODE_SHIFT);
+    lv_chart_set_point_count(s_chart, TRACK_CHART_POINTS);
+    lv_chart_set_axis_range(s_chart, LV_CHART_AXIS_PRIMARY_Y, TRACK_RSSI_MIN, TRACK_RSSI_MAX);
+    lv_chart_set_div_line_count(s_chart, 5, 0);
+    lv_obj_set_style_bg_color(s_chart, lv_color_make(10, 10, 25), 0);
+    lv_obj_set_style_border_color(s_chart, lv_color_make(100, 100, 150), 0);
+    lv_obj_set_style_line_color(s_chart, lv_color_make(50, 50, 80), LV_PART_MAIN);
+    lv_obj_set_style_width(s_chart, 0, LV_PART_INDICATOR);
+    lv_obj_set_style_height(s_chart, 0, LV_PART_INDICATOR);
+    s_series = lv_chart_add_series(s_chart, lv_color_make(0, 200, 120), LV_CHART_AXIS_PRIMARY_Y);
+    lv_chart_set_all_values(s_chart, s_series, LV_CHART_POINT_NONE);
+
+    /* Only samples taken from now on */
+    s_cursor = wifi_track_head();
+    s_poll_timer = lv_timer_create(poll_samples_cb, TRACK_POLL_PERIOD_MS, NULL);
+
+    if (s_visibility_cb) {
+        s_visibility_cb(true);
+    }
+}
+
+/* Called by ui_show_view() before the screen and its children are deleted */
+static void destroy_wifi_track_ui(void)
+{
+    if (s_visibility_cb) {
+        s_visibility_cb(false);
+    }
+    if (s_poll_timer) {
+        lv_timer_delete(s_poll_timer);
+        s_poll_timer = NULL;
+    }
+    s_screen = NULL;
+    s_gauge = NULL;
+    s_value_label = NULL;
+    s_stats_label = NULL;
+    s_chart = NULL;
+    s_series = NULL;
+}
+
+/* Runs in LVGL context: append new samples and refresh the figures */
+static void poll_samples_cb(lv_timer_t *timer)
+{
+    (void)timer;
+    if (!s_screen || !s_gen) {
+        return;
+    }
+
+    wifi_track_sample_t samples[WIFI_TRACK_RING_SIZE / 2];
+    uint32_t count = wifi_track_read(s_gen, &s_cursor, samples, WIFI_TRACK_RING_SIZE / 2);
+    if (count == 0) {
+        return;
+    }
+
+    const wifi_track_sample_t *last_heard = NULL;
+    for (uint32_t i = 0; i < count; i++) {
+        lv_chart_set_next_value(s_chart, s_series, samples[i].heard ? samples[i].rssi : LV_CHART_POINT_NONE);
+        if (samples[i].heard) {
+            last_heard = &samples[i];
+        }
+    }
+    if (last_heard) {
+        lv_arc_set_value(s_gauge, last_heard->rssi);
+        lv_label_set_text_fmt(s_value_label, "%d", last_heard->rssi);
+    } else {
+        lv_label_set_text(s_value_label, "--");
+    }
+
+    wifi_track_stats_t stats;
+    wifi_track_get_stats(s_gen, &stats);
+    char buf[96];
+    if (stats.heard_pct > 0) {
+        snprintf(buf, sizeof(buf), "%.1f samples/s\nheard %u%%\n%d..%d dBm",
+                 stats.rate_hz, stats.heard_pct, stats.min_rssi, stats.max_rssi);
+    } else {
+        snprintf(buf, sizeof(buf), "%.1f samples/s\nnot heard", stats.rate_hz);
+    }
+    lv_label_set_text(s_stats_label, buf);
+}
+
+void wifi_track_ui_set_visibility_callback(wifi_track_ui_visibility_callback_t callback)
+{
+    s_visibility_cb = callback;
+}
+
+lv_obj_t *wifi_track_ui_get_container(void)
+{
+    return s_screen;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "ui.h"
+#include <stdbool.h>
+
+/* Tracking view for the AP picked in the list: live RSSI gauge, a short
+ * history chart and the achieved sample rate, read from wifi_track.h.
+ * Shown with ui_show_view(&wifi_track_ui_view) after wifi_track_begin(). */
+extern const ui_view_t wifi_track_ui_view;
+
+/* Told when the view is built (true) and torn down (false) */
+typedef void (*wifi_track_ui_visibility_callback_t)(bool visible);
+
+/**
+ * @brief Set the callback run when the view is shown or hidden
+ *
+ * @param callback Callback, NULL for none
+ */
+void wifi_track_ui_set_visibility_callback(wifi_track_ui_visibility_callback_t callback);
+
+/**
+ * @brief Get the view's screen
+ *
+ * @return Screen, or NULL if the view is not shown
+ */
+lv_obj_t *wifi_track_ui_get_container(void);
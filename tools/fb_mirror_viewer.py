@@ -0,0 +1,126 @@
+#!/usr/bin/env python3
+"""Host viewer for the CYD framebuffer mirror (see main/fb_mirror.h).
+
+Reads tile packets from a serial port, rebuilds the frame and either
+shows it live (pygame) or writes it to a PPM file after every update burst.
+
+    python3 tools/fb_mirror_viewer.py /dev/ttyUSB1
+    python3 tools/fb_mirror_viewer.py /dev/ttyUSB1 --ppm frame.ppm
+    python3 tools/fb_mirror_viewer.py /dev/ttyUSB1 --size 480   # 3.5" boards
+"""
+
+import argparse
+import struct
+import sys
+import time
+
+import serial  # pyserial
+
+# Square canvas of the panel's longer side (FB_MIRROR_MAX_RES), so every
+# rotation fits: 320 on the 2.8" board, 480 on the 3.5" ones
+DEFAULT_SIZE = 320
+HDR = struct.Struct("<2sBHHBBH")
+ENC_RAW = 0
+ENC_RLE = 1
+
+
+def rgb565_to_rgb(px):
+    r = (px >> 11) & 0x1F
+    g = (px >> 5) & 0x3F
+    b = px & 0x1F
+    return (r << 3 | r >> 2, g << 2 | g >> 4, b << 3 | b >> 2)
+
+
+def decode(enc, w, h, payload):
+    if enc == ENC_RAW:
+        return list(struct.unpack("<%dH" % (w * h), payload))
+    pixels = []
+    for i in range(0, len(payload), 3):
+        count, px = payload[i] + 1, payload[i + 1] | payload[i + 2] << 8
+        pixels.extend([px] * count)
+    return pixels[: w * h]
+
+
+def read_packets(port, size):
+    buf = bytearray()
+    while True:
+        buf += port.read(4096)
+        while True:
+            start = buf.find(b"FM")
+            if start < 0:
+                del buf[:-1]
+                break
+            if len(buf) - start < HDR.size:
+                del buf[:start]
+                break
+            _, enc, x, y, w, h, length = HDR.unpack_from(buf, start)
+            end = start + HDR.size + length
+            if enc not in (ENC_RAW, ENC_RLE) or x + w > size or y + h > size:
+                del buf[: start + 2]  # false sync, skip the magic
+                continue
+            if len(buf) < end:
+                del buf[:start]
+                break
+            yield x, y, w, h, decode(enc, w, h, bytes(buf[start + HDR.size : end])), end - start
+            del buf[:end]
+
+
+def write_ppm(path, frame, size):
+    with open(path, "wb") as f:
+        f.write(b"P6 %d %d 255\n" % (size, size))
+        f.write(bytes(c for px in frame for c in rgb565_to_rgb(px)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("port")
+    parser.add_argument("--baud", type=int, default=2000000)
+    parser.add_argument("--ppm", help="write frames to this PPM file instead of a window")
+    parser.add_argument("--size", type=int, default=DEFAULT_SIZE,
+                        help="canvas side, the board's longer panel side (default %(default)s)")
+    args = parser.parse_args()
+    size = args.size
+
+    port = serial.Serial(args.port, args.baud, timeout=0.05)
+    frame = [0] * (size * size)
+
+    screen = None
+    if not args.ppm:
+        import pygame
+
+        pygame.init()
+        screen = pygame.display.set_mode((size, size))
+        pygame.display.set_caption("CYD mirror")
+
+    rx_bytes = 0
+    px_bytes = 0
+    last_report = time.monotonic()
+    for x, y, w, h, pixels, size in read_packets(port, size):
+        for row in range(h):
+            base = (y + row) * size + x
+            frame[base : base + w] = pixels[row * w : (row + 1) * w]
+            if screen:
+                for col in range(w):
+                    screen.set_at((x + col, y + row), rgb565_to_rgb(pixels[row * w + col]))
+        rx_bytes += size
+        px_bytes += w * h * 2
+
+        if port.in_waiting == 0:
+            if screen:
+                pygame.display.flip()
+                if any(e.type == pygame.QUIT for e in pygame.event.get()):
+                    return 0
+            else:
+                write_ppm(args.ppm, frame, size)
+
+        now = time.monotonic()
+        if now - last_report >= 5:
+            ratio = px_bytes / rx_bytes if rx_bytes else 0
+            print("rx %d B/s, tile compression %.2f:1" % (rx_bytes / (now - last_report), ratio))
+            rx_bytes = px_bytes = 0
+            last_report = now
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,92 @@
+#!/usr/bin/env python3
+"""Reader for CYD scan log files (see main/scan_log_format.h).
+
+Memory-maps each file and walks it block by block, verifying record CRCs.
+Prints one CSV line per AP sighting, or a summary with --summary.
+
+    python3 tools/scan_log_reader.py /media/sd/SCAN0001.BIN
+    python3 tools/scan_log_reader.py --summary /media/sd/SCAN*.BIN
+"""
+
+import argparse
+import mmap
+import struct
+import sys
+import zlib
+
+BLOCK_SIZE = 4096
+HDR = struct.Struct("<HBBII")
+CRC = struct.Struct("<I")
+TYPE_FILE_HEADER = 0
+TYPE_SWEEP = 1
+
+
+def records(buf):
+    """Yield (type, count, seq, time_ms, payload) until the first bad record."""
+    block_size = BLOCK_SIZE
+    block = 0
+    while block < len(buf):
+        off = block
+        end = min(block + block_size, len(buf))
+        while off + HDR.size <= end:
+            length, rtype, count, seq, time_ms = HDR.unpack_from(buf, off)
+            if length == 0:
+                break  # padding to the end of the block
+            if length < HDR.size + CRC.size or off + length > end:
+                return
+            (crc,) = CRC.unpack_from(buf, off + length - CRC.size)
+            if zlib.crc32(buf[off : off + length - CRC.size]) != crc:
+                return  # torn write: everything before is intact
+            payload = buf[off + HDR.size : off + length - CRC.size]
+            if rtype == TYPE_FILE_HEADER and len(payload) >= 10 and payload[:7] == b"CYDSLOG":
+                block_size = struct.unpack_from("<H", payload, 8)[0]
+                if block_size < HDR.size + CRC.size:
+                    return  # no record fits; as the C reader, stop here
+            yield rtype, count, seq, time_ms, payload
+            off += length
+        block += block_size
+
+
+def sightings(payload, count):
+    off = 0
+    for _ in range(count):
+        bssid = payload[off : off + 6]
+        rssi, channel, authmode, ssid_len = struct.unpack_from("<bBBB", payload, off + 6)
+        ssid = payload[off + 10 : off + 10 + ssid_len].decode("utf-8", "replace")
+        off += 10 + ssid_len
+        yield ":".join("%02x" % b for b in bssid), rssi, channel, authmode, ssid
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("files", nargs="+")
+    parser.add_argument("--summary", action="store_true", help="print per-file totals only")
+    args = parser.parse_args()
+
+    if not args.summary:
+        print("file,seq,time_ms,bssid,rssi,channel,authmode,ssid")
+    for path in args.files:
+        with open(path, "rb") as f:
+            if f.seek(0, 2) == 0:
+                continue
+            with mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ) as buf:
+                sweeps = aps = 0
+                bssids = set()
+                for rtype, count, seq, time_ms, payload in records(buf):
+                    if rtype != TYPE_SWEEP:
+                        continue
+                    sweeps += 1
+                    for bssid, rssi, channel, authmode, ssid in sightings(payload, count):
+                        aps += 1
+                        bssids.add(bssid)
+                        if not args.summary:
+                            print('%s,%d,%d,%s,%d,%d,%d,"%s"'
+                                  % (path, seq, time_ms, bssid, rssi, channel, authmode,
+                                     ssid.replace('"', '""')))
+                if args.summary:
+                    print("%s: %d sweeps, %d sightings, %d BSSIDs" % (path, sweeps, aps, len(bssids)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())